@@ -25,6 +25,11 @@
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
+// clock_gettime
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "rdf_storage_sqlite_mro.h"
 
 #define NAMESPACE "http://purl.mro.name/librdf.sqlite/"
@@ -33,6 +38,26 @@ const char *LIBRDF_STORAGE_SQLITE_MRO = NAMESPACE;
 const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK = (unsigned char *)NAMESPACE "feature/sql/cache/mask";
 const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE = (unsigned char *)NAMESPACE "feature/sqlite3/profile";
 const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN = (unsigned char *)NAMESPACE "feature/sqlite3/explain_query_plan";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING = (unsigned char *)NAMESPACE "feature/tuning";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_PAGE_SIZE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/page_size";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_LOCKING_MODE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/locking_mode";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_JOURNAL_MODE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/journal_mode";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/cache_size";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_MMAP_SIZE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/mmap_size";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_TEMP_STORE = (unsigned char *)NAMESPACE "feature/sqlite3/pragma/temp_store";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS = (unsigned char *)NAMESPACE "feature/metrics";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_DUMP = (unsigned char *)NAMESPACE "feature/metrics/dump";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_RESET = (unsigned char *)NAMESPACE "feature/metrics/reset";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED = (unsigned char *)NAMESPACE "feature/count/inserted";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED = (unsigned char *)NAMESPACE "feature/count/ignored";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_QUERY_PLANS = (unsigned char *)NAMESPACE "feature/sqlite3/explain_query_plan/report";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD = (unsigned char *)NAMESPACE "feature/slow/threshold_us";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE = (unsigned char *)NAMESPACE "feature/slow/rate";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_MEMORY_STATS = (unsigned char *)NAMESPACE "feature/sqlite3/status";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES = (unsigned char *)NAMESPACE "feature/schema/uri_prefixes";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COMPACT_LITERALS = (unsigned char *)NAMESPACE "feature/schema/compact_literals";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_READ_ONLY = (unsigned char *)NAMESPACE "feature/read_only";
+const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE = (unsigned char *)NAMESPACE "feature/analyze";
 
 #define LIBRDF_NAMESPACE_XSD "http://www.w3.org/2000/10/XMLSchema#"
 
@@ -44,8 +69,14 @@ const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLA
 #include <rdf_storage.h>
 #include <sqlite3.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #if DEBUG
 #undef NDEBUG
@@ -69,6 +100,9 @@ static inline bool isNULL_ID(const hash_t x)
 #define RET_ERROR 1
 #define RET_OK 0
 
+/** PRAGMA user_version after all migrations in pub_open. */
+#define SCHEMA_VERSION 4
+
 /** C-String type for URIs. */
 typedef unsigned char *str_uri_t;
 /** C-String type for blank identifiers. */
@@ -90,6 +124,89 @@ static const char *const synchronous_flags[4] = {
     "off", "normal", "full", NULL
 };
 
+/** index into tuning_pragmas and tuning_profile_t.values, in the order they get applied. */
+typedef enum {
+    PRAGMA_PAGE_SIZE = 0,   // effective for new stores only, must precede the schema
+    PRAGMA_LOCKING_MODE,    // before journal_mode, WAL behaves differently in exclusive mode
+    PRAGMA_JOURNAL_MODE,
+    PRAGMA_CACHE_SIZE,
+    PRAGMA_MMAP_SIZE,
+    PRAGMA_TEMP_STORE,
+    PRAGMA_COUNT
+} tuning_pragma_t;
+
+typedef struct
+{
+    const char *name; // PRAGMA name and storage option name
+    const unsigned char **feature;
+    const char *const *keywords; // NULL for integer values
+}
+tuning_pragma_desc_t;
+
+static const char *const temp_store_keywords[] = {
+    "default", "file", "memory", NULL
+};
+static const char *const journal_mode_keywords[] = {
+    "delete", "truncate", "persist", "memory", "wal", "off", NULL
+};
+static const char *const locking_mode_keywords[] = {
+    "normal", "exclusive", NULL
+};
+
+static const tuning_pragma_desc_t tuning_pragmas[PRAGMA_COUNT] = {
+    [PRAGMA_PAGE_SIZE]    = { "page_size", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_PAGE_SIZE, NULL },
+    [PRAGMA_LOCKING_MODE] = { "locking_mode", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_LOCKING_MODE, locking_mode_keywords },
+    [PRAGMA_JOURNAL_MODE] = { "journal_mode", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_JOURNAL_MODE, journal_mode_keywords },
+    [PRAGMA_CACHE_SIZE]   = { "cache_size", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE, NULL },
+    [PRAGMA_MMAP_SIZE]    = { "mmap_size", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_MMAP_SIZE, NULL },
+    [PRAGMA_TEMP_STORE]   = { "temp_store", &LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_TEMP_STORE, temp_store_keywords },
+};
+
+/** Named set of PRAGMA values. Every profile sets all values but page_size, so switching
+ * profiles at runtime doesn't leave settings of the previous one behind.
+ */
+typedef struct
+{
+    const char *name;
+    const char *values[PRAGMA_COUNT]; // NULL: leave as is
+}
+tuning_profile_t;
+
+static const tuning_profile_t tuning_profiles[] = {
+    // SQLite defaults
+    { "default", {
+          [PRAGMA_LOCKING_MODE] = "normal", [PRAGMA_JOURNAL_MODE] = "delete",
+          [PRAGMA_CACHE_SIZE] = "-2000", [PRAGMA_MMAP_SIZE] = "0", [PRAGMA_TEMP_STORE] = "default"
+      } },
+    // single writer, large transactions, big page cache (256 MiB)
+    { "bulk-load", {
+          [PRAGMA_PAGE_SIZE] = "8192",
+          [PRAGMA_LOCKING_MODE] = "exclusive", [PRAGMA_JOURNAL_MODE] = "truncate",
+          [PRAGMA_CACHE_SIZE] = "-262144", [PRAGMA_MMAP_SIZE] = "0", [PRAGMA_TEMP_STORE] = "memory"
+      } },
+    // concurrent readers, 64 MiB page cache plus 1 GiB memory map
+    { "read-mostly", {
+          [PRAGMA_LOCKING_MODE] = "normal", [PRAGMA_JOURNAL_MODE] = "wal",
+          [PRAGMA_CACHE_SIZE] = "-65536", [PRAGMA_MMAP_SIZE] = "1073741824", [PRAGMA_TEMP_STORE] = "memory"
+      } },
+    // embedded devices, 512 KiB page cache, temp data on disk
+    { "low-memory", {
+          [PRAGMA_LOCKING_MODE] = "normal", [PRAGMA_JOURNAL_MODE] = "delete",
+          [PRAGMA_CACHE_SIZE] = "-512", [PRAGMA_MMAP_SIZE] = "0", [PRAGMA_TEMP_STORE] = "file"
+      } },
+    { NULL, { NULL } }
+};
+
+typedef enum {
+    BATCH_ABORT = 0, // roll back all of add_statements
+    BATCH_SKIP, // roll back the batch only, continue with the next one
+    BATCH_RETRY // roll back the batch, re-add it once, abort if it fails again
+} batch_policy_t;
+
+static const char *const batch_policies[] = {
+    "abort", "skip", "retry", NULL
+};
+
 typedef enum {
     P_S_URI       = 1 << 0,
     P_S_BLANK     = 1 << 1,
@@ -104,6 +221,33 @@ typedef enum {
 
 #define ALL_PARAMS ( (P_C_URI << 1) - 1 )
 
+/** PRAGMA analysis_limit, rows per index ANALYZE looks at, keeps it fast on large stores. */
+#define ANALYSIS_LIMIT "1000"
+/** Default of option analyze_after, row changes (incl. the term tables) */
+#define ANALYZE_AFTER 10000
+
+/** PRAGMA mmap_size for mode='ro' and immutable='yes', SQLite caps it at SQLITE_MAX_MMAP_SIZE. */
+#define READ_ONLY_MMAP_SIZE "1073741824"
+
+/** A warm-up run, see warm_up_start. */
+typedef struct
+{
+    sqlite3 *db; // own read only connection
+    const char *path;
+    sqlite3_int64 budget; // bytes, <= 0: all
+    int flags; // librdf_storage_sqlite_mro_warm_up_flags
+    librdf_storage_sqlite_mro_warm_up_done done;
+    void *user_data;
+    bool threaded;
+    pthread_t thread;
+    // set by warm_up_join, checked between steps, sqlite3_interrupt only stops a running statement. Access via __atomic builtins.
+    int cancel;
+    // result, read after pthread_join
+    sqlite3_int64 bytes;
+    int rc;
+}
+warm_up_t;
+
 typedef struct
 {
     sqlite3 *db;
@@ -111,22 +255,78 @@ typedef struct
 
     const char *name;
     bool is_new;
+    bool memory; // option memory='yes' or name ':memory:', no file at all
+    bool read_only; // option mode='ro', refuse all writes
+    bool immutable; // option immutable='yes', the file doesn't change while open
+    bool uri_prefixes; // option for new stores, afterwards whether the store has ns_uris
+    bool compact_literals; // option for new stores, afterwards whether the store has o_bodies
+    sqlite3_uint64 warm_up_budget; // option warm_up, bytes, 0: off
+    int warm_up_flags; // options warm_up_background and warm_up_madvise
+    warm_up_t *warm_up; // background run until warm_up_join, NULL: none
+    sqlite3_uint64 analyze_after; // option, 0: no automatic ANALYZE
+    sqlite3_int64 analyzed_changes; // sqlite3_total_changes at the last ANALYZE
     syncronous_flag_t synchronous;
+    const tuning_profile_t *tuning;
+    char *tuning_override[PRAGMA_COUNT]; // NULL: take value from tuning
     bool in_transaction;
+    unsigned int savepoint_depth; // nested transactions within in_transaction
+    size_t batch_size; // add_statements: statements per savepoint, 0: none
+    batch_policy_t batch_policy; // add_statements: what to do with a failing batch
 
     bool do_profile;
+    librdf_storage_sqlite_mro_metrics *metrics; // NULL: off
     bool do_explain_query_plan;
     sql_find_param_t sql_cache_mask;
 
+    // slow operation log, see slow_op_log
+    sqlite3_uint64 slow_ns; // threshold, 0: off
+    sqlite3_uint64 slow_rate; // max. reports per second, 0: unlimited
+    sqlite3_uint64 slow_window; // start of the current second
+    sqlite3_uint64 slow_in_window; // reports within the current second
+    sqlite3_uint64 slow_suppressed; // dropped by the rate limit since the last report
+    librdf_storage_sqlite_mro_slow_handler slow_handler; // NULL: librdf_log
+    void *slow_user_data;
+
+#if LIBRDF_STORAGE_SQLITE_MRO_TIMERS
+    librdf_storage_sqlite_mro_timers timers;
+#endif
+
+    // open find and context iterators, see librdf_storage_sqlite_mro_get_memory_stats
+    sqlite3_uint64 iterators;
+    sqlite3_uint64 iterator_bytes;
+
+    // preallocated slots for module objects, see pool_alloc
+    void *pool; // NULL: off
+    void *pool_free; // singly linked via the first pointer of each free slot, incl. recycled ones
+    size_t pool_slots;
+    size_t pool_recycled; // malloced slots on pool_free
+    sqlite3_uint64 pool_used;
+    sqlite3_uint64 pool_hit;
+    sqlite3_uint64 pool_miss; // pool exhausted or object too large, fell back to LIBRDF_CALLOC
+
+    // statements added vs. already present, see step_insert
+    sqlite3_uint64 count_inserted;
+    sqlite3_uint64 count_ignored;
+
     // compiled statements, lazy init
     sqlite3_stmt *stmt_txn_start;
     sqlite3_stmt *stmt_txn_commit;
     sqlite3_stmt *stmt_txn_rollback;
+    sqlite3_stmt *stmt_savepoint_start;
+    sqlite3_stmt *stmt_savepoint_release;
+    sqlite3_stmt *stmt_savepoint_rollback;
     sqlite3_stmt *stmt_triple_find; // complete triples
     sqlite3_stmt *stmt_triple_insert;
     sqlite3_stmt *stmt_triple_delete;
 
     sqlite3_stmt *stmt_size;
+    sqlite3_stmt *stmt_find[ALL_PARAMS + 1]; // by shape, see sql_cache_mask. NULL while in use by an iterator.
+    size_t stmt_find_count; // non NULL entries of stmt_find
+    size_t stmt_find_max; // option statement_cache_max
+
+    // empty statements of finished find iterators, see statement_shell
+    librdf_statement *statement_shells[16];
+    size_t statement_shell_count;
 }
 instance_t;
 
@@ -181,6 +381,20 @@ static inline char *literal_language(librdf_node *o)
 }
 
 
+/** Parse a non-negative decimal integer, false if invalid. */
+static bool parse_uint(const char *val, sqlite3_uint64 *value)
+{
+    if( !val || '\0' == *val || '-' == *val )
+        return false;
+    char *end = NULL;
+    const unsigned long long i = strtoull(val, &end, 10);
+    if( '\0' != *end )
+        return false;
+    *value = i;
+    return true;
+}
+
+
 /* Copy first 8 bytes of digest into 64bit using a method portable across big/little endianness.
  */
 static hash_t digest_hash(librdf_digest *digest)
@@ -203,18 +417,41 @@ static hash_t digest_hash(librdf_digest *digest)
 }
 
 
+static hash_t hash_counted_string(const unsigned char *str, const size_t len, librdf_digest *digest)
+{
+    assert(digest && "digest must be set.");
+    assert(str && "string NULL");
+    librdf_digest_init(digest);
+    librdf_digest_update(digest, str, len);
+    return digest_hash(digest);
+}
+
+
+/** Literal hash from it's parts, datatype and language may be NULL.
+ */
+static hash_t hash_literal_parts(const unsigned char *str, const size_t len, const unsigned char *datatype, const size_t datatype_len, const unsigned char *language, const size_t language_len, librdf_digest *digest)
+{
+    assert(digest && "digest must be set.");
+    assert(str && "literal without value");
+    librdf_digest_init(digest);
+    librdf_digest_update(digest, str, len);
+    if( datatype )
+        librdf_digest_update(digest, datatype, datatype_len);
+    if( language )
+        librdf_digest_update(digest, language, language_len);
+    return digest_hash(digest);
+}
+
+
 static hash_t hash_uri(librdf_uri *uri, librdf_digest *digest)
 {
     if( !uri )
         return NULL_ID;
-    assert(digest && "digest must be set.");
     size_t len = 0;
     const unsigned char *s = librdf_uri_as_counted_string(uri, &len);
     assert(s && "uri NULL");
     assert(len && "uri length 0");
-    librdf_digest_init(digest);
-    librdf_digest_update(digest, s, len);
-    return digest_hash(digest);
+    return hash_counted_string(s, len, digest);
 }
 
 
@@ -228,14 +465,11 @@ static hash_t node_hash_blank(librdf_node *node, librdf_digest *digest)
 {
     if( LIBRDF_NODE_TYPE_BLANK != node_type(node) )
         return NULL_ID;
-    assert(digest && "digest must be set.");
     size_t len = 0;
     unsigned char *b = librdf_node_get_counted_blank_identifier(node, &len);
     assert(b && "blank NULL");
     assert(len && "blank len 0");
-    librdf_digest_init(digest);
-    librdf_digest_update(digest, b, len);
-    return digest_hash(digest);
+    return hash_counted_string(b, len, digest);
 }
 
 
@@ -243,25 +477,15 @@ static hash_t node_hash_literal(librdf_node *node, librdf_digest *digest)
 {
     if( LIBRDF_NODE_TYPE_LITERAL != node_type(node) )
         return NULL_ID;
-    assert(digest && "digest must be set.");
-    librdf_digest_init(digest);
-    {
-        size_t len = 0;
-        unsigned char *str = librdf_node_get_literal_value_as_counted_string(node, &len);
-        assert(str && "literal without value");
-        assert(strlen( (char *)str ) == len && "TODO: NUL terminate or limit length!");
-        librdf_digest_update(digest, str, len);
-    }
+    size_t len = 0;
+    unsigned char *str = librdf_node_get_literal_value_as_counted_string(node, &len);
+    assert(str && "literal without value");
+    assert(strlen( (char *)str ) == len && "TODO: NUL terminate or limit length!");
+    size_t datatype_len = 0;
     librdf_uri *uri = librdf_node_get_literal_value_datatype_uri(node);
-    if( uri ) {
-        size_t len = 0;
-        const unsigned char *str = librdf_uri_as_counted_string(uri, &len);
-        librdf_digest_update(digest, str, len);
-    }
+    const unsigned char *datatype = uri ? librdf_uri_as_counted_string(uri, &datatype_len) : NULL;
     const char *l = librdf_node_get_literal_value_language(node);
-    if( l )
-        librdf_digest_update( digest, (unsigned char *)l, strlen(l) );
-    return digest_hash(digest);
+    return hash_literal_parts(str, len, datatype, datatype_len, (const unsigned char *)l, l ? strlen(l) : 0, digest);
 }
 
 
@@ -338,6 +562,84 @@ static int printExplainQueryPlan(sqlite3_stmt *pStmt)
 }
 
 
+/** 'SCAN triple_relations', 'SCAN TABLE triple_relations' (before SQLite 3.36) or a full scan of one of its indexes. */
+static int is_full_scan(const char *detail)
+{
+    return detail && 0 == strncmp(detail, "SCAN ", 5) && strstr(detail, "triple_relations");
+}
+
+
+/** Compile EXPLAIN QUERY PLAN for sql and keep the detail lines, separated by ' | '. */
+static int query_plan_explain(sqlite3 *db, const char *op, const int shape, const char *sql, librdf_storage_sqlite_mro_query_plan *plan)
+{
+    memset( plan, 0, sizeof(*plan) );
+    plan->op = op;
+    plan->shape = shape;
+
+    char *zExplain = sqlite3_mprintf("EXPLAIN QUERY PLAN %s", sql);
+    if( NULL == zExplain ) return SQLITE_NOMEM;
+    sqlite3_stmt *stmt = NULL;
+    int rc = sqlite3_prepare_v2(db, zExplain, -1, &stmt, NULL);
+    sqlite3_free(zExplain);
+    if( SQLITE_OK != rc ) return rc;
+
+    size_t len = 0;
+    while( SQLITE_ROW == ( rc = sqlite3_step(stmt) ) ) {
+        const char *detail = (const char *)sqlite3_column_text(stmt, 3);
+        if( !detail )
+            continue;
+        plan->full_scan |= is_full_scan(detail);
+        const size_t n = strlen(detail);
+        char *p = realloc(plan->plan, len + n + 4);
+        if( !p ) {
+            rc = SQLITE_NOMEM;
+            break;
+        }
+        plan->plan = p;
+        if( len ) {
+            memcpy(plan->plan + len, " | ", 3);
+            len += 3;
+        }
+        memcpy(plan->plan + len, detail, n + 1);
+        len += n;
+    }
+    const int rc_fin = sqlite3_finalize(stmt);
+    if( !plan->plan && !( plan->plan = calloc(1, 1) ) )
+        return SQLITE_NOMEM;
+    return SQLITE_DONE == rc ? rc_fin : rc;
+}
+
+
+/** CSV op,shape,full_scan,plan. Caller must free. */
+static char *query_plans_report(librdf_storage *storage)
+{
+    librdf_storage_sqlite_mro_query_plan *plans = NULL;
+    int count = 0;
+    if( RET_OK != librdf_storage_sqlite_mro_query_plans(storage, &plans, &count) )
+        return NULL;
+    size_t cap = 64;
+    for( int i = 0; i < count; i++ )
+        cap += 32 + strlen(plans[i].op) + (plans[i].plan ? 2 * strlen(plans[i].plan) : 0);
+    char *buf = LIBRDF_MALLOC(char *, cap);
+    if( buf ) {
+        char *p = buf + sprintf(buf, "op,shape,full_scan,plan\n");
+        for( int i = 0; i < count; i++ ) {
+            p += sprintf(p, "%s,%d,%d,\"", plans[i].op, plans[i].shape, plans[i].full_scan);
+            for( const char *c = plans[i].plan; c && *c; c++ ) {
+                if( '"' == *c )
+                    *p++ = '"';
+                *p++ = *c;
+            }
+            *p++ = '"';
+            *p++ = '\n';
+        }
+        *p = '\0';
+    }
+    librdf_storage_sqlite_mro_free_query_plans(plans, count);
+    return buf;
+}
+
+
 #if 0
 // http://stackoverflow.com/a/6618833
 static void trace(void *context, const char *sql)
@@ -349,673 +651,2180 @@ static void trace(void *context, const char *sql)
 #endif
 
 
-// http://stackoverflow.com/a/6618833
-static void profile(void *context, const char *sql, const sqlite3_uint64 ns)
+// http://stackoverflow.com/a/6618833, sqlite3_profile is deprecated
+static int profile(unsigned int type, void *context, void *p, void *x)
 {
-    // librdf_storage *storage = (librdf_storage *)context;
-    // instance_t *db_ctx = get_instance(storage);
-    fprintf(stderr, "dt=%llu ns Query SQL: %s\n", ns, sql);
+    if( SQLITE_TRACE_PROFILE != type )
+        return 0;
+    const char *sql = sqlite3_sql( (sqlite3_stmt *)p );
+    fprintf(stderr, "dt=%llu ns Query SQL: %s\n", *(sqlite3_uint64 *)x, sql);
+    return 0;
 }
 
 
-#pragma mark Sqlite Convenience
+#pragma mark Metrics
 
 
-/** Sqlite Result Code, e.g. SQLITE_OK */
-typedef int sqlite_rc_t;
+typedef librdf_storage_sqlite_mro_metric metric_t;
 
-static sqlite_rc_t log_error(sqlite3 *db, const char *sql, const sqlite_rc_t rc)
+/** Time spent per phase of one operation, excluding time spent outside the storage (e.g. between iterator calls). */
+typedef struct
 {
-    if( SQLITE_OK != rc ) {
-        const char *errmsg = sqlite3_errmsg(db);
-        librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite SQL error - %s (%d)\n%s", errmsg, rc, sql);
-    }
-    return rc;
+    sqlite3_uint64 t;
+    sqlite3_uint64 ns[LIBRDF_STORAGE_SQLITE_MRO_PHASE_COUNT];
 }
+metric_span_t;
 
 
-static sqlite3_stmt *prep_stmt(sqlite3 *db, sqlite3_stmt **stmt_p, const char *zSql)
+static inline sqlite3_uint64 now_ns(void)
 {
-    assert(db && "db handle is NULL");
-    assert(stmt_p && "statement is NULL");
-    assert(zSql && "SQL is NULL");
-    if( *stmt_p ) {
-        assert(0 == strcmp(sqlite3_sql(*stmt_p), zSql) && "sql changed during compilation.");
-        const sqlite_rc_t rc0 = sqlite3_reset(*stmt_p);
-        assert(SQLITE_OK == rc0 && "couldn't reset SQL statement");
-        const sqlite_rc_t rc1 = sqlite3_clear_bindings(*stmt_p);
-        assert(SQLITE_OK == rc1 && "couldn't reset SQL statement");
-    } else {
-        const char *remainder = NULL;
-        const int len_zSql = (int)strlen(zSql) + 1;
-        const sqlite_rc_t rc0 = log_error( db, zSql, sqlite3_prepare_v2(db, zSql, len_zSql, stmt_p, &remainder) );
-        assert(SQLITE_OK == rc0 && "couldn't compile SQL statement");
-        assert('\0' == *remainder && "had remainder");
-    }
-    assert(*stmt_p && "statement is NULL");
-    return *stmt_p;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (sqlite3_uint64)ts.tv_sec * 1000000000ull + (sqlite3_uint64)ts.tv_nsec;
 }
 
 
-static void finalize_stmt(sqlite3_stmt **pStmt)
+/** Time operations for metrics or the slow operation log. */
+static inline bool span_on(const instance_t *db_ctx)
 {
-    if( NULL == *pStmt )
-        return;
-    sqlite3_reset(*pStmt);
-    const sqlite_rc_t rc = sqlite3_finalize(*pStmt);
-    assert(SQLITE_OK == rc && "couldn't properly sqlite3_finalize");
-    *pStmt = NULL;
+    return db_ctx->metrics || db_ctx->slow_ns;
 }
 
 
-static sqlite_rc_t exec_stmt(sqlite3 *db, const char *sql)
+/** (Re-)start the clock, e.g. when entering the storage again. No-op if neither metrics nor the slow log are on. */
+static inline void span_resume(const instance_t *db_ctx, metric_span_t *span)
 {
-    char *errmsg = NULL;
-    const sqlite_rc_t rc = sqlite3_exec(db, sql, NULL, NULL, &errmsg);
-    sqlite3_free(errmsg);
-    return rc;
+    if( span_on(db_ctx) )
+        span->t = now_ns();
 }
 
 
-static inline sqlite_rc_t bind_int(sqlite3_stmt *stmt, const char *name, const hash_t _id)
+/** Attribute the time since the last resume or phase to phase. No-op if neither metrics nor the slow log are on. */
+static inline void span_phase(const instance_t *db_ctx, metric_span_t *span, const librdf_storage_sqlite_mro_phase phase)
 {
-    assert(stmt && "stmt mandatory");
-    assert(name && "name mandatory");
-    const int idx = sqlite3_bind_parameter_index(stmt, name);
-    return 0 == idx ? SQLITE_OK : sqlite3_bind_int64(stmt, idx, _id);
+    if( !span_on(db_ctx) )
+        return;
+    const sqlite3_uint64 t = now_ns();
+    span->ns[phase] += t - span->t;
+    span->t = t;
 }
 
 
-static inline sqlite_rc_t bind_text(sqlite3_stmt *stmt, const char *name, const unsigned char *text, const size_t text_len)
+/** 0: < 64ns, then 4 log-linear buckets per power of two. */
+static int metric_bucket(const sqlite3_uint64 ns)
 {
-    assert(stmt && "stmt mandatory");
-    assert(name && "name mandatory");
-    const int idx = sqlite3_bind_parameter_index(stmt, name);
-    return 0 == idx ? SQLITE_OK : ( NULL == text ? sqlite3_bind_null(stmt, idx) : sqlite3_bind_text(stmt, idx, (const char *)text, (int)text_len, SQLITE_STATIC) );
+    if( ns < 64 )
+        return 0;
+    int e = 63;
+    while( 0 == ( ns & (1ull << e) ) )
+        e--;
+    const int sub = (int)( ( ns >> (e - 2) ) & 3 );
+    const int idx = 1 + (e - 6) * 4 + sub;
+    return idx < LIBRDF_STORAGE_SQLITE_MRO_HISTOGRAM_BUCKETS ? idx : LIBRDF_STORAGE_SQLITE_MRO_HISTOGRAM_BUCKETS - 1;
 }
 
 
-static inline sqlite_rc_t bind_null(sqlite3_stmt *stmt, const char *name)
+/** Exclusive upper bound of bucket idx. */
+static sqlite3_uint64 metric_bucket_ns(const int idx)
 {
-    return bind_text(stmt, name, NULL, 0);
+    if( idx <= 0 )
+        return 64;
+    const int e = 6 + (idx - 1) / 4;
+    const int sub = (idx - 1) % 4;
+    return (sqlite3_uint64)(4 + sub + 1) << (e - 2);
 }
 
 
-static sqlite_rc_t bind_uri_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_uri *uri, hash_t *value)
+static void metric_add(metric_t *m, const metric_span_t *span, const sqlite3_uint64 ns, const sqlite3_uint64 rows)
 {
-    if( uri ) {
-        const hash_t v = hash_uri(uri, digest);
-        if( value ) *value = v;
-        return bind_int(stmt, name, v);
-    }
-    return bind_null(stmt, name);
+    m->calls++;
+    m->rows += rows;
+    m->ns_total += ns;
+    if( ns > m->ns_max )
+        m->ns_max = ns;
+    for( int i = 0; i < LIBRDF_STORAGE_SQLITE_MRO_PHASE_COUNT; i++ )
+        m->ns_phase[i] += span->ns[i];
+    m->histogram[metric_bucket(ns)]++;
 }
 
 
-static sqlite_rc_t bind_uri(sqlite3_stmt *stmt, const char *name, librdf_uri *uri)
+static inline bool needs_escape_literal(const unsigned char c)
 {
-    if( uri ) {
-        size_t len = 0;
-        const unsigned char *str = librdf_uri_as_counted_string(uri, &len);
-        return bind_text(stmt, name, str, len);
-    }
-    return bind_null(stmt, name);
+    return c < 0x20 || '"' == c || '\\' == c || 0x7F == c;
 }
 
 
-static sqlite_rc_t bind_node_uri_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
+/** N-Triples escape sequence for c, e.g. \" or \u0001, u is scratch space. */
+static const char *ntriples_escape(const unsigned char c, char u[8])
 {
-    return bind_uri_id(stmt, digest, name, LIBRDF_NODE_TYPE_RESOURCE == node_type(node) ? librdf_node_get_uri(node) : NULL, value);
+    switch( c ) {
+    case '"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        snprintf(u, 8, "\\u%04X", c);
+        return u;
+    }
 }
 
 
-static sqlite_rc_t bind_node_uri(sqlite3_stmt *stmt, const char *name, librdf_node *node)
+/** Escaped literal value into buf from pos on, truncated to size and never mid escape.
+ *
+ * @return the position of the terminating 0.
+ */
+static size_t term_put_literal(char *buf, const size_t size, size_t pos, const unsigned char *str)
 {
-    return bind_uri(stmt, name, LIBRDF_NODE_TYPE_RESOURCE == node_type(node) ? librdf_node_get_uri(node) : NULL);
+    for( ; *str; str++ ) {
+        char u[8];
+        const char *esc = needs_escape_literal(*str) ? ntriples_escape(*str, u) : NULL;
+        const size_t len = esc ? strlen(esc) : 1;
+        if( pos + len >= size )
+            break;
+        memcpy(buf + pos, esc ? esc : (const char *)str, len);
+        pos += len;
+    }
+    buf[pos] = '\0';
+    return pos;
 }
 
 
-static sqlite_rc_t bind_node_blank_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
+/** N-Triples like, truncated to size. NULL if node is NULL. */
+static const char *node_term_string(librdf_node *node, char *buf, const size_t size)
 {
-    if( LIBRDF_NODE_TYPE_BLANK == node_type(node) ) {
-        const hash_t v = node_hash_blank(node, digest);
-        if( value ) *value = v;
-        return bind_int(stmt, name, v);
+    switch( node_type(node) ) {
+    case LIBRDF_NODE_TYPE_RESOURCE:
+        snprintf(buf, size, "<%s>", (char *)librdf_uri_as_string(librdf_node_get_uri(node)));
+        return buf;
+    case LIBRDF_NODE_TYPE_BLANK: {
+        size_t len = 0;
+        snprintf(buf, size, "_:%s", (char *)librdf_node_get_counted_blank_identifier(node, &len));
+        return buf;
+    }
+    case LIBRDF_NODE_TYPE_LITERAL: {
+        const char *lang = literal_language(node);
+        librdf_uri *t = literal_type_uri(node);
+        const size_t pos = term_put_literal(buf, size, snprintf(buf, size, "\""), librdf_node_get_literal_value(node) );
+        snprintf(buf + pos, size - pos, "\"%s%s%s%s%s",
+                 lang ? "@" : "", lang ? lang : "",
+                 t ? "^^<" : "", t ? (char *)librdf_uri_as_string(t) : "", t ? ">" : "");
+        return buf;
+    }
+    default:
+        return NULL;
     }
-    return bind_null(stmt, name);
 }
 
 
-static sqlite_rc_t bind_node_blank(sqlite3_stmt *stmt, const char *name, librdf_node *node)
+static hash_t node_hash(librdf_node *node, librdf_digest *digest)
 {
-    if( LIBRDF_NODE_TYPE_BLANK == node_type(node) ) {
-        size_t len = 0;
-        const unsigned char *str = librdf_node_get_counted_blank_identifier(node, &len);
-        return bind_text(stmt, name, str, len);
+    switch( node_type(node) ) {
+    case LIBRDF_NODE_TYPE_RESOURCE:
+        return node_hash_uri(node, digest);
+    case LIBRDF_NODE_TYPE_BLANK:
+        return node_hash_blank(node, digest);
+    case LIBRDF_NODE_TYPE_LITERAL:
+        return node_hash_literal(node, digest);
+    default:
+        return NULL_ID;
     }
-    return bind_null(stmt, name);
 }
 
 
-static sqlite_rc_t bind_node_lit_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
+static const char *const metric_op_names[LIBRDF_STORAGE_SQLITE_MRO_OP_COUNT] = {
+    "add", "contains", "find", "remove", "size"
+};
+
+
+/** Report an operation exceeding slow_ns to the slow handler or librdf_log, at most slow_rate per second.
+ *
+ * @param statement pattern or statement, NULL if unknown.
+ */
+static void slow_op_log(librdf_storage *storage, const librdf_storage_sqlite_mro_op op, const int shape, const sqlite3_uint64 rows, const sqlite3_uint64 ns, librdf_statement *statement, librdf_node *context_node, const bool cached)
 {
-    if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
-        const hash_t v = node_hash_literal(node, digest);
-        if( value ) *value = v;
-        return bind_int(stmt, name, v);
+    instance_t *db_ctx = get_instance(storage);
+    const sqlite3_uint64 now = now_ns();
+    if( now - db_ctx->slow_window >= 1000000000ull ) {
+        db_ctx->slow_window = now;
+        db_ctx->slow_in_window = 0;
     }
-    return bind_null(stmt, name);
+    if( db_ctx->slow_rate && db_ctx->slow_in_window >= db_ctx->slow_rate ) {
+        db_ctx->slow_suppressed++;
+        return;
+    }
+    db_ctx->slow_in_window++;
+
+    librdf_node *nodes[4] = {
+        statement ? librdf_statement_get_subject(statement) : NULL,
+        statement ? librdf_statement_get_predicate(statement) : NULL,
+        statement ? librdf_statement_get_object(statement) : NULL,
+        context_node
+    };
+    char buf[4][256];
+    librdf_storage_sqlite_mro_slow_op slow = {
+        .op = op, .shape = shape, .rows = rows, .ns = ns, .cached = cached, .suppressed = db_ctx->slow_suppressed
+    };
+    for( int i = 0; i < 4; i++ ) {
+        slow.term[i] = node_term_string(nodes[i], buf[i], sizeof(buf[i]));
+        slow.term_id[i] = node_hash(nodes[i], db_ctx->digest);
+    }
+    db_ctx->slow_suppressed = 0;
+
+    if( db_ctx->slow_handler ) {
+        db_ctx->slow_handler(db_ctx->slow_user_data, &slow);
+        return;
+    }
+    librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL,
+               "slow %s shape=%d rows=%llu %llu us%s s=%s p=%s o=%s c=%s (%llu suppressed)",
+               metric_op_names[op], shape, slow.rows, slow.ns / 1000, cached ? " cached" : "",
+               slow.term[0] ? slow.term[0] : "-", slow.term[1] ? slow.term[1] : "-",
+               slow.term[2] ? slow.term[2] : "-", slow.term[3] ? slow.term[3] : "-",
+               slow.suppressed);
 }
 
 
-static sqlite_rc_t bind_stmt(instance_t *db_ctx, librdf_statement *statement, librdf_node *context_node, sqlite3_stmt *stmt)
+/** Record a finished operation, shape < 0 for non-find operations. No-op if neither metrics nor the slow log are on.
+ *
+ * @param statement pattern or statement for the slow log, NULL if unknown.
+ * @param cached whether the SQL statement was compiled already.
+ */
+static void span_record(librdf_storage *storage, const metric_span_t *span, const librdf_storage_sqlite_mro_op op, const int shape, const sqlite3_uint64 rows, librdf_statement *statement, librdf_node *context_node, const bool cached)
 {
-    librdf_node *s = librdf_statement_get_subject(statement);
-    librdf_node *p = librdf_statement_get_predicate(statement);
-    librdf_node *o = librdf_statement_get_object(statement);
+    const instance_t *db_ctx = get_instance(storage);
+    if( !span_on(db_ctx) )
+        return;
+    sqlite3_uint64 ns = 0;
+    for( int i = 0; i < LIBRDF_STORAGE_SQLITE_MRO_PHASE_COUNT; i++ )
+        ns += span->ns[i];
+    librdf_storage_sqlite_mro_metrics *metrics = db_ctx->metrics;
+    if( metrics ) {
+        metric_add(&(metrics->op[op]), span, ns, rows);
+        if( 0 <= shape && shape < LIBRDF_STORAGE_SQLITE_MRO_SHAPES )
+            metric_add(&(metrics->find[shape]), span, ns, rows);
+    }
+    if( db_ctx->slow_ns && ns >= db_ctx->slow_ns )
+        slow_op_log(storage, op, shape, rows, ns, statement, context_node, cached);
+}
 
-    sqlite_rc_t rc = SQLITE_OK;
-    hash_t s_uri_id = NULL_ID;
-    hash_t s_blank_id = NULL_ID;
-    hash_t p_uri_id = NULL_ID;
-    hash_t o_uri_id = NULL_ID;
-    hash_t o_blank_id = NULL_ID;
-    hash_t o_lit_id = NULL_ID;
-    hash_t o_type_id = NULL_ID;
-    hash_t c_uri_id = NULL_ID;
-    if( SQLITE_OK != ( rc = bind_node_uri_id(stmt, db_ctx->digest, ":s_uri_id", s, &s_uri_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":s_uri", s) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_blank_id(stmt, db_ctx->digest, ":s_blank_id", s, &s_blank_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_blank(stmt, ":s_blank", s) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri_id(stmt, db_ctx->digest, ":p_uri_id", p, &p_uri_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":p_uri", p) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri_id(stmt, db_ctx->digest, ":o_uri_id", o, &o_uri_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":o_uri", o) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_blank_id(stmt, db_ctx->digest, ":o_blank_id", o, &o_blank_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_blank(stmt, ":o_blank", o) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_lit_id(stmt, db_ctx->digest, ":o_lit_id", o, &o_lit_id) ) ) return rc;
-    if( LIBRDF_NODE_TYPE_LITERAL == node_type(o) ) {
-        if( SQLITE_OK != ( rc = bind_uri_id(stmt, db_ctx->digest, ":o_datatype_id", librdf_node_get_literal_value_datatype_uri(o), &o_type_id) ) ) return rc;
-        if( SQLITE_OK != ( rc = bind_uri( stmt, ":o_datatype", librdf_node_get_literal_value_datatype_uri(o) ) ) ) return rc;
-        char *l = librdf_node_get_literal_value_language(o);
-        if( l )
-            if( SQLITE_OK != ( rc = bind_text( stmt, ":o_language", (unsigned char *)l, strlen(l) ) ) ) return rc;
-        size_t len = 0;
-        const unsigned char *str = librdf_node_get_literal_value_as_counted_string(o, &len);
-        assert(strlen( (char *)str ) == len && "TODO: NUL terminate or limit length!");
-        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_text", str, len) ) ) return rc;
+
+static void metric_dump_line(char **buf, size_t *len, size_t *cap, const char *op, const int shape, const metric_t *m)
+{
+    if( 0 == m->calls )
+        return;
+    for( ;; ) {
+        const int n = snprintf(*buf + *len, *cap - *len, "%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+                               op, shape, m->calls, m->rows, m->ns_total, m->ns_max,
+                               librdf_storage_sqlite_mro_metric_percentile(m, 0.5),
+                               librdf_storage_sqlite_mro_metric_percentile(m, 0.99),
+                               m->ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE],
+                               m->ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_HASH],
+                               m->ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND],
+                               m->ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP],
+                               m->ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_MATERIALISE]);
+        if( n < 0 )
+            return;
+        if( (size_t)n < *cap - *len ) {
+            *len += n;
+            return;
+        }
+        char *b = realloc(*buf, *cap * 2);
+        if( !b )
+            return;
+        *buf = b;
+        *cap *= 2;
     }
+}
 
-    if( SQLITE_OK != ( rc = bind_node_uri_id(stmt, db_ctx->digest, ":c_uri_id", context_node, &c_uri_id) ) ) return rc;
-    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":c_uri", context_node) ) ) return rc;
 
-    if( !librdf_statement_is_complete(statement) )
-        return SQLITE_OK;
+/** CSV, caller must free. */
+static char *metrics_dump(const librdf_storage_sqlite_mro_metrics *metrics)
+{
+    size_t cap = 4096;
+    size_t len = 0;
+    char *buf = LIBRDF_MALLOC(char *, cap);
+    if( !buf )
+        return NULL;
+    len = snprintf(buf, cap, "op,shape,calls,rows,ns_total,ns_max,ns_p50,ns_p99,ns_prepare,ns_hash,ns_bind,ns_step,ns_materialise\n");
+    for( int op = 0; op < LIBRDF_STORAGE_SQLITE_MRO_OP_COUNT; op++ )
+        metric_dump_line(&buf, &len, &cap, metric_op_names[op], -1, &(metrics->op[op]) );
+    for( int shape = 0; shape < LIBRDF_STORAGE_SQLITE_MRO_SHAPES; shape++ )
+        metric_dump_line(&buf, &len, &cap, "find", shape, &(metrics->find[shape]) );
+    return buf;
+}
 
-    const hash_t stmt_id = hash_combine_stmt(s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id);
 
-    assert(stmt_hash(statement, context_node, db_ctx->digest) == stmt_id && "statement hash computation mismatch");
-    if( SQLITE_OK != ( rc = bind_int(stmt, ":stmt_id", stmt_id) ) ) return rc;
+#pragma mark Timers
 
-    return SQLITE_OK;
-}
 
+// Hot path timers, compiled in with -D LIBRDF_STORAGE_SQLITE_MRO_TIMERS=1 only, no runtime switch.
+#if LIBRDF_STORAGE_SQLITE_MRO_TIMERS
 
-static inline const str_uri_t column_uri_string(sqlite3_stmt *stmt, const int iCol)
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define TIMER_CYCLES 1
+static inline sqlite3_uint64 timer_ticks(void)
 {
-    return (str_uri_t)sqlite3_column_text(stmt, iCol);
+    return __builtin_ia32_rdtsc();
 }
 
 
-static inline const str_blank_t column_blank_string(sqlite3_stmt *stmt, const int iCol)
+#else
+#define TIMER_CYCLES 0
+static inline sqlite3_uint64 timer_ticks(void)
 {
-    return (str_blank_t)sqlite3_column_text(stmt, iCol);
+    return now_ns();
 }
 
 
-static inline const str_lang_t column_language(sqlite3_stmt *stmt, const int iCol)
+#endif
+
+static inline void timer_add(instance_t *db_ctx, const librdf_storage_sqlite_mro_timer timer, const sqlite3_uint64 t0)
 {
-    return (str_lang_t)sqlite3_column_text(stmt, iCol);
+    db_ctx->timers.ticks[timer] += timer_ticks() - t0;
+    db_ctx->timers.calls[timer]++;
 }
 
 
-static sqlite_rc_t transaction_start(librdf_storage *storage)
+/** Pass rc through, to time expressions, see TIMED. */
+static inline int timer_add_rc(instance_t *db_ctx, const librdf_storage_sqlite_mro_timer timer, const sqlite3_uint64 t0, const int rc)
 {
-    instance_t *db_ctx = get_instance(storage);
-    if( db_ctx->in_transaction )
-        return SQLITE_MISUSE;
-    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_start), "BEGIN IMMEDIATE TRANSACTION") );
-    db_ctx->in_transaction = SQLITE_DONE == rc;
-    assert(false != db_ctx->in_transaction && "transaction was not properly started");
-    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+    timer_add(db_ctx, timer, t0);
+    return rc;
 }
 
 
-static sqlite_rc_t transaction_commit(librdf_storage *storage, const sqlite_rc_t begin)
-{
-    if( begin != SQLITE_OK )
-        return SQLITE_OK;
-    instance_t *db_ctx = get_instance(storage);
-    if( false == db_ctx->in_transaction )
-        return SQLITE_MISUSE;
-    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_commit), "COMMIT  TRANSACTION") );
-    db_ctx->in_transaction = !(SQLITE_DONE == rc);
-    assert(false == db_ctx->in_transaction && "transaction was not properly committed");
-    return SQLITE_DONE == rc ? SQLITE_OK : rc;
-}
+#define TIMER_DECL sqlite3_uint64 timer_t0 = 0
+#define TIMER_START() ( timer_t0 = timer_ticks() )
+#define TIMER_STOP(db_ctx, timer) timer_add( (db_ctx), LIBRDF_STORAGE_SQLITE_MRO_TIMER_ ## timer, timer_t0 )
+/** Time an expression returning a sqlite_rc_t. */
+#define TIMED(db_ctx, timer, expr) ( TIMER_START(), timer_add_rc( (db_ctx), LIBRDF_STORAGE_SQLITE_MRO_TIMER_ ## timer, timer_t0, (expr) ) )
+
+#else
 
+#define TIMER_DECL do {} while( 0 )
+#define TIMER_START() do {} while( 0 )
+#define TIMER_STOP(db_ctx, timer) do {} while( 0 )
+#define TIMED(db_ctx, timer, expr) (expr)
 
-static sqlite_rc_t transaction_rollback(librdf_storage *storage, const sqlite_rc_t begin)
+#endif
+
+
+int librdf_storage_sqlite_mro_get_timers(librdf_storage *storage, librdf_storage_sqlite_mro_timers *timers, const int reset)
 {
-    if( SQLITE_OK != begin )
-        return SQLITE_OK;
+    assert(storage && "storage must be set.");
+    assert(timers && "timers must be set.");
+    memset( timers, 0, sizeof(*timers) );
+#if LIBRDF_STORAGE_SQLITE_MRO_TIMERS
     instance_t *db_ctx = get_instance(storage);
-    if( false == db_ctx->in_transaction )
-        return SQLITE_MISUSE;
-    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_rollback), "ROLLBACK TRANSACTION") );
-    db_ctx->in_transaction = !(SQLITE_DONE == rc);
-    assert(false == db_ctx->in_transaction && "transaction was not properly rolled back");
-    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+    if( !db_ctx )
+        return RET_ERROR;
+    *timers = db_ctx->timers;
+    timers->cycles = TIMER_CYCLES;
+    if( reset )
+        memset( &(db_ctx->timers), 0, sizeof(db_ctx->timers) );
+    return RET_OK;
+#else
+    return RET_ERROR;
+#endif
 }
 
 
-#pragma mark -
+#pragma mark Memory Pool
 
 
-#pragma mark Internal Implementation
+/** Slot size of the module object pool, fits the find and context iterators. */
+#define POOL_SLOT_SIZE 256
+/** Released slots beyond the pool kept for reuse, so steady state finds don't malloc. */
+#define POOL_RECYCLE_MAX 16
 
+/** Set by librdf_init_storage_sqlite_mro_memory, process wide. */
+static librdf_storage_sqlite_mro_memory_config memory_config;
 
-/** insert_triple_sql + find_triples_sql
- */
-typedef enum {
-    IDX_S_URI = 9,
-    IDX_S_BLANK,
-    IDX_P_URI,
-    IDX_O_URI,
-    IDX_O_BLANK,
-    IDX_O_TEXT,
-    IDX_O_LANGUAGE,
-    IDX_O_DATATYPE,
-    IDX_C_URI
+
+static int pool_init(instance_t *db_ctx, const size_t slots)
+{
+    if( 0 == slots )
+        return RET_OK;
+    char *pool = LIBRDF_MALLOC(char *, slots * POOL_SLOT_SIZE);
+    if( !pool )
+        return RET_ERROR;
+    // thread the free list back to front, so slots are handed out in address order
+    void *head = NULL;
+    for( size_t i = slots; i-- > 0; ) {
+        void **slot = (void **)( pool + i * POOL_SLOT_SIZE );
+        *slot = head;
+        head = slot;
+    }
+    db_ctx->pool = pool;
+    db_ctx->pool_free = head;
+    db_ctx->pool_slots = slots;
+    return RET_OK;
 }
-idx_triple_column_t;
 
 
-static librdf_statement *find_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement, const bool create)
+static inline bool pool_owns(const instance_t *db_ctx, const void *p)
 {
-    assert(statement && "statement must be set.");
-    assert(librdf_statement_is_complete(statement) && "statement must be complete.");
-
-    instance_t *db_ctx = get_instance(storage);
+    const char *pool = (const char *)db_ctx->pool;
+    return pool && (const char *)p >= pool && (const char *)p < pool + db_ctx->pool_slots * POOL_SLOT_SIZE;
+}
 
-    if( !create ) {
-        const hash_t stmt_id = stmt_hash(statement, context_node, db_ctx->digest);
-        assert(!isNULL_ID(stmt_id) && "mustn't be nil");
 
-        sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_find), "SELECT id FROM triple_relations WHERE id = :stmt_id");
+/** Zeroed like LIBRDF_CALLOC, from the pool or a recycled slot if free. Release with pool_release. */
+static void *pool_alloc(instance_t *db_ctx, const size_t size)
+{
+    assert(size <= POOL_SLOT_SIZE && "POOL_SLOT_SIZE too small");
+    if( db_ctx->pool_free ) {
+        void **slot = (void **)db_ctx->pool_free;
+        db_ctx->pool_free = *slot;
+        if( pool_owns(db_ctx, slot) )
+            db_ctx->pool_used++;
+        else
+            db_ctx->pool_recycled--;
+        db_ctx->pool_hit++;
+        return memset(slot, 0, size);
+    }
+    db_ctx->pool_miss++;
+    return LIBRDF_CALLOC(void *, POOL_SLOT_SIZE, 1);
+}
 
-        if( SQLITE_OK != bind_int(stmt, ":stmt_id", stmt_id) )
-            return NULL;
-        return SQLITE_ROW == sqlite3_step(stmt) ? statement : NULL;
-    }
-    const char insert_triple_sql[] = // generated via tools/sql2c.sh insert_triple.sql
-                                     "INSERT OR IGNORE INTO triples(" "\n" \
-                                     "  id," "\n" \
-                                     "  s_uri_id, s_uri," "\n" \
-                                     "  s_blank_id, s_blank," "\n" \
-                                     "  p_uri_id, p_uri," "\n" \
-                                     "  o_uri_id, o_uri," "\n" \
-                                     "  o_blank_id, o_blank," "\n" \
-                                     "  o_lit_id, o_datatype_id, o_datatype, o_language, o_text," "\n" \
-                                     "  c_uri_id, c_uri" "\n" \
-                                     ") VALUES (" "\n" \
-                                     "  :stmt_id," "\n" \
-                                     "  :s_uri_id, :s_uri," "\n" \
-                                     "  :s_blank_id, :s_blank," "\n" \
-                                     "  :p_uri_id, :p_uri," "\n" \
-                                     "  :o_uri_id, :o_uri," "\n" \
-                                     "  :o_blank_id, :o_blank," "\n" \
-                                     "  :o_lit_id, :o_datatype_id, :o_datatype, :o_language, :o_text," "\n" \
-                                     "  :c_uri_id, :c_uri" "\n" \
-                                     ")" "\n" \
-    ;
 
-    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_insert), insert_triple_sql);
-    if( SQLITE_OK != bind_stmt(db_ctx, statement, context_node, stmt) )
-        return NULL;
-    if( db_ctx->do_explain_query_plan )
-        printExplainQueryPlan(stmt);
-    const sqlite_rc_t rc = sqlite3_step(stmt);
-    return SQLITE_DONE == rc ? statement : NULL;
+/** Keep the slot for the next pool_alloc, malloced ones up to POOL_RECYCLE_MAX. */
+static void pool_release(instance_t *db_ctx, void *p)
+{
+    if( !p )
+        return;
+    if( pool_owns(db_ctx, p) )
+        db_ctx->pool_used--;
+    else if( db_ctx->pool_recycled < POOL_RECYCLE_MAX )
+        db_ctx->pool_recycled++;
+    else {
+        LIBRDF_FREE(void *, p);
+        return;
+    }
+    *(void **)p = db_ctx->pool_free;
+    db_ctx->pool_free = p;
 }
 
 
-#pragma mark -
+/** Free the recycled malloced slots, keep the preallocated ones. Returns the bytes freed. */
+static size_t pool_trim(instance_t *db_ctx)
+{
+    size_t freed = 0;
+    for( void **link = &(db_ctx->pool_free); *link; ) {
+        void *p = *link;
+        if( pool_owns(db_ctx, p) ) {
+            link = (void **)p;
+            continue;
+        }
+        *link = *(void **)p;
+        LIBRDF_FREE(void *, p);
+        freed += POOL_SLOT_SIZE;
+    }
+    db_ctx->pool_recycled = 0;
+    return freed;
+}
 
-#pragma mark Public Interface
 
+static void pool_done(instance_t *db_ctx)
+{
+    assert(0 == db_ctx->pool_used && "iterator leaked");
+    for( void *p = db_ctx->pool_free; p; ) {
+        void *next = *(void **)p;
+        if( !pool_owns(db_ctx, p) )
+            LIBRDF_FREE(void *, p);
+        p = next;
+    }
+    if( db_ctx->pool )
+        LIBRDF_FREE(void *, db_ctx->pool);
+    db_ctx->pool = db_ctx->pool_free = NULL;
+    db_ctx->pool_slots = db_ctx->pool_recycled = 0;
+}
 
-int librdf_storage_set_feature_mro_bool(librdf_storage *storage, const unsigned char *feature, const bool value)
+
+/** An empty statement, recycled if possible. Release with statement_shell_release. */
+static librdf_statement *statement_shell(instance_t *db_ctx, librdf_world *world)
 {
-    assert(storage && "storage must be set.");
-    assert(feature && "feature must be set.");
-    librdf_world *world = librdf_storage_get_world(storage);
-    assert(world && "world must be set.");
+    if( db_ctx->statement_shell_count > 0 )
+        return db_ctx->statement_shells[--db_ctx->statement_shell_count];
+    return librdf_new_statement(world);
+}
 
-    librdf_uri *uri_xsd_boolean = librdf_new_uri(world, (str_uri_t)LIBRDF_NAMESPACE_XSD "boolean");
-    assert(uri_xsd_boolean && "uri_xsd_boolean must be set.");
-    librdf_uri *uri_f = librdf_new_uri(world, feature);
-    assert(uri_f && "uri_f must be set.");
-    const str_lit_val_t v = (str_lit_val_t)(value ? "true" : "false");
-    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "librdf_storage_set_feature_mro_bool sets '%s'", v);
-    librdf_node *n = librdf_new_node_from_typed_literal(world, v, NULL, uri_xsd_boolean);
 
-    const int ret = librdf_storage_set_feature(storage, uri_f, n);
+/** Copy of statement, shares the nodes (librdf_new_node_from_node just counts references). */
+static librdf_statement *statement_shell_copy(instance_t *db_ctx, librdf_world *world, librdf_statement *statement)
+{
+    if( !statement )
+        return NULL;
+    librdf_statement *st = statement_shell(db_ctx, world);
+    if( !st )
+        return NULL;
+    librdf_node *s = librdf_statement_get_subject(statement);
+    librdf_node *p = librdf_statement_get_predicate(statement);
+    librdf_node *o = librdf_statement_get_object(statement);
+    if( s )
+        librdf_statement_set_subject( st, librdf_new_node_from_node(s) );
+    if( p )
+        librdf_statement_set_predicate( st, librdf_new_node_from_node(p) );
+    if( o )
+        librdf_statement_set_object( st, librdf_new_node_from_node(o) );
+    return st;
+}
 
-    librdf_free_node(n);
-    librdf_free_uri(uri_f);
-    librdf_free_uri(uri_xsd_boolean);
 
-    return ret;
+static void statement_shell_release(instance_t *db_ctx, librdf_statement *st)
+{
+    if( !st )
+        return;
+    if( db_ctx->statement_shell_count < array_length(db_ctx->statement_shells) ) {
+        librdf_statement_clear(st);
+        db_ctx->statement_shells[db_ctx->statement_shell_count++] = st;
+    } else
+        librdf_free_statement(st);
 }
 
 
-int librdf_storage_set_feature_mro_int(librdf_storage *storage, const unsigned char *feature, const int value)
+static void statement_shells_done(instance_t *db_ctx)
 {
-    assert(storage && "storage must be set.");
-    assert(feature && "feature must be set.");
-    librdf_world *world = librdf_storage_get_world(storage);
-    assert(world && "world must be set.");
+    while( db_ctx->statement_shell_count > 0 )
+        librdf_free_statement(db_ctx->statement_shells[--db_ctx->statement_shell_count]);
+}
 
-    librdf_uri *uri_xsd_integer = librdf_new_uri(world, (str_uri_t)LIBRDF_NAMESPACE_XSD "integer");
-    assert(uri_xsd_integer && "uri_xsd_integer must be set.");
-    librdf_uri *uri_f = librdf_new_uri(world, feature);
-    assert(uri_f && "uri_f must be set.");
-    char v[20];
-    snprintf(v, sizeof(v), "%d", value);
-    librdf_node *n = librdf_new_node_from_typed_literal(world, (str_lit_val_t)v, NULL, uri_xsd_integer);
 
-    const int ret = librdf_storage_set_feature(storage, uri_f, n);
+#pragma mark Memory Statistics
 
-    librdf_free_node(n);
-    librdf_free_uri(uri_f);
-    librdf_free_uri(uri_xsd_integer);
 
-    return ret;
+typedef librdf_storage_sqlite_mro_memory_stats memory_stats_t;
+
+typedef struct
+{
+    const char *name;
+    int op;
+    bool highwater; // report the highwater mark instead of the current value
+    size_t offset; // into memory_stats_t
 }
+status_field_t;
+
+/** sqlite3_db_status, per connection. */
+static const status_field_t db_status_fields[] = {
+    { "cache_used", SQLITE_DBSTATUS_CACHE_USED, false, offsetof(memory_stats_t, cache_used) },
+    { "cache_hit", SQLITE_DBSTATUS_CACHE_HIT, false, offsetof(memory_stats_t, cache_hit) },
+    { "cache_miss", SQLITE_DBSTATUS_CACHE_MISS, false, offsetof(memory_stats_t, cache_miss) },
+    { "cache_write", SQLITE_DBSTATUS_CACHE_WRITE, false, offsetof(memory_stats_t, cache_write) },
+    { "schema_used", SQLITE_DBSTATUS_SCHEMA_USED, false, offsetof(memory_stats_t, schema_used) },
+    { "stmt_used", SQLITE_DBSTATUS_STMT_USED, false, offsetof(memory_stats_t, stmt_used) },
+    { "lookaside_used", SQLITE_DBSTATUS_LOOKASIDE_USED, false, offsetof(memory_stats_t, lookaside_used) },
+    { "lookaside_highwater", SQLITE_DBSTATUS_LOOKASIDE_USED, true, offsetof(memory_stats_t, lookaside_highwater) },
+    { "lookaside_hit", SQLITE_DBSTATUS_LOOKASIDE_HIT, true, offsetof(memory_stats_t, lookaside_hit) },
+    { "lookaside_miss_size", SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, true, offsetof(memory_stats_t, lookaside_miss_size) },
+    { "lookaside_miss_full", SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, true, offsetof(memory_stats_t, lookaside_miss_full) },
+};
+
+/** sqlite3_status64, process wide. */
+static const status_field_t status_fields[] = {
+    { "memory_used", SQLITE_STATUS_MEMORY_USED, false, offsetof(memory_stats_t, memory_used) },
+    { "memory_highwater", SQLITE_STATUS_MEMORY_USED, true, offsetof(memory_stats_t, memory_highwater) },
+    { "malloc_count", SQLITE_STATUS_MALLOC_COUNT, false, offsetof(memory_stats_t, malloc_count) },
+    { "malloc_size_highwater", SQLITE_STATUS_MALLOC_SIZE, true, offsetof(memory_stats_t, malloc_size_highwater) },
+    { "pagecache_used", SQLITE_STATUS_PAGECACHE_USED, false, offsetof(memory_stats_t, pagecache_used) },
+    { "pagecache_overflow", SQLITE_STATUS_PAGECACHE_OVERFLOW, false, offsetof(memory_stats_t, pagecache_overflow) },
+    { "pagecache_size_highwater", SQLITE_STATUS_PAGECACHE_SIZE, true, offsetof(memory_stats_t, pagecache_size_highwater) },
+};
+
+/** The module's own, not via status ops. */
+static const status_field_t module_fields[] = {
+    { "statements", 0, false, offsetof(memory_stats_t, statements) },
+    { "statements_cached", 0, false, offsetof(memory_stats_t, statements_cached) },
+    { "iterators", 0, false, offsetof(memory_stats_t, iterators) },
+    { "module_used", 0, false, offsetof(memory_stats_t, module_used) },
+    { "pool_slots", 0, false, offsetof(memory_stats_t, pool_slots) },
+    { "pool_used", 0, false, offsetof(memory_stats_t, pool_used) },
+    { "pool_hit", 0, false, offsetof(memory_stats_t, pool_hit) },
+    { "pool_miss", 0, false, offsetof(memory_stats_t, pool_miss) },
+};
 
 
-int librdf_storage_get_feature_mro_bool(librdf_storage *storage, const unsigned char *feature, bool *value)
+int librdf_storage_sqlite_mro_get_memory_stats(librdf_storage *storage, librdf_storage_sqlite_mro_memory_stats *stats, const int reset)
 {
     assert(storage && "storage must be set.");
-    assert(feature && "feature must be set.");
-    librdf_world *world = librdf_storage_get_world(storage);
-    assert(world && "world must be set.");
+    assert(stats && "stats must be set.");
+    memset( stats, 0, sizeof(*stats) );
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx || !db_ctx->db )
+        return RET_ERROR;
 
-    librdf_uri *uri_f = librdf_new_uri(world, feature);
-    int err = RET_OK;
-    bool ret = false;
-    if( uri_f ) {
-        librdf_node *node = librdf_storage_get_feature(storage, uri_f);
-        if( node ) {
-            if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
-                size_t len = 0;
-                const char *v = (char *)librdf_node_get_literal_value_as_counted_string(node, &len);
-                if( v ) {
-                    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "librdf_storage_get_feature_mro_bool return '%s'", v);
-                    if( 0 == strncmp("true", v, len) || 0 == strncmp("1", v, len) )
-                        ret = true;
-                    else if( 0 == strncmp("false", v, len) || 0 == strncmp("0", v, len) )
-                        ret = false;
-                    else
-                        err = 4;
-                } else
-                    err = 3;
-            } else
-                err = 2;
-            librdf_free_node(node);
-        } else
-            err = 1;
-        librdf_free_uri(uri_f);
+    for( size_t i = 0; i < array_length(db_status_fields); i++ ) {
+        int cur = 0;
+        int hi = 0;
+        const status_field_t *f = &db_status_fields[i];
+        if( SQLITE_OK != sqlite3_db_status(db_ctx->db, f->op, &cur, &hi, reset) )
+            return RET_ERROR;
+        *(long long *)( (char *)stats + f->offset ) = f->highwater ? hi : cur;
     }
-    if( value )
-        *value = ret;
-    return err;
+    for( size_t i = 0; i < array_length(status_fields); i++ ) {
+        sqlite3_int64 cur = 0;
+        sqlite3_int64 hi = 0;
+        const status_field_t *f = &status_fields[i];
+        if( SQLITE_OK != sqlite3_status64(f->op, &cur, &hi, reset) )
+            return RET_ERROR;
+        *(long long *)( (char *)stats + f->offset ) = f->highwater ? hi : cur;
+    }
+
+    for( sqlite3_stmt *stmt = sqlite3_next_stmt(db_ctx->db, NULL); stmt; stmt = sqlite3_next_stmt(db_ctx->db, stmt) )
+        stats->statements++;
+    sqlite3_stmt *const cached[] = {
+        db_ctx->stmt_txn_start, db_ctx->stmt_txn_commit, db_ctx->stmt_txn_rollback,
+        db_ctx->stmt_savepoint_start, db_ctx->stmt_savepoint_release, db_ctx->stmt_savepoint_rollback,
+        db_ctx->stmt_triple_find, db_ctx->stmt_triple_insert, db_ctx->stmt_triple_delete, db_ctx->stmt_size
+    };
+    for( size_t i = 0; i < array_length(cached); i++ )
+        stats->statements_cached += NULL != cached[i];
+    for( size_t i = 0; i < array_length(db_ctx->stmt_find); i++ )
+        stats->statements_cached += NULL != db_ctx->stmt_find[i];
+    stats->iterators = db_ctx->iterators;
+    stats->module_used = sizeof(*db_ctx) + db_ctx->iterator_bytes + (db_ctx->metrics ? sizeof(*db_ctx->metrics) : 0)
+                         + db_ctx->pool_slots * POOL_SLOT_SIZE;
+    stats->pool_slots = db_ctx->pool_slots;
+    stats->pool_used = db_ctx->pool_used;
+    stats->pool_hit = db_ctx->pool_hit;
+    stats->pool_miss = db_ctx->pool_miss;
+    if( reset )
+        db_ctx->pool_hit = db_ctx->pool_miss = 0;
+    return RET_OK;
 }
 
 
-int librdf_storage_get_feature_mro_int(librdf_storage *storage, const unsigned char *feature, int *value)
+/** CSV name,value. Caller must free. */
+static char *memory_stats_dump(librdf_storage *storage)
 {
-    assert(storage && "storage must be set.");
-    assert(feature && "feature must be set.");
-    librdf_world *world = librdf_storage_get_world(storage);
-    assert(world && "world must be set.");
-
-    librdf_uri *uri_f = librdf_new_uri(world, feature);
-    int err = RET_OK;
-    long ret = RET_OK;
-    if( uri_f ) {
-        librdf_node *node = librdf_storage_get_feature(storage, uri_f);
-        if( node ) {
-            if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
-                size_t len = 0;
-                const char *str = (char *)librdf_node_get_literal_value_as_counted_string(node, &len);
-                if( str ) {
-                    assert(strlen(str) == len && "TODO: NUL terminate or limit length!");
-                    char *end = NULL;
-                    ret = strtol(str, &end, 10);
-                    if( '\0' != *end )
-                        err = 4;
-                } else
-                    err = 3;
-            } else
-                err = 2;
-            librdf_free_node(node);
-        } else
-            err = 1;
-        librdf_free_uri(uri_f);
-    }
-    if( value )
-        *value = ret;
-    return err;
+    memory_stats_t stats;
+    if( RET_OK != librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0) )
+        return NULL;
+    const status_field_t *const tables[] = {
+        db_status_fields, status_fields, module_fields
+    };
+    const size_t counts[] = {
+        array_length(db_status_fields), array_length(status_fields), array_length(module_fields)
+    };
+    const size_t cap = 64 * ( counts[0] + counts[1] + counts[2] + 1 );
+    char *buf = LIBRDF_MALLOC(char *, cap);
+    if( !buf )
+        return NULL;
+    size_t len = snprintf(buf, cap, "name,value\n");
+    for( size_t t = 0; t < array_length(tables); t++ )
+        for( size_t i = 0; i < counts[t]; i++ )
+            len += snprintf(buf + len, cap - len, "%s,%lld\n", tables[t][i].name, *(long long *)( (char *)&stats + tables[t][i].offset ));
+    return buf;
 }
 
 
-#pragma mark Lifecycle & Housekeeping
+#pragma mark Sqlite Convenience
 
 
-/** Create a new storage.
- *
- * Setup SQLIte connection instance but don't open yet.
- */
-static int pub_init(librdf_storage *storage, const char *name, librdf_hash *options)
+/** Sqlite Result Code, e.g. SQLITE_OK */
+typedef int sqlite_rc_t;
+
+static sqlite_rc_t log_error(sqlite3 *db, const char *sql, const sqlite_rc_t rc)
 {
-    if( !name ) {
-        free_hash(options);
-        return RET_ERROR;
+    if( SQLITE_OK != rc ) {
+        const char *errmsg = sqlite3_errmsg(db);
+        librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite SQL error - %s (%d)\n%s", errmsg, rc, sql);
     }
+    return rc;
+}
 
-    instance_t *db_ctx = LIBRDF_CALLOC(instance_t *, sizeof(*db_ctx), 1);
-    if( !db_ctx ) {
-        free_hash(options);
-        return RET_ERROR;
-    }
-    // feature defaults
-    db_ctx->do_profile = false;
-    db_ctx->do_explain_query_plan = false;
-    db_ctx->sql_cache_mask = ALL_PARAMS;
 
-    librdf_storage_set_instance(storage, db_ctx);
-    const size_t name_len = strlen(name);
-    char *name_copy = LIBRDF_MALLOC(char *, name_len + 1);
-    if( !name_copy ) {
-        free_hash(options);
-        return RET_ERROR;
+static sqlite3_stmt *prep_stmt(sqlite3 *db, sqlite3_stmt **stmt_p, const char *zSql)
+{
+    assert(db && "db handle is NULL");
+    assert(stmt_p && "statement is NULL");
+    assert(zSql && "SQL is NULL");
+    if( *stmt_p ) {
+        assert(0 == strcmp(sqlite3_sql(*stmt_p), zSql) && "sql changed during compilation.");
+        const sqlite_rc_t rc0 = sqlite3_reset(*stmt_p);
+        assert(SQLITE_OK == rc0 && "couldn't reset SQL statement");
+        const sqlite_rc_t rc1 = sqlite3_clear_bindings(*stmt_p);
+        assert(SQLITE_OK == rc1 && "couldn't reset SQL statement");
+    } else {
+        const char *remainder = NULL;
+        const int len_zSql = (int)strlen(zSql) + 1;
+        const sqlite_rc_t rc0 = log_error( db, zSql, sqlite3_prepare_v2(db, zSql, len_zSql, stmt_p, &remainder) );
+        assert(SQLITE_OK == rc0 && "couldn't compile SQL statement");
+        assert('\0' == *remainder && "had remainder");
     }
+    assert(*stmt_p && "statement is NULL");
+    return *stmt_p;
+}
 
-    strncpy(name_copy, name, name_len + 1);
-    db_ctx->name = name_copy;
 
-    if( !( db_ctx->digest = librdf_new_digest(get_world(storage), "MD5") ) ) {
-        free_hash(options);
-        return RET_ERROR;
-    }
+static void finalize_stmt(sqlite3_stmt **pStmt)
+{
+    if( NULL == *pStmt )
+        return;
+    sqlite3_reset(*pStmt);
+    const sqlite_rc_t rc = sqlite3_finalize(*pStmt);
+    assert(SQLITE_OK == rc && "couldn't properly sqlite3_finalize");
+    *pStmt = NULL;
+}
 
-    if( false != librdf_hash_get_as_boolean(options, "new") )
-        db_ctx->is_new = true;  /* default is NOT NEW */
 
-    /* Redland default is "PRAGMA synchronous normal" */
-    db_ctx->synchronous = SYNC_NORMAL;
+static sqlite_rc_t exec_stmt(sqlite3 *db, const char *sql)
+{
+    char *errmsg = NULL;
+    const sqlite_rc_t rc = sqlite3_exec(db, sql, NULL, NULL, &errmsg);
+    sqlite3_free(errmsg);
+    return rc;
+}
 
-    char *synchronous = synchronous = librdf_hash_get(options, "synchronous");
-    if( synchronous ) {
-        for( int i = 0; synchronous_flags[i]; i++ ) {
-            if( !strcmp(synchronous, synchronous_flags[i]) ) {
-                db_ctx->synchronous = i;
-                break;
-            }
-        }
-        LIBRDF_FREE(char *, synchronous);
-    }
 
-    free_hash(options);
-    return RET_OK;
+/** Single integer result of a PRAGMA or SELECT, -1 on failure. */
+static sqlite3_int64 query_int(sqlite3 *db, const char *sql)
+{
+    sqlite3_stmt *stmt = NULL;
+    if( SQLITE_OK != log_error( db, sql, sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) ) )
+        return -1;
+    const sqlite3_int64 ret = SQLITE_ROW == sqlite3_step(stmt) ? sqlite3_column_int64(stmt, 0) : -1;
+    sqlite3_finalize(stmt);
+    return ret;
 }
 
 
-static void pub_terminate(librdf_storage *storage)
+static inline sqlite_rc_t bind_int(sqlite3_stmt *stmt, const char *name, const hash_t _id)
 {
-    instance_t *db_ctx = get_instance(storage);
-    if( NULL == db_ctx )
-        return;
-    if( db_ctx->name )
-        LIBRDF_FREE(char *, (void *)db_ctx->name);
-    if( db_ctx->digest )
-        librdf_free_digest(db_ctx->digest);
+    assert(stmt && "stmt mandatory");
+    assert(name && "name mandatory");
+    const int idx = sqlite3_bind_parameter_index(stmt, name);
+    return 0 == idx ? SQLITE_OK : sqlite3_bind_int64(stmt, idx, _id);
+}
 
-    LIBRDF_FREE(instance_t *, db_ctx);
+
+static inline sqlite_rc_t bind_text(sqlite3_stmt *stmt, const char *name, const unsigned char *text, const size_t text_len)
+{
+    assert(stmt && "stmt mandatory");
+    assert(name && "name mandatory");
+    const int idx = sqlite3_bind_parameter_index(stmt, name);
+    return 0 == idx ? SQLITE_OK : ( NULL == text ? sqlite3_bind_null(stmt, idx) : sqlite3_bind_text(stmt, idx, (const char *)text, (int)text_len, SQLITE_STATIC) );
 }
 
 
-static int pub_close(librdf_storage *storage)
+static inline sqlite_rc_t bind_null(sqlite3_stmt *stmt, const char *name)
 {
-    instance_t *db_ctx = get_instance(storage);
-    if( !db_ctx->db )
-        return RET_OK;
+    return bind_text(stmt, name, NULL, 0);
+}
 
-    finalize_stmt( &(db_ctx->stmt_txn_start) );
-    finalize_stmt( &(db_ctx->stmt_txn_commit) );
-    finalize_stmt( &(db_ctx->stmt_txn_rollback) );
-    finalize_stmt( &(db_ctx->stmt_triple_find) );
-    finalize_stmt( &(db_ctx->stmt_triple_insert) );
-    finalize_stmt( &(db_ctx->stmt_triple_delete) );
 
-    finalize_stmt( &(db_ctx->stmt_size) );
+static sqlite_rc_t bind_uri_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_uri *uri, hash_t *value)
+{
+    if( uri ) {
+        const hash_t v = hash_uri(uri, digest);
+        if( value ) *value = v;
+        return bind_int(stmt, name, v);
+    }
+    return bind_null(stmt, name);
+}
 
-    const sqlite_rc_t rc = sqlite3_close(db_ctx->db);
-    if( SQLITE_OK == rc ) {
-        db_ctx->db = NULL;
-        return RET_OK;
+
+static sqlite_rc_t bind_uri(sqlite3_stmt *stmt, const char *name, librdf_uri *uri)
+{
+    if( uri ) {
+        size_t len = 0;
+        const unsigned char *str = librdf_uri_as_counted_string(uri, &len);
+        return bind_text(stmt, name, str, len);
     }
-    char *errmsg = (char *)sqlite3_errmsg(db_ctx->db);
-    librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite database %s close failed - %s", db_ctx->name, errmsg);
-    return rc;
+    return bind_null(stmt, name);
 }
 
 
-static int pub_open(librdf_storage *storage, librdf_model *model)
+static sqlite_rc_t bind_node_uri_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
 {
-    instance_t *db_ctx = get_instance(storage);
+    return bind_uri_id(stmt, digest, name, LIBRDF_NODE_TYPE_RESOURCE == node_type(node) ? librdf_node_get_uri(node) : NULL, value);
+}
 
-    const bool file_exists = ( 0 == access(db_ctx->name, F_OK) );
-    if( db_ctx->is_new && file_exists )
-        unlink(db_ctx->name);
 
-    // open DB
-    assert( (NULL == db_ctx->db) && "db handle mustn't be set by now" );
-    db_ctx->db = NULL;
-    {
-        const sqlite_rc_t rc = sqlite3_open(db_ctx->name, &db_ctx->db);
-        if( SQLITE_OK != rc ) {
-            const char *errmsg = sqlite3_errmsg(db_ctx->db);
-            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite database %s open failed - %s", db_ctx->name, errmsg);
-            return rc;
-        }
+static sqlite_rc_t bind_node_uri(sqlite3_stmt *stmt, const char *name, librdf_node *node)
+{
+    return bind_uri(stmt, name, LIBRDF_NODE_TYPE_RESOURCE == node_type(node) ? librdf_node_get_uri(node) : NULL);
+}
 
-        // http://stackoverflow.com/a/6618833
-        if( db_ctx->do_profile ) {
-            sqlite3_profile(db_ctx->db, &profile, NULL);
-            // sqlite3_trace(db_ctx->db, &trace, NULL);
-        }
+
+static sqlite_rc_t bind_node_blank_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
+{
+    if( LIBRDF_NODE_TYPE_BLANK == node_type(node) ) {
+        const hash_t v = node_hash_blank(node, digest);
+        if( value ) *value = v;
+        return bind_int(stmt, name, v);
     }
+    return bind_null(stmt, name);
+}
 
-    // set DB session PRAGMAs
-    if( SYNC_OFF <= db_ctx->synchronous ) {
-        char sql[250];
-        const size_t len = snprintf(sql, sizeof(sql) - 1, "PRAGMA synchronous=%s;", synchronous_flags[db_ctx->synchronous]);
-        assert(len < sizeof(sql) && "buffer too small.");
-        const sqlite_rc_t rc = exec_stmt(db_ctx->db, sql);
-        if( SQLITE_OK != rc ) {
-            pub_close(storage);
-            return rc;
-        }
+
+static sqlite_rc_t bind_node_blank(sqlite3_stmt *stmt, const char *name, librdf_node *node)
+{
+    if( LIBRDF_NODE_TYPE_BLANK == node_type(node) ) {
+        size_t len = 0;
+        const unsigned char *str = librdf_node_get_counted_blank_identifier(node, &len);
+        return bind_text(stmt, name, str, len);
     }
-    {
-        const char *const sqls[] = {
-            "PRAGMA foreign_keys = ON;",
-            "PRAGMA recursive_triggers = ON;",
-            "PRAGMA encoding = 'UTF-8';",
-            NULL
-        };
-        for( int v = 0; sqls[v]; v++ ) {
-            const sqlite_rc_t rc = exec_stmt(db_ctx->db, sqls[v]);
-            if( SQLITE_OK != rc ) {
-                pub_close(storage);
-                return rc;
-            }
-        }
+    return bind_null(stmt, name);
+}
+
+
+static sqlite_rc_t bind_node_lit_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, librdf_node *node, hash_t *value)
+{
+    if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
+        const hash_t v = node_hash_literal(node, digest);
+        if( value ) *value = v;
+        return bind_int(stmt, name, v);
     }
+    return bind_null(stmt, name);
+}
 
-    // check & update schema (run migrations)
-    {
-        sqlite_rc_t rc = SQLITE_OK;
-        sqlite3_stmt *stmt = NULL;
-        prep_stmt(db_ctx->db, &stmt, "PRAGMA user_version;");
-        if( SQLITE_ROW != ( rc = sqlite3_step(stmt) ) ) {
-            sqlite3_finalize(stmt);
-            pub_close(storage);
-            return rc;
-        }
-        const int schema_version = sqlite3_column_int(stmt, 0);
-        if( SQLITE_DONE != ( rc = sqlite3_step(stmt) ) ) {
-            sqlite3_finalize(stmt);
-            pub_close(storage);
-            return rc;
-        }
-        sqlite3_finalize(stmt);
 
-        const char *const migrations[] = {
-            // generated via tools/sql2c.sh sql/schema_mig_to_1.sql
-            "PRAGMA foreign_keys = ON;" "\n" \
-            "PRAGMA recursive_triggers = ON;" "\n" \
-            "PRAGMA encoding = 'UTF-8';" "\n" \
-            " -- URIs for subjects and objects" "\n" \
-            "CREATE TABLE so_uris (" "\n" \
-            "  id INTEGER PRIMARY KEY" "\n" \
-            "  ,uri TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
-            ");" "\n" \
-            " -- blank node IDs for subjects and objects" "\n" \
-            "CREATE TABLE so_blanks (" "\n" \
-            "  id INTEGER PRIMARY KEY" "\n" \
-            "  ,blank TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
-            ");" "\n" \
-            " -- URIs for predicates" "\n" \
-            "CREATE TABLE p_uris (" "\n" \
-            "  id INTEGER PRIMARY KEY" "\n" \
-            "  ,uri TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
-            ");" "\n" \
-            " -- URIs for literal types" "\n" \
-            "CREATE TABLE t_uris (" "\n" \
+static sqlite_rc_t bind_stmt(instance_t *db_ctx, librdf_statement *statement, librdf_node *context_node, sqlite3_stmt *stmt)
+{
+    TIMER_DECL;
+    librdf_node *s = statement ? librdf_statement_get_subject(statement) : NULL;
+    librdf_node *p = statement ? librdf_statement_get_predicate(statement) : NULL;
+    librdf_node *o = statement ? librdf_statement_get_object(statement) : NULL;
+
+    sqlite_rc_t rc = SQLITE_OK;
+    hash_t s_uri_id = NULL_ID;
+    hash_t s_blank_id = NULL_ID;
+    hash_t p_uri_id = NULL_ID;
+    hash_t o_uri_id = NULL_ID;
+    hash_t o_blank_id = NULL_ID;
+    hash_t o_lit_id = NULL_ID;
+    hash_t o_type_id = NULL_ID;
+    hash_t c_uri_id = NULL_ID;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_uri_id(stmt, db_ctx->digest, ":s_uri_id", s, &s_uri_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":s_uri", s) ) ) return rc;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_blank_id(stmt, db_ctx->digest, ":s_blank_id", s, &s_blank_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_blank(stmt, ":s_blank", s) ) ) return rc;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_uri_id(stmt, db_ctx->digest, ":p_uri_id", p, &p_uri_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":p_uri", p) ) ) return rc;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_uri_id(stmt, db_ctx->digest, ":o_uri_id", o, &o_uri_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":o_uri", o) ) ) return rc;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_blank_id(stmt, db_ctx->digest, ":o_blank_id", o, &o_blank_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_blank(stmt, ":o_blank", o) ) ) return rc;
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_lit_id(stmt, db_ctx->digest, ":o_lit_id", o, &o_lit_id)) ) ) return rc;
+    if( LIBRDF_NODE_TYPE_LITERAL == node_type(o) ) {
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_uri_id(stmt, db_ctx->digest, ":o_datatype_id", librdf_node_get_literal_value_datatype_uri(o), &o_type_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_uri( stmt, ":o_datatype", librdf_node_get_literal_value_datatype_uri(o) ) ) ) return rc;
+        char *l = librdf_node_get_literal_value_language(o);
+        if( l )
+            if( SQLITE_OK != ( rc = bind_text( stmt, ":o_language", (unsigned char *)l, strlen(l) ) ) ) return rc;
+        size_t len = 0;
+        const unsigned char *str = librdf_node_get_literal_value_as_counted_string(o, &len);
+        assert(strlen( (char *)str ) == len && "TODO: NUL terminate or limit length!");
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_text", str, len) ) ) return rc;
+    }
+
+    if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_node_uri_id(stmt, db_ctx->digest, ":c_uri_id", context_node, &c_uri_id)) ) ) return rc;
+    if( SQLITE_OK != ( rc = bind_node_uri(stmt, ":c_uri", context_node) ) ) return rc;
+
+    if( !statement || !librdf_statement_is_complete(statement) )
+        return SQLITE_OK;
+
+    const hash_t stmt_id = hash_combine_stmt(s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id);
+
+    assert(stmt_hash(statement, context_node, db_ctx->digest) == stmt_id && "statement hash computation mismatch");
+    if( SQLITE_OK != ( rc = bind_int(stmt, ":stmt_id", stmt_id) ) ) return rc;
+
+    return SQLITE_OK;
+}
+
+
+static sqlite_rc_t bind_counted_id(sqlite3_stmt *stmt, librdf_digest *digest, const char *name, const unsigned char *str, const size_t len, hash_t *value)
+{
+    if( str ) {
+        const hash_t v = hash_counted_string(str, len, digest);
+        if( value ) *value = v;
+        return bind_int(stmt, name, v);
+    }
+    return bind_null(stmt, name);
+}
+
+
+static inline const unsigned char *raptor_term_uri(raptor_term *term, size_t *len)
+{
+    if( NULL == term || RAPTOR_TERM_TYPE_URI != term->type )
+        return NULL;
+    return raptor_uri_as_counted_string(term->value.uri, len);
+}
+
+
+static inline const unsigned char *raptor_term_blank(raptor_term *term, size_t *len)
+{
+    if( NULL == term || RAPTOR_TERM_TYPE_BLANK != term->type )
+        return NULL;
+    *len = term->value.blank.string_len;
+    return term->value.blank.string;
+}
+
+
+/** Same as bind_stmt, but straight from the parser's terms without librdf_node detour.
+ *
+ * Must produce the very same ids.
+ */
+static sqlite_rc_t bind_raptor_stmt(instance_t *db_ctx, raptor_statement *statement, sqlite3_stmt *stmt)
+{
+    TIMER_DECL;
+    librdf_digest *digest = db_ctx->digest;
+    raptor_term *s = statement->subject;
+    raptor_term *p = statement->predicate;
+    raptor_term *o = statement->object;
+    raptor_term *c = statement->graph;
+
+    sqlite_rc_t rc = SQLITE_OK;
+    hash_t s_uri_id = NULL_ID;
+    hash_t s_blank_id = NULL_ID;
+    hash_t p_uri_id = NULL_ID;
+    hash_t o_uri_id = NULL_ID;
+    hash_t o_blank_id = NULL_ID;
+    hash_t o_lit_id = NULL_ID;
+    hash_t c_uri_id = NULL_ID;
+    {
+        size_t len = 0;
+        const unsigned char *str = raptor_term_uri(s, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":s_uri_id", str, len, &s_uri_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":s_uri", str, len) ) ) return rc;
+        str = raptor_term_blank(s, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":s_blank_id", str, len, &s_blank_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":s_blank", str, len) ) ) return rc;
+    }
+    {
+        size_t len = 0;
+        const unsigned char *str = raptor_term_uri(p, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":p_uri_id", str, len, &p_uri_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":p_uri", str, len) ) ) return rc;
+    }
+    {
+        size_t len = 0;
+        const unsigned char *str = raptor_term_uri(o, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":o_uri_id", str, len, &o_uri_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_uri", str, len) ) ) return rc;
+        str = raptor_term_blank(o, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":o_blank_id", str, len, &o_blank_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_blank", str, len) ) ) return rc;
+    }
+    if( o && RAPTOR_TERM_TYPE_LITERAL == o->type ) {
+        const raptor_term_literal_value *lit = &(o->value.literal);
+        const unsigned char *str = lit->string ? lit->string : (const unsigned char *)"";
+        const size_t len = lit->string ? lit->string_len : 0;
+        size_t datatype_len = 0;
+        const unsigned char *datatype = lit->datatype ? raptor_uri_as_counted_string(lit->datatype, &datatype_len) : NULL;
+        TIMER_START();
+        o_lit_id = hash_literal_parts(str, len, datatype, datatype_len, lit->language, lit->language ? lit->language_len : 0, digest);
+        TIMER_STOP(db_ctx, HASH);
+        if( SQLITE_OK != ( rc = bind_int(stmt, ":o_lit_id", o_lit_id) ) ) return rc;
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":o_datatype_id", datatype, datatype_len, NULL)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_datatype", datatype, datatype_len) ) ) return rc;
+        if( lit->language )
+            if( SQLITE_OK != ( rc = bind_text(stmt, ":o_language", lit->language, lit->language_len) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":o_text", str, len) ) ) return rc;
+    }
+    {
+        // N-Quads graph name, blank graphs go into the default graph
+        size_t len = 0;
+        const unsigned char *str = raptor_term_uri(c, &len);
+        if( SQLITE_OK != ( rc = TIMED(db_ctx, HASH, bind_counted_id(stmt, digest, ":c_uri_id", str, len, &c_uri_id)) ) ) return rc;
+        if( SQLITE_OK != ( rc = bind_text(stmt, ":c_uri", str, len) ) ) return rc;
+    }
+    if( ( isNULL_ID(s_uri_id) && isNULL_ID(s_blank_id) ) || isNULL_ID(p_uri_id) || ( isNULL_ID(o_uri_id) && isNULL_ID(o_blank_id) && isNULL_ID(o_lit_id) ) )
+        return SQLITE_MISMATCH;
+
+    const hash_t stmt_id = hash_combine_stmt(s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id);
+    return bind_int(stmt, ":stmt_id", stmt_id);
+}
+
+
+static inline const str_uri_t column_uri_string(sqlite3_stmt *stmt, const int iCol)
+{
+    return (str_uri_t)sqlite3_column_text(stmt, iCol);
+}
+
+
+static inline const str_blank_t column_blank_string(sqlite3_stmt *stmt, const int iCol)
+{
+    return (str_blank_t)sqlite3_column_text(stmt, iCol);
+}
+
+
+static inline const str_lang_t column_language(sqlite3_stmt *stmt, const int iCol)
+{
+    return (str_lang_t)sqlite3_column_text(stmt, iCol);
+}
+
+
+static inline sqlite_rc_t savepoint_step(instance_t *db_ctx, sqlite3_stmt **stmt_p, const char *sql)
+{
+    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, stmt_p, sql) );
+    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+}
+
+
+/** Whether the planner lacks statistics for triple_relations or changes piled up since the last ANALYZE. */
+static bool stats_stale(instance_t *db_ctx)
+{
+    const sqlite3_int64 changes = sqlite3_total_changes(db_ctx->db) - db_ctx->analyzed_changes;
+    if( changes >= (sqlite3_int64)( db_ctx->analyze_after > 0 ? db_ctx->analyze_after : ANALYZE_AFTER ) )
+        return true;
+    const bool analyzed = 0 < query_int(db_ctx->db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'sqlite_stat1'")
+                          && 0 < query_int(db_ctx->db, "SELECT COUNT(*) FROM sqlite_stat1 WHERE tbl = 'triple_relations'");
+    return !analyzed && 0 < query_int(db_ctx->db, "SELECT COUNT(*) FROM (SELECT 1 FROM triple_relations LIMIT 1)");
+}
+
+
+/** ANALYZE within analysis_limit, e.g. so (?s rdf:type C) uses the o_uri_id index rather than the p_uri_id one. */
+static sqlite_rc_t stats_analyze(instance_t *db_ctx)
+{
+    const char sql[] = "PRAGMA analysis_limit = " ANALYSIS_LIMIT "; ANALYZE;";
+    const sqlite_rc_t rc = log_error( db_ctx->db, sql, exec_stmt(db_ctx->db, sql) );
+    if( SQLITE_OK == rc )
+        db_ctx->analyzed_changes = sqlite3_total_changes(db_ctx->db);
+    return rc;
+}
+
+
+/** ANALYZE after option analyze_after changes, after bulk loads also if there are no statistics yet.
+ *
+ * Waits for the outermost commit and the open iterators. Failure just leaves the statistics as they are.
+ */
+static void stats_maintain(instance_t *db_ctx, const bool bulk)
+{
+    if( 0 == db_ctx->analyze_after || db_ctx->read_only || db_ctx->in_transaction || db_ctx->iterators > 0 )
+        return;
+    const sqlite3_int64 changes = sqlite3_total_changes(db_ctx->db) - db_ctx->analyzed_changes;
+    if( changes >= (sqlite3_int64)db_ctx->analyze_after || ( bulk && changes > 0 && stats_stale(db_ctx) ) )
+        stats_analyze(db_ctx);
+}
+
+
+/** Start a transaction or, if already within one, a nested SAVEPOINT.
+ *
+ * Savepoints all have the same name and so are strictly LIFO, which the
+ * transaction_start / _commit / _rollback pairs in this file are anyway.
+ */
+static sqlite_rc_t transaction_start(librdf_storage *storage)
+{
+    instance_t *db_ctx = get_instance(storage);
+    if( db_ctx->in_transaction ) {
+        const sqlite_rc_t rc = savepoint_step(db_ctx, &(db_ctx->stmt_savepoint_start), "SAVEPOINT mro");
+        if( SQLITE_OK == rc )
+            db_ctx->savepoint_depth++;
+        return rc;
+    }
+    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_start), "BEGIN IMMEDIATE TRANSACTION") );
+    db_ctx->in_transaction = SQLITE_DONE == rc;
+    assert(false != db_ctx->in_transaction && "transaction was not properly started");
+    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+}
+
+
+static sqlite_rc_t transaction_commit(librdf_storage *storage, const sqlite_rc_t begin)
+{
+    if( begin != SQLITE_OK )
+        return SQLITE_OK;
+    instance_t *db_ctx = get_instance(storage);
+    if( false == db_ctx->in_transaction )
+        return SQLITE_MISUSE;
+    if( db_ctx->savepoint_depth > 0 ) {
+        const sqlite_rc_t rc = savepoint_step(db_ctx, &(db_ctx->stmt_savepoint_release), "RELEASE mro");
+        if( SQLITE_OK == rc )
+            db_ctx->savepoint_depth--;
+        return rc;
+    }
+    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_commit), "COMMIT  TRANSACTION") );
+    db_ctx->in_transaction = !(SQLITE_DONE == rc);
+    assert(false == db_ctx->in_transaction && "transaction was not properly committed");
+    if( SQLITE_DONE == rc )
+        stats_maintain(db_ctx, false);
+    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+}
+
+
+static sqlite_rc_t transaction_rollback(librdf_storage *storage, const sqlite_rc_t begin)
+{
+    if( SQLITE_OK != begin )
+        return SQLITE_OK;
+    instance_t *db_ctx = get_instance(storage);
+    if( false == db_ctx->in_transaction )
+        return SQLITE_MISUSE;
+    if( db_ctx->savepoint_depth > 0 ) {
+        // ROLLBACK TO keeps the savepoint on the stack, so release it afterwards
+        sqlite_rc_t rc = savepoint_step(db_ctx, &(db_ctx->stmt_savepoint_rollback), "ROLLBACK TO mro");
+        if( SQLITE_OK == rc )
+            rc = savepoint_step(db_ctx, &(db_ctx->stmt_savepoint_release), "RELEASE mro");
+        if( SQLITE_OK == rc )
+            db_ctx->savepoint_depth--;
+        return rc;
+    }
+    const sqlite_rc_t rc = sqlite3_step( prep_stmt(db_ctx->db, &(db_ctx->stmt_txn_rollback), "ROLLBACK TRANSACTION") );
+    db_ctx->in_transaction = !(SQLITE_DONE == rc);
+    assert(false == db_ctx->in_transaction && "transaction was not properly rolled back");
+    return SQLITE_DONE == rc ? SQLITE_OK : rc;
+}
+
+
+#pragma mark Tuning
+
+
+static const tuning_profile_t *tuning_profile_named(const char *name)
+{
+    if( NULL == name )
+        return NULL;
+    for( const tuning_profile_t *p = tuning_profiles; p->name; p++ )
+        if( 0 == strcmp(name, p->name) )
+            return p;
+    return NULL;
+}
+
+
+static int tuning_pragma_for_feature(const char *feat)
+{
+    for( int i = 0; i < PRAGMA_COUNT; i++ )
+        if( 0 == strcmp( (char *)*(tuning_pragmas[i].feature), feat ) )
+            return i;
+    return -1;
+}
+
+
+/** PRAGMA values can't be bound, so check them before they go into the SQL. */
+static bool tuning_value_valid(const tuning_pragma_t pragma, const char *value)
+{
+    if( NULL == value || '\0' == value[0] )
+        return false;
+    const char *const *kw = tuning_pragmas[pragma].keywords;
+    if( kw ) {
+        for( int i = 0; kw[i]; i++ )
+            if( 0 == strcmp(kw[i], value) )
+                return true;
+        return false;
+    }
+    char *end = NULL;
+    errno = 0;
+    strtoll(value, &end, 10);
+    return 0 == errno && '\0' == *end;
+}
+
+
+static const char *tuning_value(const instance_t *db_ctx, const tuning_pragma_t pragma)
+{
+    if( db_ctx->tuning_override[pragma] )
+        return db_ctx->tuning_override[pragma];
+    return db_ctx->tuning ? db_ctx->tuning->values[pragma] : NULL;
+}
+
+
+static sqlite_rc_t tuning_apply_pragma(instance_t *db_ctx, const tuning_pragma_t pragma)
+{
+    const char *value = tuning_value(db_ctx, pragma);
+    if( NULL == value )
+        return SQLITE_OK;
+    assert(tuning_value_valid(pragma, value) && "invalid value slipped through");
+    char sql[100];
+    const size_t len = snprintf(sql, sizeof(sql) - 1, "PRAGMA %s=%s;", tuning_pragmas[pragma].name, value);
+    assert(len < sizeof(sql) && "buffer too small.");
+    sqlite_rc_t rc = log_error( db_ctx->db, sql, exec_stmt(db_ctx->db, sql) );
+    if( SQLITE_OK == rc && PRAGMA_LOCKING_MODE == pragma )
+        // leaving exclusive mode releases the lock on the next access only
+        rc = log_error( db_ctx->db, sql, exec_stmt(db_ctx->db, "SELECT COUNT(*) FROM sqlite_master;") );
+    return rc;
+}
+
+
+/** (Re-)apply tuning profile and overrides. Refused within a transaction, journal_mode can't change there.
+ */
+static sqlite_rc_t tuning_apply(instance_t *db_ctx)
+{
+    if( NULL == db_ctx->db )
+        return SQLITE_OK;
+    if( db_ctx->in_transaction )
+        return SQLITE_MISUSE;
+    for( int i = 0; i < PRAGMA_COUNT; i++ ) {
+        const sqlite_rc_t rc = tuning_apply_pragma(db_ctx, i);
+        if( SQLITE_OK != rc )
+            return rc;
+    }
+    return SQLITE_OK;
+}
+
+
+/** Value as reported by SQLite or, if not open yet, as configured.
+ */
+static bool tuning_effective_value(instance_t *db_ctx, const tuning_pragma_t pragma, char *buf, const size_t siz)
+{
+    assert(buf && siz && "buffer must be set.");
+    buf[0] = '\0';
+    if( NULL == db_ctx->db ) {
+        const char *value = tuning_value(db_ctx, pragma);
+        if( NULL == value )
+            return false;
+        strncpy(buf, value, siz - 1);
+        buf[siz - 1] = '\0';
+        return true;
+    }
+    char sql[100];
+    const size_t len = snprintf(sql, sizeof(sql) - 1, "PRAGMA %s;", tuning_pragmas[pragma].name);
+    assert(len < sizeof(sql) && "buffer too small.");
+    sqlite3_stmt *stmt = NULL;
+    if( SQLITE_OK != log_error( db_ctx->db, sql, sqlite3_prepare_v2(db_ctx->db, sql, -1, &stmt, NULL) ) )
+        return false;
+    const bool ret = SQLITE_ROW == sqlite3_step(stmt) && NULL != sqlite3_column_text(stmt, 0);
+    if( ret ) {
+        strncpy( buf, (const char *)sqlite3_column_text(stmt, 0), siz - 1 );
+        buf[siz - 1] = '\0';
+    }
+    sqlite3_finalize(stmt);
+    return ret;
+}
+
+
+#pragma mark -
+
+
+#pragma mark Internal Implementation
+
+
+/** insert_triple_sql + find_triples_sql
+ */
+typedef enum {
+    IDX_ID = 0,
+    IDX_S_URI_ID,
+    IDX_S_BLANK_ID,
+    IDX_P_URI_ID,
+    IDX_O_URI_ID,
+    IDX_O_BLANK_ID,
+    IDX_O_LIT_ID,
+    IDX_O_DATATYPE_ID,
+    IDX_C_URI_ID,
+    IDX_S_URI,
+    IDX_S_BLANK,
+    IDX_P_URI,
+    IDX_O_URI,
+    IDX_O_BLANK,
+    IDX_O_TEXT,
+    IDX_O_LANGUAGE,
+    IDX_O_DATATYPE,
+    IDX_C_URI
+}
+idx_triple_column_t;
+
+
+static const char insert_triple_sql[] = // generated via tools/sql2c.sh insert_triple.sql
+    "INSERT OR IGNORE INTO triples(" "\n" \
+    "  id," "\n" \
+    "  s_uri_id, s_uri," "\n" \
+    "  s_blank_id, s_blank," "\n" \
+    "  p_uri_id, p_uri," "\n" \
+    "  o_uri_id, o_uri," "\n" \
+    "  o_blank_id, o_blank," "\n" \
+    "  o_lit_id, o_datatype_id, o_datatype, o_language, o_text," "\n" \
+    "  c_uri_id, c_uri" "\n" \
+    ") VALUES (" "\n" \
+    "  :stmt_id," "\n" \
+    "  :s_uri_id, :s_uri," "\n" \
+    "  :s_blank_id, :s_blank," "\n" \
+    "  :p_uri_id, :p_uri," "\n" \
+    "  :o_uri_id, :o_uri," "\n" \
+    "  :o_blank_id, :o_blank," "\n" \
+    "  :o_lit_id, :o_datatype_id, :o_datatype, :o_language, :o_text," "\n" \
+    "  :c_uri_id, :c_uri" "\n" \
+    ")" "\n" \
+;
+
+
+/** Step a prepared insert_triple_sql and count whether the triple was new.
+ *
+ * sqlite3_changes() stays 0 for the view as the rows are inserted by the INSTEAD OF trigger,
+ * but sqlite3_total_changes() includes them. If the triple already exists, so do all its terms,
+ * so any change at all means a new triple.
+ */
+static sqlite_rc_t step_insert(instance_t *db_ctx, sqlite3_stmt *stmt)
+{
+    TIMER_DECL;
+    const int before = sqlite3_total_changes(db_ctx->db);
+    const sqlite_rc_t rc = TIMED(db_ctx, STEP_INSERT, sqlite3_step(stmt) );
+    if( SQLITE_DONE != rc ) {
+        // clear the error right away, so the cached statement can be re-used (e.g. retried)
+        sqlite3_reset(stmt);
+        return rc;
+    }
+    if( before != sqlite3_total_changes(db_ctx->db) )
+        db_ctx->count_inserted++;
+    else
+        db_ctx->count_ignored++;
+    return rc;
+}
+
+
+static librdf_statement *find_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement, const bool create)
+{
+    assert(statement && "statement must be set.");
+    assert(librdf_statement_is_complete(statement) && "statement must be complete.");
+
+    instance_t *db_ctx = get_instance(storage);
+    TIMER_DECL;
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+
+    if( !create ) {
+        TIMER_START();
+        const hash_t stmt_id = stmt_hash(statement, context_node, db_ctx->digest);
+        TIMER_STOP(db_ctx, HASH);
+        assert(!isNULL_ID(stmt_id) && "mustn't be nil");
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_HASH);
+
+        const bool cached = NULL != db_ctx->stmt_triple_find;
+        sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_find), "SELECT id FROM triple_relations WHERE id = :stmt_id");
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+
+        if( SQLITE_OK != bind_int(stmt, ":stmt_id", stmt_id) )
+            return NULL;
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+        const bool found = SQLITE_ROW == TIMED(db_ctx, STEP_CONTAINS, sqlite3_step(stmt) );
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+        span_record(storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_CONTAINS, -1, found, statement, context_node, cached);
+        return found ? statement : NULL;
+    }
+
+    const bool cached = NULL != db_ctx->stmt_triple_insert;
+    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_insert), insert_triple_sql);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+    if( SQLITE_OK != TIMED(db_ctx, BIND, bind_stmt(db_ctx, statement, context_node, stmt) ) )
+        return NULL;
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+    if( db_ctx->do_explain_query_plan )
+        printExplainQueryPlan(stmt);
+    const sqlite_rc_t rc = step_insert(db_ctx, stmt);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    span_record(storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_ADD, -1, SQLITE_DONE == rc, statement, context_node, cached);
+    return SQLITE_DONE == rc ? statement : NULL;
+}
+
+
+static inline bool find_stmt_cacheable(const instance_t *db_ctx, const sql_find_param_t params)
+{
+    return 0 != db_ctx->sql_cache_mask && params == (params & db_ctx->sql_cache_mask);
+}
+
+
+/** Take the compiled find statement of the shape out of the cache, NULL if none. */
+static sqlite3_stmt *find_stmt_take(instance_t *db_ctx, const sql_find_param_t params)
+{
+    sqlite3_stmt *stmt = db_ctx->stmt_find[params];
+    if( stmt )
+        db_ctx->stmt_find_count--;
+    db_ctx->stmt_find[params] = NULL;
+    return stmt;
+}
+
+
+/** Put a find statement back into the cache, finalize if not cacheable, the cache is full or the slot is taken by a concurrent find. */
+static void find_stmt_release(instance_t *db_ctx, const sql_find_param_t params, sqlite3_stmt *stmt)
+{
+    if( !stmt )
+        return;
+    if( db_ctx->db && !db_ctx->stmt_find[params] && db_ctx->stmt_find_count < db_ctx->stmt_find_max
+        && find_stmt_cacheable(db_ctx, params) && SQLITE_OK == sqlite3_reset(stmt) ) {
+        sqlite3_clear_bindings(stmt);
+        db_ctx->stmt_find[params] = stmt;
+        db_ctx->stmt_find_count++;
+        return;
+    }
+    sqlite3_finalize(stmt);
+}
+
+
+/** Finalize the cached find statements not in the sql_cache_mask (all if 0), all if everything is true. */
+static void find_stmt_cache_trim(instance_t *db_ctx, const bool everything)
+{
+    for( int params = 0; params < (int)array_length(db_ctx->stmt_find); params++ )
+        if( everything || !find_stmt_cacheable(db_ctx, params) )
+            sqlite3_finalize( find_stmt_take(db_ctx, params) );
+}
+
+
+/** Set uri_prefixes and compact_literals from the optional schema parts present. The store decides, not the options. */
+static void schema_detect(instance_t *db_ctx)
+{
+    const char *const tables[] = {
+        "ns_uris", "o_bodies"
+    };
+    bool *flags[] = {
+        &(db_ctx->uri_prefixes), &(db_ctx->compact_literals)
+    };
+    sqlite3_stmt *stmt = NULL;
+    prep_stmt(db_ctx->db, &stmt, "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = :name");
+    for( int i = 0; i < (int)array_length(tables); i++ ) {
+        sqlite3_bind_text(stmt, 1, tables[i], -1, SQLITE_STATIC);
+        *(flags[i]) = SQLITE_ROW == sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+}
+
+
+/** Log and refuse a write on a store opened with mode='ro' or immutable='yes'. */
+static bool read_only_refused(librdf_storage *storage, const char *op)
+{
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->read_only )
+        return false;
+    librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "%s refused, %s is read only", op, db_ctx->name);
+    return true;
+}
+
+
+/** SQLite URI filename for read only access, https://sqlite.org/uri.html
+ *
+ * Return value: string to free with LIBRDF_FREE or NULL.
+ */
+static char *read_only_uri(const char *path, const bool immutable)
+{
+    const char prefix[] = "file:";
+    const char query[] = "?mode=ro&immutable=1";
+    char *ret = LIBRDF_MALLOC( char *, sizeof(prefix) + 3 * strlen(path) + sizeof(query) );
+    if( !ret )
+        return NULL;
+    char *dst = ret + snprintf(ret, sizeof(prefix), "%s", prefix);
+    for( const char *src = path; *src; src++ ) {
+        // escape what would end or break the path part
+        if( '%' == *src || '?' == *src || '#' == *src )
+            dst += sprintf(dst, "%%%02X", (unsigned char)*src);
+        else
+            *dst++ = *src;
+    }
+    // immutable=1 spares the locking and change detection, mode=ro alone still sees other writers.
+    const size_t query_len = immutable ? sizeof(query) - 1 : strlen("?mode=ro");
+    memcpy(dst, query, query_len);
+    dst[query_len] = '\0';
+    return ret;
+}
+
+
+/** SQL function mro_hash(text), the content hash keying o_bodies, see option compact_literals. */
+static void sql_fn_hash(sqlite3_context *ctx, int argc, sqlite3_value **argv)
+{
+    assert(1 == argc && "one argument");
+    instance_t *db_ctx = (instance_t *)sqlite3_user_data(ctx);
+    const unsigned char *text = sqlite3_value_text(argv[0]);
+    if( !text ) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    sqlite3_result_int64( ctx, (sqlite3_int64)hash_counted_string( text, sqlite3_value_bytes(argv[0]), db_ctx->digest ) );
+}
+
+
+#pragma mark Warm-up
+
+
+#define WARM_UP_BUSY_MS 1000
+#define WARM_UP_CHECK_ROWS 64 // rows stepped between budget checks
+
+/** What finds touch first: the triple_relations indexes, then the term tables (hashes are their rowids). */
+static const char warm_up_objects_sql[] =
+    "SELECT tbl_name, name, 'index' = type FROM sqlite_master"
+    " WHERE ( type = 'index' AND name LIKE 'triple\\_relations\\_index\\_%' ESCAPE '\\' )"
+    " OR ( type = 'table' AND name IN ('p_uris', 't_uris', 'c_uris', 'ns_uris', 'o_languages', 'so_uris', 'so_blanks', 'o_literals', 'o_literal_rows') )"
+    " ORDER BY 'table' = type, name";
+
+
+/** Bytes the connection read so far. mmap_size is 0, so every page read is a cache miss. */
+static sqlite3_int64 warm_up_bytes(sqlite3 *db, const sqlite3_int64 page_size)
+{
+    int cur = 0;
+    int hi = 0;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_MISS, &cur, &hi, 0);
+    return page_size * cur;
+}
+
+
+/** Ask the OS to read ahead the first budget bytes of the file. A hint only, hence no error. */
+static void warm_up_advise(const char *path, const sqlite3_int64 budget)
+{
+    const int fd = open(path, O_RDONLY);
+    if( fd < 0 )
+        return;
+    struct stat st;
+    if( 0 == fstat(fd, &st) && st.st_size > 0 ) {
+        const size_t len = (size_t)( budget > 0 && budget < st.st_size ? budget : st.st_size );
+        void *p = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+        if( MAP_FAILED != p ) {
+            posix_madvise(p, len, POSIX_MADV_WILLNEED);
+            munmap(p, len);
+        }
+    }
+    close(fd);
+}
+
+
+static inline bool warm_up_cancelled(warm_up_t *w)
+{
+    return 0 != __atomic_load_n(&w->cancel, __ATOMIC_ACQUIRE);
+}
+
+
+/** Scan the objects of warm_up_objects_sql in order until the budget is spent or cancelled. */
+static void warm_up_run(warm_up_t *w)
+{
+    if( !warm_up_cancelled(w) && (w->flags & LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_MADVISE) )
+        warm_up_advise(w->path, w->budget);
+    const sqlite3_int64 page_size = warm_up_cancelled(w) ? 0 : query_int(w->db, "PRAGMA page_size");
+    sqlite3_stmt *objects = NULL;
+    sqlite_rc_t rc = warm_up_cancelled(w) ? SQLITE_INTERRUPT : log_error( w->db, warm_up_objects_sql, sqlite3_prepare_v2(w->db, warm_up_objects_sql, -1, &objects, NULL) );
+    bool spent = false;
+    while( SQLITE_OK == rc && !spent ) {
+        if( warm_up_cancelled(w) )
+            rc = SQLITE_INTERRUPT;
+        else if( SQLITE_ROW == ( rc = sqlite3_step(objects) ) )
+            rc = SQLITE_OK;
+        if( SQLITE_OK != rc )
+            break;
+        // covering index scan resp. table scan, reads every b-tree page but no overflow pages
+        char *sql = sqlite3_column_int(objects, 2)
+                    ? sqlite3_mprintf("SELECT 1 FROM \"%w\" INDEXED BY \"%w\"", sqlite3_column_text(objects, 0), sqlite3_column_text(objects, 1))
+                    : sqlite3_mprintf("SELECT 1 FROM \"%w\" NOT INDEXED", sqlite3_column_text(objects, 0));
+        sqlite3_stmt *scan = NULL;
+        if( !sql )
+            rc = SQLITE_NOMEM;
+        else if( SQLITE_OK == ( rc = log_error( w->db, sql, sqlite3_prepare_v2(w->db, sql, -1, &scan, NULL) ) ) ) {
+            for( sqlite3_uint64 rows = 0; SQLITE_ROW == ( rc = sqlite3_step(scan) ); rows++ ) {
+                if( 0 != rows % WARM_UP_CHECK_ROWS )
+                    continue;
+                if( warm_up_cancelled(w) ) {
+                    rc = SQLITE_INTERRUPT;
+                    break;
+                }
+                if( w->budget > 0 && warm_up_bytes(w->db, page_size) >= w->budget ) {
+                    spent = true;
+                    break;
+                }
+            }
+            if( SQLITE_ROW == rc || SQLITE_DONE == rc )
+                rc = SQLITE_OK;
+        }
+        sqlite3_finalize(scan);
+        sqlite3_free(sql);
+    }
+    sqlite3_finalize(objects);
+    w->rc = SQLITE_DONE == rc ? SQLITE_OK : rc;
+    w->bytes = warm_up_bytes(w->db, page_size);
+    if( w->done )
+        w->done(w->user_data, w->bytes, w->rc);
+}
+
+
+static void *warm_up_thread(void *arg)
+{
+    warm_up_run( (warm_up_t *)arg );
+    return NULL;
+}
+
+
+/** Wait for a background run to finish, or stop it early if cancel. Returns its result code. */
+static sqlite_rc_t warm_up_join(instance_t *db_ctx, const bool cancel, sqlite3_int64 *bytes)
+{
+    warm_up_t *w = db_ctx->warm_up;
+    if( bytes )
+        *bytes = 0;
+    if( !w )
+        return SQLITE_OK;
+    if( cancel ) {
+        __atomic_store_n(&w->cancel, 1, __ATOMIC_RELEASE);
+        sqlite3_interrupt(w->db); // a running step stops right away
+    }
+    pthread_join(w->thread, NULL);
+    const sqlite_rc_t rc = w->rc;
+    if( bytes )
+        *bytes = w->bytes;
+    sqlite3_close(w->db);
+    LIBRDF_FREE(warm_up_t *, w);
+    db_ctx->warm_up = NULL;
+    return rc;
+}
+
+
+/** Read what finds need first through an own read only connection, so the OS page cache (and mmap) has it.
+ *
+ * Queries on the storage's connection are served meanwhile, in the background case from other threads, too.
+ * Runs one at a time, waits for a previous background one.
+ */
+static sqlite_rc_t warm_up_start(librdf_storage *storage, const sqlite3_int64 budget, const int flags, librdf_storage_sqlite_mro_warm_up_done done, void *user_data)
+{
+    instance_t *db_ctx = get_instance(storage);
+    warm_up_join(db_ctx, false, NULL);
+    if( db_ctx->memory ) {
+        // nothing on disk
+        if( done )
+            done(user_data, 0, SQLITE_OK);
+        return SQLITE_OK;
+    }
+    warm_up_t *w = LIBRDF_CALLOC(warm_up_t *, sizeof(warm_up_t), 1);
+    if( !w )
+        return SQLITE_NOMEM;
+    w->path = db_ctx->name;
+    w->budget = budget;
+    w->flags = flags;
+    w->done = done;
+    w->user_data = user_data;
+    sqlite_rc_t rc = SQLITE_NOMEM;
+    char *uri = read_only_uri(db_ctx->name, db_ctx->immutable);
+    if( uri )
+        rc = sqlite3_open_v2(uri, &w->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, NULL);
+    LIBRDF_FREE(char *, uri);
+    if( SQLITE_OK == rc ) {
+        sqlite3_busy_timeout(w->db, WARM_UP_BUSY_MS);
+        rc = exec_stmt(w->db, "PRAGMA mmap_size = 0;");
+    }
+    if( SQLITE_OK != rc ) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "warm-up of %s failed - %s", db_ctx->name, sqlite3_errstr(rc));
+        sqlite3_close(w->db);
+        LIBRDF_FREE(warm_up_t *, w);
+        return rc;
+    }
+    if( flags & LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_BACKGROUND )
+        w->threaded = 0 == pthread_create(&w->thread, NULL, &warm_up_thread, w);
+    if( w->threaded ) {
+        db_ctx->warm_up = w;
+        return SQLITE_OK;
+    }
+    warm_up_run(w);
+    rc = w->rc;
+    sqlite3_close(w->db);
+    LIBRDF_FREE(warm_up_t *, w);
+    return rc;
+}
+
+
+#pragma mark -
+
+#pragma mark Public Interface
+
+
+int librdf_storage_set_feature_mro_bool(librdf_storage *storage, const unsigned char *feature, const bool value)
+{
+    assert(storage && "storage must be set.");
+    assert(feature && "feature must be set.");
+    librdf_world *world = librdf_storage_get_world(storage);
+    assert(world && "world must be set.");
+
+    librdf_uri *uri_xsd_boolean = librdf_new_uri(world, (str_uri_t)LIBRDF_NAMESPACE_XSD "boolean");
+    assert(uri_xsd_boolean && "uri_xsd_boolean must be set.");
+    librdf_uri *uri_f = librdf_new_uri(world, feature);
+    assert(uri_f && "uri_f must be set.");
+    const str_lit_val_t v = (str_lit_val_t)(value ? "true" : "false");
+    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "librdf_storage_set_feature_mro_bool sets '%s'", v);
+    librdf_node *n = librdf_new_node_from_typed_literal(world, v, NULL, uri_xsd_boolean);
+
+    const int ret = librdf_storage_set_feature(storage, uri_f, n);
+
+    librdf_free_node(n);
+    librdf_free_uri(uri_f);
+    librdf_free_uri(uri_xsd_boolean);
+
+    return ret;
+}
+
+
+int librdf_storage_set_feature_mro_int(librdf_storage *storage, const unsigned char *feature, const int value)
+{
+    assert(storage && "storage must be set.");
+    assert(feature && "feature must be set.");
+    librdf_world *world = librdf_storage_get_world(storage);
+    assert(world && "world must be set.");
+
+    librdf_uri *uri_xsd_integer = librdf_new_uri(world, (str_uri_t)LIBRDF_NAMESPACE_XSD "integer");
+    assert(uri_xsd_integer && "uri_xsd_integer must be set.");
+    librdf_uri *uri_f = librdf_new_uri(world, feature);
+    assert(uri_f && "uri_f must be set.");
+    char v[20];
+    snprintf(v, sizeof(v), "%d", value);
+    librdf_node *n = librdf_new_node_from_typed_literal(world, (str_lit_val_t)v, NULL, uri_xsd_integer);
+
+    const int ret = librdf_storage_set_feature(storage, uri_f, n);
+
+    librdf_free_node(n);
+    librdf_free_uri(uri_f);
+    librdf_free_uri(uri_xsd_integer);
+
+    return ret;
+}
+
+
+int librdf_storage_get_feature_mro_bool(librdf_storage *storage, const unsigned char *feature, bool *value)
+{
+    assert(storage && "storage must be set.");
+    assert(feature && "feature must be set.");
+    librdf_world *world = librdf_storage_get_world(storage);
+    assert(world && "world must be set.");
+
+    librdf_uri *uri_f = librdf_new_uri(world, feature);
+    int err = RET_OK;
+    bool ret = false;
+    if( uri_f ) {
+        librdf_node *node = librdf_storage_get_feature(storage, uri_f);
+        if( node ) {
+            if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
+                size_t len = 0;
+                const char *v = (char *)librdf_node_get_literal_value_as_counted_string(node, &len);
+                if( v ) {
+                    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "librdf_storage_get_feature_mro_bool return '%s'", v);
+                    if( 0 == strncmp("true", v, len) || 0 == strncmp("1", v, len) )
+                        ret = true;
+                    else if( 0 == strncmp("false", v, len) || 0 == strncmp("0", v, len) )
+                        ret = false;
+                    else
+                        err = 4;
+                } else
+                    err = 3;
+            } else
+                err = 2;
+            librdf_free_node(node);
+        } else
+            err = 1;
+        librdf_free_uri(uri_f);
+    }
+    if( value )
+        *value = ret;
+    return err;
+}
+
+
+int librdf_storage_get_feature_mro_int(librdf_storage *storage, const unsigned char *feature, int *value)
+{
+    assert(storage && "storage must be set.");
+    assert(feature && "feature must be set.");
+    librdf_world *world = librdf_storage_get_world(storage);
+    assert(world && "world must be set.");
+
+    librdf_uri *uri_f = librdf_new_uri(world, feature);
+    int err = RET_OK;
+    long ret = RET_OK;
+    if( uri_f ) {
+        librdf_node *node = librdf_storage_get_feature(storage, uri_f);
+        if( node ) {
+            if( LIBRDF_NODE_TYPE_LITERAL == node_type(node) ) {
+                size_t len = 0;
+                const char *str = (char *)librdf_node_get_literal_value_as_counted_string(node, &len);
+                if( str ) {
+                    assert(strlen(str) == len && "TODO: NUL terminate or limit length!");
+                    char *end = NULL;
+                    ret = strtol(str, &end, 10);
+                    if( '\0' != *end )
+                        err = 4;
+                } else
+                    err = 3;
+            } else
+                err = 2;
+            librdf_free_node(node);
+        } else
+            err = 1;
+        librdf_free_uri(uri_f);
+    }
+    if( value )
+        *value = ret;
+    return err;
+}
+
+
+#pragma mark Lifecycle & Housekeeping
+
+
+/** Create a new storage.
+ *
+ * Setup SQLIte connection instance but don't open yet.
+ */
+static int pub_init(librdf_storage *storage, const char *name, librdf_hash *options)
+{
+    if( !name ) {
+        free_hash(options);
+        return RET_ERROR;
+    }
+
+    instance_t *db_ctx = LIBRDF_CALLOC(instance_t *, sizeof(*db_ctx), 1);
+    if( !db_ctx ) {
+        free_hash(options);
+        return RET_ERROR;
+    }
+    // feature defaults
+    db_ctx->do_profile = false;
+    db_ctx->do_explain_query_plan = false;
+    db_ctx->sql_cache_mask = ALL_PARAMS;
+    db_ctx->stmt_find_max = array_length(db_ctx->stmt_find);
+    db_ctx->analyze_after = ANALYZE_AFTER;
+    db_ctx->slow_rate = 10;
+
+    librdf_storage_set_instance(storage, db_ctx);
+    if( RET_OK != pool_init(db_ctx, memory_config.pool_slots) ) {
+        free_hash(options);
+        return RET_ERROR;
+    }
+    const size_t name_len = strlen(name);
+    char *name_copy = LIBRDF_MALLOC(char *, name_len + 1);
+    if( !name_copy ) {
+        free_hash(options);
+        return RET_ERROR;
+    }
+
+    strncpy(name_copy, name, name_len + 1);
+    db_ctx->name = name_copy;
+
+    if( !( db_ctx->digest = librdf_new_digest(get_world(storage), "MD5") ) ) {
+        free_hash(options);
+        return RET_ERROR;
+    }
+
+    if( false != librdf_hash_get_as_boolean(options, "new") )
+        db_ctx->is_new = true;  /* default is NOT NEW */
+    if( 0 < librdf_hash_get_as_boolean(options, "uri_prefixes") )
+        db_ctx->uri_prefixes = true;
+    if( 0 < librdf_hash_get_as_boolean(options, "compact_literals") )
+        db_ctx->compact_literals = true;
+    if( 0 < librdf_hash_get_as_boolean(options, "warm_up_background") )
+        db_ctx->warm_up_flags |= LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_BACKGROUND;
+    if( 0 < librdf_hash_get_as_boolean(options, "warm_up_madvise") )
+        db_ctx->warm_up_flags |= LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_MADVISE;
+
+    char *mode = librdf_hash_get(options, "mode");
+    if( mode ) {
+        const bool valid = 0 == strcmp("ro", mode) || 0 == strcmp("rw", mode);
+        if( valid )
+            db_ctx->read_only = 0 == strcmp("ro", mode);
+        else
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "unknown mode='%s'", mode);
+        LIBRDF_FREE(char *, mode);
+        if( !valid ) {
+            free_hash(options);
+            return RET_ERROR;
+        }
+    }
+    if( 0 < librdf_hash_get_as_boolean(options, "immutable") )
+        db_ctx->read_only = db_ctx->immutable = true;
+    if( 0 < librdf_hash_get_as_boolean(options, "memory") || 0 == strcmp(":memory:", name) )
+        db_ctx->memory = true;
+    if( db_ctx->memory && db_ctx->read_only ) {
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "memory='yes' can't be read only");
+        free_hash(options);
+        return RET_ERROR;
+    }
+    if( db_ctx->read_only ) {
+        if( 0 < librdf_hash_get_as_boolean(options, "new") ) {
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "new='yes' can't be read only");
+            free_hash(options);
+            return RET_ERROR;
+        }
+        db_ctx->is_new = false; // never unlink a store opened for reading
+    }
+
+    /* Redland default is "PRAGMA synchronous normal" */
+    db_ctx->synchronous = SYNC_NORMAL;
+
+    char *synchronous = synchronous = librdf_hash_get(options, "synchronous");
+    if( synchronous ) {
+        for( int i = 0; synchronous_flags[i]; i++ ) {
+            if( !strcmp(synchronous, synchronous_flags[i]) ) {
+                db_ctx->synchronous = i;
+                break;
+            }
+        }
+        LIBRDF_FREE(char *, synchronous);
+    }
+
+    char *tuning = librdf_hash_get(options, "tuning");
+    if( tuning ) {
+        db_ctx->tuning = tuning_profile_named(tuning);
+        if( !db_ctx->tuning )
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "unknown tuning='%s'", tuning);
+        LIBRDF_FREE(char *, tuning);
+        if( !db_ctx->tuning ) {
+            free_hash(options);
+            return RET_ERROR;
+        }
+    }
+    char *batch_size = librdf_hash_get(options, "batch_size");
+    if( batch_size ) {
+        char *end = NULL;
+        const long long i = strtoll(batch_size, &end, 10);
+        const bool valid = '\0' == *end && 0 <= i;
+        if( valid )
+            db_ctx->batch_size = (size_t)i;
+        else
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid batch_size='%s'", batch_size);
+        LIBRDF_FREE(char *, batch_size);
+        if( !valid ) {
+            free_hash(options);
+            return RET_ERROR;
+        }
+    }
+
+    char *batch_policy = librdf_hash_get(options, "batch_policy");
+    if( batch_policy ) {
+        int i = 0;
+        for( ; batch_policies[i] && strcmp(batch_policy, batch_policies[i]); i++ )
+            ;
+        if( batch_policies[i] )
+            db_ctx->batch_policy = i;
+        else
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "unknown batch_policy='%s'", batch_policy);
+        LIBRDF_FREE(char *, batch_policy);
+        if( !batch_policies[i] ) {
+            free_hash(options);
+            return RET_ERROR;
+        }
+    }
+
+    {
+        sqlite3_uint64 statement_cache_max = db_ctx->stmt_find_max;
+        sqlite3_uint64 soft_heap_limit = ~(sqlite3_uint64)0; // becomes -1, which just queries the limit
+        const char *const names[] = {
+            "slow_threshold_us", "slow_rate", "statement_cache_max", "soft_heap_limit", "warm_up", "analyze_after"
+        };
+        sqlite3_uint64 *values[] = {
+            &(db_ctx->slow_ns), &(db_ctx->slow_rate), &statement_cache_max, &soft_heap_limit, &(db_ctx->warm_up_budget),
+            &(db_ctx->analyze_after)
+        };
+        for( size_t i = 0; i < array_length(names); i++ ) {
+            char *value = librdf_hash_get(options, names[i]);
+            if( !value )
+                continue;
+            const bool valid = parse_uint(value, values[i]);
+            if( !valid )
+                librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid %s='%s'", names[i], value);
+            LIBRDF_FREE(char *, value);
+            if( !valid ) {
+                free_hash(options);
+                return RET_ERROR;
+            }
+        }
+        db_ctx->slow_ns *= 1000;
+        db_ctx->stmt_find_max = (size_t)statement_cache_max;
+        sqlite3_soft_heap_limit64( (sqlite3_int64)soft_heap_limit ); // process wide
+    }
+
+    for( int i = 0; i < PRAGMA_COUNT; i++ ) {
+        char *value = librdf_hash_get(options, tuning_pragmas[i].name);
+        if( !value )
+            continue;
+        if( !tuning_value_valid(i, value) ) {
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid %s='%s'", tuning_pragmas[i].name, value);
+            LIBRDF_FREE(char *, value);
+            free_hash(options);
+            return RET_ERROR;
+        }
+        db_ctx->tuning_override[i] = value;
+    }
+
+    free_hash(options);
+    return RET_OK;
+}
+
+
+static void pub_terminate(librdf_storage *storage)
+{
+    instance_t *db_ctx = get_instance(storage);
+    if( NULL == db_ctx )
+        return;
+    if( db_ctx->name )
+        LIBRDF_FREE(char *, (void *)db_ctx->name);
+    if( db_ctx->digest )
+        librdf_free_digest(db_ctx->digest);
+    for( int i = 0; i < PRAGMA_COUNT; i++ )
+        if( db_ctx->tuning_override[i] )
+            LIBRDF_FREE(char *, db_ctx->tuning_override[i]);
+    if( db_ctx->metrics )
+        LIBRDF_FREE(librdf_storage_sqlite_mro_metrics *, db_ctx->metrics);
+    pool_done(db_ctx);
+    statement_shells_done(db_ctx);
+
+    LIBRDF_FREE(instance_t *, db_ctx);
+}
+
+
+static int pub_close(librdf_storage *storage)
+{
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_OK;
+
+    warm_up_join(db_ctx, true, NULL);
+    finalize_stmt( &(db_ctx->stmt_txn_start) );
+    finalize_stmt( &(db_ctx->stmt_txn_commit) );
+    finalize_stmt( &(db_ctx->stmt_txn_rollback) );
+    finalize_stmt( &(db_ctx->stmt_savepoint_start) );
+    finalize_stmt( &(db_ctx->stmt_savepoint_release) );
+    finalize_stmt( &(db_ctx->stmt_savepoint_rollback) );
+    finalize_stmt( &(db_ctx->stmt_triple_find) );
+    finalize_stmt( &(db_ctx->stmt_triple_insert) );
+    finalize_stmt( &(db_ctx->stmt_triple_delete) );
+
+    finalize_stmt( &(db_ctx->stmt_size) );
+    find_stmt_cache_trim(db_ctx, true);
+    // refresh the statistics the queries of this connection would benefit from, https://sqlite.org/lang_analyze.html#req
+    if( !db_ctx->read_only )
+        exec_stmt(db_ctx->db, "PRAGMA analysis_limit = " ANALYSIS_LIMIT "; PRAGMA optimize;");
+
+    const sqlite_rc_t rc = sqlite3_close(db_ctx->db);
+    if( SQLITE_OK == rc ) {
+        db_ctx->db = NULL;
+        return RET_OK;
+    }
+    char *errmsg = (char *)sqlite3_errmsg(db_ctx->db);
+    librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite database %s close failed - %s", db_ctx->name, errmsg);
+    return rc;
+}
+
+
+static int pub_open(librdf_storage *storage, librdf_model *model)
+{
+    instance_t *db_ctx = get_instance(storage);
+
+    if( !db_ctx->memory ) {
+        const bool file_exists = ( 0 == access(db_ctx->name, F_OK) );
+        if( db_ctx->is_new && file_exists )
+            unlink(db_ctx->name);
+    }
+
+    // open DB
+    assert( (NULL == db_ctx->db) && "db handle mustn't be set by now" );
+    db_ctx->db = NULL;
+    {
+        sqlite_rc_t rc = SQLITE_NOMEM;
+        if( db_ctx->read_only ) {
+            char *uri = read_only_uri(db_ctx->name, db_ctx->immutable);
+            if( uri )
+                rc = sqlite3_open_v2(uri, &db_ctx->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, NULL);
+            LIBRDF_FREE(char *, uri);
+        } else
+            rc = sqlite3_open(db_ctx->memory ? ":memory:" : db_ctx->name, &db_ctx->db);
+        if( SQLITE_OK != rc ) {
+            const char *errmsg = sqlite3_errmsg(db_ctx->db);
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLite database %s open failed - %s", db_ctx->name, errmsg);
+            pub_close(storage);
+            return rc;
+        }
+        // needed by the o_literals triggers of compact_literals stores
+        sqlite3_create_function(db_ctx->db, "mro_hash", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, db_ctx, &sql_fn_hash, NULL, NULL);
+
+        // http://stackoverflow.com/a/6618833
+        if( db_ctx->do_profile ) {
+            sqlite3_trace_v2(db_ctx->db, SQLITE_TRACE_PROFILE, &profile, NULL);
+            // sqlite3_trace(db_ctx->db, &trace, NULL);
+        }
+    }
+
+    // set DB session PRAGMAs
+    if( SYNC_OFF <= db_ctx->synchronous ) {
+        char sql[250];
+        const size_t len = snprintf(sql, sizeof(sql) - 1, "PRAGMA synchronous=%s;", synchronous_flags[db_ctx->synchronous]);
+        assert(len < sizeof(sql) && "buffer too small.");
+        const sqlite_rc_t rc = exec_stmt(db_ctx->db, sql);
+        if( SQLITE_OK != rc ) {
+            pub_close(storage);
+            return rc;
+        }
+    }
+    {
+        const char *const sqls[] = {
+            "PRAGMA foreign_keys = ON;",
+            "PRAGMA recursive_triggers = ON;",
+            "PRAGMA encoding = 'UTF-8';",
+            NULL
+        };
+        for( int v = 0; sqls[v]; v++ ) {
+            const sqlite_rc_t rc = exec_stmt(db_ctx->db, sqls[v]);
+            if( SQLITE_OK != rc ) {
+                pub_close(storage);
+                return rc;
+            }
+        }
+    }
+    if( db_ctx->read_only ) {
+        // query_only backs read_only_refused, the mmap_size default spares read() copies, tuning may override it.
+        const char *const sqls[] = {
+            "PRAGMA query_only = ON;",
+            "PRAGMA mmap_size = " READ_ONLY_MMAP_SIZE ";",
+            NULL
+        };
+        for( int v = 0; sqls[v]; v++ ) {
+            const sqlite_rc_t rc = exec_stmt(db_ctx->db, sqls[v]);
+            if( SQLITE_OK != rc ) {
+                pub_close(storage);
+                return rc;
+            }
+        }
+    }
+    // new stores: auto_vacuum takes effect before the first table only, and before journal_mode=wal writes the header.
+    // It fixes the page_size, too, so that one goes first.
+    if( !db_ctx->read_only ) {
+        sqlite3_stmt *stmt = NULL;
+        prep_stmt(db_ctx->db, &stmt, "PRAGMA page_count;");
+        const bool empty = SQLITE_ROW == sqlite3_step(stmt) && 0 == sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+        sqlite_rc_t rc = empty ? tuning_apply_pragma(db_ctx, PRAGMA_PAGE_SIZE) : SQLITE_OK;
+        if( SQLITE_OK == rc && empty )
+            rc = exec_stmt(db_ctx->db, "PRAGMA auto_vacuum = INCREMENTAL;");
+        if( SQLITE_OK != rc ) {
+            pub_close(storage);
+            return rc;
+        }
+    }
+    // tuning goes before the schema, page_size can't change afterwards
+    {
+        const sqlite_rc_t rc = tuning_apply(db_ctx);
+        if( SQLITE_OK != rc ) {
+            pub_close(storage);
+            return rc;
+        }
+    }
+
+    // check & update schema (run migrations)
+    {
+        sqlite_rc_t rc = SQLITE_OK;
+        sqlite3_stmt *stmt = NULL;
+        prep_stmt(db_ctx->db, &stmt, "PRAGMA user_version;");
+        if( SQLITE_ROW != ( rc = sqlite3_step(stmt) ) ) {
+            sqlite3_finalize(stmt);
+            pub_close(storage);
+            return rc;
+        }
+        const int schema_version = sqlite3_column_int(stmt, 0);
+        if( SQLITE_DONE != ( rc = sqlite3_step(stmt) ) ) {
+            sqlite3_finalize(stmt);
+            pub_close(storage);
+            return rc;
+        }
+        sqlite3_finalize(stmt);
+
+        const char *const migrations[] = {
+            // generated via tools/sql2c.sh sql/schema_mig_to_1.sql
+            "PRAGMA foreign_keys = ON;" "\n" \
+            "PRAGMA recursive_triggers = ON;" "\n" \
+            "PRAGMA encoding = 'UTF-8';" "\n" \
+            " -- URIs for subjects and objects" "\n" \
+            "CREATE TABLE so_uris (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,uri TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
+            ");" "\n" \
+            " -- blank node IDs for subjects and objects" "\n" \
+            "CREATE TABLE so_blanks (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,blank TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
+            ");" "\n" \
+            " -- URIs for predicates" "\n" \
+            "CREATE TABLE p_uris (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,uri TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
+            ");" "\n" \
+            " -- URIs for literal types" "\n" \
+            "CREATE TABLE t_uris (" "\n" \
             "  id INTEGER PRIMARY KEY" "\n" \
             "  ,uri TEXT NOT NULL -- UNIQUE -- redundant constraint (hash should do), could be dropped to save space" "\n" \
             ");" "\n" \
@@ -1096,29 +2905,125 @@ static int pub_open(librdf_storage *storage, librdf_model *model)
             "LEFT OUTER JOIN t_uris     AS o_lit_uris ON o_literals.datatype_id      = o_lit_uris.id" "\n" \
             "LEFT OUTER JOIN c_uris     AS c_uris     ON triple_relations.c_uri_id   = c_uris.id" "\n" \
             ";" "\n" \
-            "CREATE TRIGGER triples_insert INSTEAD OF INSERT ON triples" "\n" \
-            "FOR EACH ROW BEGIN" "\n" \
-            "  -- subject uri/blank" "\n" \
-            "  INSERT OR IGNORE INTO so_uris   (id,uri)   VALUES (NEW.s_uri_id,      NEW.s_uri);" "\n" \
-            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.s_blank_id,    NEW.s_blank);" "\n" \
-            "  -- predicate uri" "\n" \
-            "  INSERT OR IGNORE INTO p_uris    (id,uri)   VALUES (NEW.p_uri_id,      NEW.p_uri);" "\n" \
-            "  -- object uri/blank" "\n" \
-            "  INSERT OR IGNORE INTO so_uris   (id,uri)   VALUES (NEW.o_uri_id,      NEW.o_uri);" "\n" \
-            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.o_blank_id,    NEW.o_blank);" "\n" \
-            "  -- object literal" "\n" \
-            "  INSERT OR IGNORE INTO t_uris    (id,uri)   VALUES (NEW.o_datatype_id, NEW.o_datatype);" "\n" \
-            "  INSERT OR IGNORE INTO o_literals(id,datatype_id,language,text) VALUES (NEW.o_lit_id, NEW.o_datatype_id, NEW.o_language, NEW.o_text);" "\n" \
-            "  -- context uri" "\n" \
-            "  INSERT OR IGNORE INTO c_uris    (id,uri)   VALUES (NEW.c_uri_id,      NEW.c_uri);" "\n" \
-            "  -- triple" "\n" \
-            "  INSERT INTO triple_relations(id, s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id)" "\n" \
-            "  VALUES (NEW.id, NEW.s_uri_id, NEW.s_blank_id, NEW.p_uri_id, NEW.o_uri_id, NEW.o_blank_id, NEW.o_lit_id, NEW.c_uri_id);" "\n" \
-            "END;" "\n" \
+            "CREATE TRIGGER triples_insert INSTEAD OF INSERT ON triples" "\n" \
+            "FOR EACH ROW BEGIN" "\n" \
+            "  -- subject uri/blank" "\n" \
+            "  INSERT OR IGNORE INTO so_uris   (id,uri)   VALUES (NEW.s_uri_id,      NEW.s_uri);" "\n" \
+            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.s_blank_id,    NEW.s_blank);" "\n" \
+            "  -- predicate uri" "\n" \
+            "  INSERT OR IGNORE INTO p_uris    (id,uri)   VALUES (NEW.p_uri_id,      NEW.p_uri);" "\n" \
+            "  -- object uri/blank" "\n" \
+            "  INSERT OR IGNORE INTO so_uris   (id,uri)   VALUES (NEW.o_uri_id,      NEW.o_uri);" "\n" \
+            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.o_blank_id,    NEW.o_blank);" "\n" \
+            "  -- object literal" "\n" \
+            "  INSERT OR IGNORE INTO t_uris    (id,uri)   VALUES (NEW.o_datatype_id, NEW.o_datatype);" "\n" \
+            "  INSERT OR IGNORE INTO o_literals(id,datatype_id,language,text) VALUES (NEW.o_lit_id, NEW.o_datatype_id, NEW.o_language, NEW.o_text);" "\n" \
+            "  -- context uri" "\n" \
+            "  INSERT OR IGNORE INTO c_uris    (id,uri)   VALUES (NEW.c_uri_id,      NEW.c_uri);" "\n" \
+            "  -- triple" "\n" \
+            "  INSERT INTO triple_relations(id, s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id)" "\n" \
+            "  VALUES (NEW.id, NEW.s_uri_id, NEW.s_blank_id, NEW.p_uri_id, NEW.o_uri_id, NEW.o_blank_id, NEW.o_lit_id, NEW.c_uri_id);" "\n" \
+            "END;" "\n" \
+            "CREATE TRIGGER triples_delete INSTEAD OF DELETE ON triples" "\n" \
+            "FOR EACH ROW BEGIN" "\n" \
+            "  -- triple" "\n" \
+            "  DELETE FROM triple_relations WHERE id = OLD.id;" "\n" \
+            "  -- subject uri/blank" "\n" \
+            "  DELETE FROM so_uris    WHERE (OLD.s_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_uri_id    = OLD.s_uri_id))      AND (id = OLD.s_uri_id);" "\n" \
+            "  DELETE FROM so_blanks  WHERE (OLD.s_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_blank_id  = OLD.s_blank_id))    AND (id = OLD.s_blank_id);" "\n" \
+            "  -- predicate uri" "\n" \
+            "  DELETE FROM p_uris     WHERE (OLD.p_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE p_uri_id    = OLD.p_uri_id))      AND (id = OLD.p_uri_id);" "\n" \
+            "  -- object uri/blank" "\n" \
+            "  DELETE FROM so_uris    WHERE (OLD.o_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_uri_id    = OLD.o_uri_id))      AND (id = OLD.o_uri_id);" "\n" \
+            "  DELETE FROM so_blanks  WHERE (OLD.o_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_blank_id  = OLD.o_blank_id))    AND (id = OLD.o_blank_id);" "\n" \
+            "  -- object literal" "\n" \
+            "  DELETE FROM o_literals WHERE (OLD.o_lit_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_lit_id    = OLD.o_lit_id))      AND (id = OLD.o_lit_id);" "\n" \
+            "  DELETE FROM t_uris     WHERE (OLD.o_datatype_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literals       WHERE datatype_id = OLD.o_datatype_id)) AND (id = OLD.o_datatype_id);" "\n" \
+            "  -- context uri" "\n" \
+            "  DELETE FROM c_uris     WHERE (OLD.c_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE c_uri_id    = OLD.c_uri_id))      AND (id = OLD.c_uri_id);" "\n" \
+            "END;" "\n" \
+            "PRAGMA user_version=2;" "\n" \
+            ,
+            // generated via tools/sql2c.sh sql/schema_mig_to_3.sql
+            "DROP TRIGGER triples_delete;" "\n" \
+            "CREATE TRIGGER triples_delete INSTEAD OF DELETE ON triples" "\n" \
+            "FOR EACH ROW BEGIN" "\n" \
+            "  -- subject uri/blank" "\n" \
+            "  DELETE FROM so_uris    WHERE (OLD.s_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_uri_id    = OLD.s_uri_id))      AND (id = OLD.s_uri_id);" "\n" \
+            "  DELETE FROM so_blanks  WHERE (OLD.s_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_blank_id  = OLD.s_blank_id))    AND (id = OLD.s_blank_id);" "\n" \
+            "  -- predicate uri" "\n" \
+            "  DELETE FROM p_uris     WHERE (OLD.p_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE p_uri_id    = OLD.p_uri_id))      AND (id = OLD.p_uri_id);" "\n" \
+            "  -- object uri/blank" "\n" \
+            "  DELETE FROM so_uris    WHERE (OLD.o_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_uri_id    = OLD.o_uri_id))      AND (id = OLD.o_uri_id);" "\n" \
+            "  DELETE FROM so_blanks  WHERE (OLD.o_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_blank_id  = OLD.o_blank_id))    AND (id = OLD.o_blank_id);" "\n" \
+            "  -- object literal" "\n" \
+            "  DELETE FROM o_literals WHERE (OLD.o_lit_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_lit_id    = OLD.o_lit_id))      AND (id = OLD.o_lit_id);" "\n" \
+            "  DELETE FROM t_uris     WHERE (OLD.o_datatype_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literals       WHERE datatype_id = OLD.o_datatype_id)) AND (id = OLD.o_datatype_id);" "\n" \
+            "  -- context uri" "\n" \
+            "  DELETE FROM c_uris     WHERE (OLD.c_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE c_uri_id    = OLD.c_uri_id))      AND (id = OLD.c_uri_id);" "\n" \
+            "  -- triple" "\n" \
+            "  DELETE FROM triple_relations WHERE id = OLD.id;" "\n" \
+            "END;" "\n" \
+            "PRAGMA user_version=3;" "\n" \
+            ,
+            // generated via tools/sql2c.sh sql/schema_mig_to_4.sql
+            "CREATE INDEX triple_relations_index_c_uri_id   ON triple_relations(c_uri_id); -- WHERE c_uri_id IS NOT NULL;" "\n" \
+            "PRAGMA user_version=4;" "\n" \
+            ,
+            NULL
+        };
+        // optional schema for new stores, see option uri_prefixes
+        const char *const uri_prefixes[] = {
+            // generated via tools/sql2c.sh sql/schema_uri_prefixes_1.sql
+            "CREATE TABLE ns_uris (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,prefix TEXT NOT NULL" "\n" \
+            ");" "\n" \
+            "CREATE UNIQUE INDEX ns_uris_index_prefix ON ns_uris(prefix);" "\n" \
+            "ALTER TABLE so_uris ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);" "\n" \
+            "ALTER TABLE p_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);" "\n" \
+            "ALTER TABLE t_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);" "\n" \
+            "ALTER TABLE c_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);" "\n" \
+            "DROP VIEW triples;" "\n" \
+            "CREATE VIEW triples AS" "\n" \
+            "SELECT" "\n" \
+            "  -- all *_id (hashes):" "\n" \
+            "  triple_relations.id AS id" "\n" \
+            "  ,s_uri_id" "\n" \
+            "  ,s_blank_id" "\n" \
+            "  ,p_uri_id" "\n" \
+            "  ,o_uri_id" "\n" \
+            "  ,o_blank_id" "\n" \
+            "  ,o_lit_id" "\n" \
+            "  ,o_literals.datatype_id AS o_datatype_id" "\n" \
+            "  ,c_uri_id" "\n" \
+            "  -- all joined values:" "\n" \
+            "  ,s_ns.prefix || s_uris.uri     AS s_uri" "\n" \
+            "  ,s_blanks.blank                AS s_blank" "\n" \
+            "  ,p_ns.prefix || p_uris.uri     AS p_uri" "\n" \
+            "  ,o_ns.prefix || o_uris.uri     AS o_uri" "\n" \
+            "  ,o_blanks.blank                AS o_blank" "\n" \
+            "  ,o_literals.text               AS o_text" "\n" \
+            "  ,o_literals.language           AS o_language" "\n" \
+            "  ,t_ns.prefix || o_lit_uris.uri AS o_datatype" "\n" \
+            "  ,c_ns.prefix || c_uris.uri     AS c_uri" "\n" \
+            "FROM triple_relations" "\n" \
+            "LEFT OUTER JOIN so_uris    AS s_uris     ON triple_relations.s_uri_id   = s_uris.id" "\n" \
+            "LEFT OUTER JOIN ns_uris    AS s_ns       ON s_uris.ns_id                = s_ns.id" "\n" \
+            "LEFT OUTER JOIN so_blanks  AS s_blanks   ON triple_relations.s_blank_id = s_blanks.id" "\n" \
+            "INNER      JOIN p_uris     AS p_uris     ON triple_relations.p_uri_id   = p_uris.id" "\n" \
+            "INNER      JOIN ns_uris    AS p_ns       ON p_uris.ns_id                = p_ns.id" "\n" \
+            "LEFT OUTER JOIN so_uris    AS o_uris     ON triple_relations.o_uri_id   = o_uris.id" "\n" \
+            "LEFT OUTER JOIN ns_uris    AS o_ns       ON o_uris.ns_id                = o_ns.id" "\n" \
+            "LEFT OUTER JOIN so_blanks  AS o_blanks   ON triple_relations.o_blank_id = o_blanks.id" "\n" \
+            "LEFT OUTER JOIN o_literals AS o_literals ON triple_relations.o_lit_id   = o_literals.id" "\n" \
+            "LEFT OUTER JOIN t_uris     AS o_lit_uris ON o_literals.datatype_id      = o_lit_uris.id" "\n" \
+            "LEFT OUTER JOIN ns_uris    AS t_ns       ON o_lit_uris.ns_id            = t_ns.id" "\n" \
+            "LEFT OUTER JOIN c_uris     AS c_uris     ON triple_relations.c_uri_id   = c_uris.id" "\n" \
+            "LEFT OUTER JOIN ns_uris    AS c_ns       ON c_uris.ns_id                = c_ns.id" "\n" \
+            ";" "\n" \
             "CREATE TRIGGER triples_delete INSTEAD OF DELETE ON triples" "\n" \
             "FOR EACH ROW BEGIN" "\n" \
-            "  -- triple" "\n" \
-            "  DELETE FROM triple_relations WHERE id = OLD.id;" "\n" \
             "  -- subject uri/blank" "\n" \
             "  DELETE FROM so_uris    WHERE (OLD.s_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_uri_id    = OLD.s_uri_id))      AND (id = OLD.s_uri_id);" "\n" \
             "  DELETE FROM so_blanks  WHERE (OLD.s_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_blank_id  = OLD.s_blank_id))    AND (id = OLD.s_blank_id);" "\n" \
@@ -1132,708 +3037,1970 @@ static int pub_open(librdf_storage *storage, librdf_model *model)
             "  DELETE FROM t_uris     WHERE (OLD.o_datatype_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literals       WHERE datatype_id = OLD.o_datatype_id)) AND (id = OLD.o_datatype_id);" "\n" \
             "  -- context uri" "\n" \
             "  DELETE FROM c_uris     WHERE (OLD.c_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE c_uri_id    = OLD.c_uri_id))      AND (id = OLD.c_uri_id);" "\n" \
+            "  -- triple" "\n" \
+            "  DELETE FROM triple_relations WHERE id = OLD.id;" "\n" \
             "END;" "\n" \
-            "PRAGMA user_version=2;" "\n" \
             ,
-            // generated via tools/sql2c.sh sql/schema_mig_to_3.sql
-            "DROP TRIGGER triples_delete;" "\n" \
-            "CREATE TRIGGER triples_delete INSTEAD OF DELETE ON triples" "\n" \
+            // generated via tools/sql2c.sh sql/schema_uri_prefixes_2.sql
+            "CREATE TRIGGER triples_insert INSTEAD OF INSERT ON triples" "\n" \
             "FOR EACH ROW BEGIN" "\n" \
             "  -- subject uri/blank" "\n" \
-            "  DELETE FROM so_uris    WHERE (OLD.s_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_uri_id    = OLD.s_uri_id))      AND (id = OLD.s_uri_id);" "\n" \
-            "  DELETE FROM so_blanks  WHERE (OLD.s_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_blank_id  = OLD.s_blank_id))    AND (id = OLD.s_blank_id);" "\n" \
+            "  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.s_uri, replace(replace(NEW.s_uri, '/', ''), '#', '')));" "\n" \
+            "  INSERT OR IGNORE INTO so_uris   (id,ns_id,uri) SELECT NEW.s_uri_id, id, substr(NEW.s_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.s_uri, replace(replace(NEW.s_uri, '/', ''), '#', ''));" "\n" \
+            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.s_blank_id,    NEW.s_blank);" "\n" \
             "  -- predicate uri" "\n" \
-            "  DELETE FROM p_uris     WHERE (OLD.p_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE p_uri_id    = OLD.p_uri_id))      AND (id = OLD.p_uri_id);" "\n" \
+            "  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.p_uri, replace(replace(NEW.p_uri, '/', ''), '#', '')));" "\n" \
+            "  INSERT OR IGNORE INTO p_uris    (id,ns_id,uri) SELECT NEW.p_uri_id, id, substr(NEW.p_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.p_uri, replace(replace(NEW.p_uri, '/', ''), '#', ''));" "\n" \
             "  -- object uri/blank" "\n" \
-            "  DELETE FROM so_uris    WHERE (OLD.o_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_uri_id    = OLD.o_uri_id))      AND (id = OLD.o_uri_id);" "\n" \
-            "  DELETE FROM so_blanks  WHERE (OLD.o_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_blank_id  = OLD.o_blank_id))    AND (id = OLD.o_blank_id);" "\n" \
+            "  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.o_uri, replace(replace(NEW.o_uri, '/', ''), '#', '')));" "\n" \
+            "  INSERT OR IGNORE INTO so_uris   (id,ns_id,uri) SELECT NEW.o_uri_id, id, substr(NEW.o_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.o_uri, replace(replace(NEW.o_uri, '/', ''), '#', ''));" "\n" \
+            "  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.o_blank_id,    NEW.o_blank);" "\n" \
             "  -- object literal" "\n" \
-            "  DELETE FROM o_literals WHERE (OLD.o_lit_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_lit_id    = OLD.o_lit_id))      AND (id = OLD.o_lit_id);" "\n" \
-            "  DELETE FROM t_uris     WHERE (OLD.o_datatype_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literals       WHERE datatype_id = OLD.o_datatype_id)) AND (id = OLD.o_datatype_id);" "\n" \
+            "  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.o_datatype, replace(replace(NEW.o_datatype, '/', ''), '#', '')));" "\n" \
+            "  INSERT OR IGNORE INTO t_uris    (id,ns_id,uri) SELECT NEW.o_datatype_id, id, substr(NEW.o_datatype, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.o_datatype, replace(replace(NEW.o_datatype, '/', ''), '#', ''));" "\n" \
+            "  INSERT OR IGNORE INTO o_literals(id,datatype_id,language,text) VALUES (NEW.o_lit_id, NEW.o_datatype_id, NEW.o_language, NEW.o_text);" "\n" \
             "  -- context uri" "\n" \
-            "  DELETE FROM c_uris     WHERE (OLD.c_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE c_uri_id    = OLD.c_uri_id))      AND (id = OLD.c_uri_id);" "\n" \
+            "  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.c_uri, replace(replace(NEW.c_uri, '/', ''), '#', '')));" "\n" \
+            "  INSERT OR IGNORE INTO c_uris    (id,ns_id,uri) SELECT NEW.c_uri_id, id, substr(NEW.c_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.c_uri, replace(replace(NEW.c_uri, '/', ''), '#', ''));" "\n" \
             "  -- triple" "\n" \
-            "  DELETE FROM triple_relations WHERE id = OLD.id;" "\n" \
+            "  INSERT INTO triple_relations(id, s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id)" "\n" \
+            "  VALUES (NEW.id, NEW.s_uri_id, NEW.s_blank_id, NEW.p_uri_id, NEW.o_uri_id, NEW.o_blank_id, NEW.o_lit_id, NEW.c_uri_id);" "\n" \
+            "END;" "\n" \
+            ,
+            NULL
+        };
+        // optional schema for new stores, see option compact_literals
+        const char *const compact_literals[] = {
+            // generated via tools/sql2c.sh sql/schema_compact_literals.sql
+            "CREATE TABLE o_languages (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,language TEXT NOT NULL" "\n" \
+            ");" "\n" \
+            "CREATE UNIQUE INDEX o_languages_index_language ON o_languages(language);" "\n" \
+            "CREATE TABLE o_bodies (" "\n" \
+            "  id INTEGER PRIMARY KEY -- mro_hash(text)" "\n" \
+            "  ,text TEXT NOT NULL" "\n" \
+            ");" "\n" \
+            "PRAGMA legacy_alter_table = ON;" "\n" \
+            "ALTER TABLE o_literals RENAME TO o_literal_rows;" "\n" \
+            "PRAGMA legacy_alter_table = OFF;" "\n" \
+            "DROP TABLE o_literal_rows;" "\n" \
+            "CREATE TABLE o_literal_rows (" "\n" \
+            "  id INTEGER PRIMARY KEY" "\n" \
+            "  ,datatype_id INTEGER NULL REFERENCES t_uris(id)" "\n" \
+            "  ,language_id INTEGER NULL REFERENCES o_languages(id)" "\n" \
+            "  ,text TEXT NULL -- either text" "\n" \
+            "  ,body_id INTEGER NULL REFERENCES o_bodies(id) -- or body" "\n" \
+            ");" "\n" \
+            "CREATE INDEX o_literal_rows_index_datatype_id ON o_literal_rows(datatype_id);" "\n" \
+            "CREATE INDEX o_literal_rows_index_language_id ON o_literal_rows(language_id) WHERE language_id IS NOT NULL;" "\n" \
+            "CREATE INDEX o_literal_rows_index_body_id     ON o_literal_rows(body_id)     WHERE body_id IS NOT NULL;" "\n" \
+            "CREATE VIEW o_literals AS" "\n" \
+            "SELECT" "\n" \
+            "  o_literal_rows.id AS id" "\n" \
+            "  ,o_literal_rows.datatype_id AS datatype_id" "\n" \
+            "  ,(SELECT language FROM o_languages WHERE id = o_literal_rows.language_id) AS language" "\n" \
+            "  ,CASE WHEN o_literal_rows.body_id IS NULL THEN o_literal_rows.text ELSE (SELECT text FROM o_bodies WHERE id = o_literal_rows.body_id) END AS text" "\n" \
+            "  ,o_literal_rows.language_id AS language_id" "\n" \
+            "  ,o_literal_rows.body_id AS body_id" "\n" \
+            "FROM o_literal_rows" "\n" \
+            ";" "\n" \
+            "CREATE TRIGGER o_literals_insert INSTEAD OF INSERT ON o_literals" "\n" \
+            "FOR EACH ROW BEGIN" "\n" \
+            "  -- NULL language inserts nothing, the NOT NULL constraint makes OR IGNORE skip it." "\n" \
+            "  INSERT OR IGNORE INTO o_languages(language) VALUES (NEW.language);" "\n" \
+            "  INSERT OR IGNORE INTO o_bodies(id,text) SELECT mro_hash(NEW.text), NEW.text WHERE length(CAST(NEW.text AS BLOB)) > 256;" "\n" \
+            "  INSERT OR IGNORE INTO o_literal_rows(id,datatype_id,language_id,text,body_id)" "\n" \
+            "  SELECT NEW.id, NEW.datatype_id, (SELECT id FROM o_languages WHERE language = NEW.language)" "\n" \
+            "    ,CASE WHEN length(CAST(NEW.text AS BLOB)) > 256 THEN NULL ELSE NEW.text END" "\n" \
+            "    ,CASE WHEN length(CAST(NEW.text AS BLOB)) > 256 THEN mro_hash(NEW.text) ELSE NULL END;" "\n" \
+            "END;" "\n" \
+            "CREATE TRIGGER o_literals_delete INSTEAD OF DELETE ON o_literals" "\n" \
+            "FOR EACH ROW BEGIN" "\n" \
+            "  DELETE FROM o_literal_rows WHERE id = OLD.id;" "\n" \
+            "  DELETE FROM o_bodies    WHERE (OLD.body_id     IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literal_rows WHERE body_id     = OLD.body_id))     AND (id = OLD.body_id);" "\n" \
+            "  DELETE FROM o_languages WHERE (OLD.language_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literal_rows WHERE language_id = OLD.language_id)) AND (id = OLD.language_id);" "\n" \
             "END;" "\n" \
-            "PRAGMA user_version=3;" "\n" \
             ,
             NULL
         };
         {
             const size_t mig_count = array_length(migrations) - 1;
-            assert(3 == mig_count && "migrations count wrong.");
+            assert(SCHEMA_VERSION == mig_count && "migrations count wrong.");
             assert(!migrations[mig_count] && "migrations must be NULL terminated.");
             if( mig_count < schema_version ) {
                 // schema is more recent than this source file knows to handle.
                 pub_close(storage);
                 return RET_ERROR;
             }
+            if( db_ctx->read_only && mig_count != schema_version ) {
+                librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "read only %s has schema version %d, needs %d", db_ctx->name, schema_version, (int)mig_count);
+                pub_close(storage);
+                return RET_ERROR;
+            }
+        }
+        // read only: no write lock, no migrations, commit does nothing
+        const sqlite_rc_t begin = db_ctx->read_only ? SQLITE_READONLY : transaction_start(storage);
+        for( int v = schema_version; migrations[v]; v++ ) {
+            if( SQLITE_OK != ( rc = exec_stmt(db_ctx->db, migrations[v]) ) ) {
+                transaction_rollback(storage, begin);
+                pub_close(storage);
+                return rc;
+            }
+            {
+                // assert new schema version
+                sqlite3_stmt *stmt = NULL;
+                prep_stmt(db_ctx->db, &stmt, "PRAGMA user_version");
+                if( SQLITE_ROW != ( rc = sqlite3_step(stmt) ) ) {
+                    sqlite3_finalize(stmt);
+                    pub_close(storage);
+                    return rc;
+                }
+                const int v_new = sqlite3_column_int(stmt, 0);
+                if( SQLITE_DONE != ( rc = sqlite3_step(stmt) ) ) {
+                    sqlite3_finalize(stmt);
+                    pub_close(storage);
+                    return rc;
+                }
+                sqlite3_finalize(stmt);
+                assert(v + 1 == v_new && "invalid schema version after migration.");
+            }
+        }
+        for( int i = 0; 0 == schema_version && db_ctx->uri_prefixes && uri_prefixes[i]; i++ ) {
+            if( SQLITE_OK != ( rc = exec_stmt(db_ctx->db, uri_prefixes[i]) ) ) {
+                transaction_rollback(storage, begin);
+                pub_close(storage);
+                return rc;
+            }
+        }
+        for( int i = 0; 0 == schema_version && db_ctx->compact_literals && compact_literals[i]; i++ ) {
+            if( SQLITE_OK != ( rc = exec_stmt(db_ctx->db, compact_literals[i]) ) ) {
+                transaction_rollback(storage, begin);
+                pub_close(storage);
+                return rc;
+            }
+        }
+        if( SQLITE_OK != ( rc = transaction_commit(storage, begin) ) ) {
+            pub_close(storage);
+            return rc;
+        }
+        schema_detect(db_ctx);
+    }
+    // best effort, a failed warm-up leaves a working storage
+    if( db_ctx->warm_up_budget > 0 )
+        warm_up_start(storage, (sqlite3_int64)db_ctx->warm_up_budget, db_ctx->warm_up_flags, NULL, NULL);
+    return RET_OK;
+}
+
+
+/**
+ * librdf_storage_sqlite_get_feature:
+ * @storage: #librdf_storage object
+ * @feature: #librdf_uri feature property
+ *
+ * Get the value of a storage feature.
+ *
+ * Return value: #librdf_node feature value or NULL if no such feature
+ * exists or the value is empty.
+ **/
+static librdf_node *pub_get_feature(librdf_storage *storage, librdf_uri *feature)
+{
+    assert(storage && "storage must be set");
+    if( !feature )
+        return NULL;
+    const char *feat = (char *)librdf_uri_as_string(feature);
+    if( !feat )
+        return NULL;
+    instance_t *db_ctx = get_instance(storage);
+
+    librdf_node *ret = NULL;
+    librdf_uri *uri_xsd_boolean = librdf_new_uri(get_world(storage), (str_uri_t)"http://www.w3.org/2000/10/XMLSchema#" "boolean");
+    librdf_uri *uri_xsd_unsignedShort = librdf_new_uri(get_world(storage), (str_uri_t)"http://www.w3.org/2000/10/XMLSchema#" "unsignedShort");
+    librdf_uri *uri_xsd_integer = librdf_new_uri(get_world(storage), (str_uri_t)LIBRDF_NAMESPACE_XSD "integer");
+    librdf_uri *uri_xsd_string = librdf_new_uri(get_world(storage), (str_uri_t)LIBRDF_NAMESPACE_XSD "string");
+
+    if( !ret && 0 == strcmp(LIBRDF_MODEL_FEATURE_CONTEXTS, feat) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(true ? "1" : "0"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE, feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->do_profile ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN, (char *)feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->do_explain_query_plan ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK, feat ) ) {
+        char buf[10];
+        snprintf(buf, sizeof(buf) - 1, "%d", db_ctx->sql_cache_mask);
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_uri_t)buf, NULL, uri_xsd_unsignedShort);
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, feat ) && db_ctx->tuning )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)db_ctx->tuning->name, NULL, uri_xsd_string);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES, feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->uri_prefixes ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COMPACT_LITERALS, feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->compact_literals ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_READ_ONLY, feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->read_only ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE, feat ) && db_ctx->db )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(stats_stale(db_ctx) ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS, feat ) )
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->metrics ? "true" : "false"), NULL, uri_xsd_boolean);
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_DUMP, feat ) && db_ctx->metrics ) {
+        char *dump = metrics_dump(db_ctx->metrics);
+        if( dump ) {
+            ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)dump, NULL, uri_xsd_string);
+            LIBRDF_FREE(char *, dump);
+        }
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_MEMORY_STATS, feat ) ) {
+        char *dump = memory_stats_dump(storage);
+        if( dump ) {
+            ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)dump, NULL, uri_xsd_string);
+            LIBRDF_FREE(char *, dump);
+        }
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_QUERY_PLANS, feat ) ) {
+        char *report = query_plans_report(storage);
+        if( report ) {
+            ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)report, NULL, uri_xsd_string);
+            LIBRDF_FREE(char *, report);
+        }
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, feat ) ) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)(db_ctx->slow_ns / 1000) );
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)buf, NULL, uri_xsd_integer);
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE, feat ) ) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)db_ctx->slow_rate);
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)buf, NULL, uri_xsd_integer);
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED, feat ) ) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)db_ctx->count_inserted);
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)buf, NULL, uri_xsd_integer);
+    }
+    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, feat ) ) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)db_ctx->count_ignored);
+        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)buf, NULL, uri_xsd_integer);
+    }
+    if( !ret ) {
+        const int pragma = tuning_pragma_for_feature(feat);
+        char buf[40];
+        if( 0 <= pragma && tuning_effective_value(db_ctx, pragma, buf, sizeof(buf)) )
+            ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)buf, NULL, tuning_pragmas[pragma].keywords ? uri_xsd_string : uri_xsd_integer);
+    }
+
+    librdf_free_uri(uri_xsd_boolean);
+    librdf_free_uri(uri_xsd_unsignedShort);
+    librdf_free_uri(uri_xsd_integer);
+    librdf_free_uri(uri_xsd_string);
+    return ret;
+}
+
+
+/**
+ * librdf_storage_set_feature:
+ * @storage: #librdf_storage object
+ * @feature: #librdf_uri feature property
+ * @value: #librdf_node feature property value
+ *
+ * Set the value of a storage feature.
+ *
+ * Return value: non 0 on failure (negative if no such feature)
+ **/
+static int pub_set_feature(librdf_storage *storage, librdf_uri *feature, librdf_node *value)
+{
+    assert(storage && "storage must be set");
+    if( !feature )
+        return -1;
+    const char *feat = (char *)librdf_uri_as_string(feature);
+    if( !feat )
+        return -1;
+    const char *val = (char *)librdf_node_get_literal_value(value);
+    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "pub_set_feature('%s', '%s')", feat, val);
+
+    instance_t *db_ctx = get_instance(storage);
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK, feat ) ) {
+        if( 0 == strcmp("0", val) ) {
+            db_ctx->sql_cache_mask = 0;
+        } else {
+            char *end = NULL;
+            const long i = strtol(val, &end, 10);
+            if( NULL == end || '\0' != *end ) {
+                librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:unsignedShort", feat, val);
+                return 3;
+            }
+            db_ctx->sql_cache_mask = ALL_PARAMS & i; // clip range
+        }
+        find_stmt_cache_trim(db_ctx, false);
+        // librdf_log(NULL, 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "good value: <%s> \"%d\"^^xsd:unsignedShort", feat, db_ctx->sql_cache_mask);
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE, feat ) ) {
+        if( 0 == strcmp("0", val) || 0 == strcmp("false", val) )
+            return 0;
+        if( !( 0 == strcmp("1", val) || 0 == strcmp("true", val) ) ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
+            return 3;
+        }
+        if( !db_ctx->db || read_only_refused(storage, "analyze") )
+            return 1;
+        return stats_analyze(db_ctx);
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE, feat ) ) {
+        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) ) {
+            db_ctx->do_profile = true;
+            if( db_ctx->db )
+                sqlite3_trace_v2(db_ctx->db, SQLITE_TRACE_PROFILE, &profile, storage);
+        } else if( 0 == strcmp("0", val) || 0 == strcmp("false", val) ) {
+            db_ctx->do_profile = false;
+            if( db_ctx->db )
+                sqlite3_trace_v2(db_ctx->db, 0, NULL, NULL);
+        } else {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
+            return 2;
+        }
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN, feat ) ) {
+        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) )
+            db_ctx->do_explain_query_plan = true;
+        else if( 0 == strcmp("0", val) || 0 == strcmp("false", val) )
+            db_ctx->do_explain_query_plan = false;
+        else {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
+            return 2;
+        }
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS, feat ) ) {
+        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) ) {
+            if( !db_ctx->metrics && !( db_ctx->metrics = LIBRDF_CALLOC(librdf_storage_sqlite_mro_metrics *, sizeof(*db_ctx->metrics), 1) ) )
+                return 5;
+        } else if( 0 == strcmp("0", val) || 0 == strcmp("false", val) ) {
+            if( db_ctx->metrics )
+                LIBRDF_FREE(librdf_storage_sqlite_mro_metrics *, db_ctx->metrics);
+            db_ctx->metrics = NULL;
+        } else {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
+            return 2;
+        }
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_RESET, feat ) ) {
+        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) )
+            librdf_storage_sqlite_mro_reset_metrics(storage);
+        else if( !( 0 == strcmp("0", val) || 0 == strcmp("false", val) ) ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
+            return 2;
+        }
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, feat ) ) {
+        const tuning_profile_t *tuning = tuning_profile_named(val);
+        if( !tuning ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:string", feat, val);
+            return 2;
+        }
+        if( db_ctx->in_transaction ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "cannot change <%s> within a transaction", feat);
+            return 4;
+        }
+        // a profile switch drops previous overrides
+        for( int i = 0; i < PRAGMA_COUNT; i++ ) {
+            if( db_ctx->tuning_override[i] )
+                LIBRDF_FREE(char *, db_ctx->tuning_override[i]);
+            db_ctx->tuning_override[i] = NULL;
+        }
+        db_ctx->tuning = tuning;
+        return SQLITE_OK == tuning_apply(db_ctx) ? 0 : 5;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, feat ) || 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE, feat ) ) {
+        sqlite3_uint64 i = 0;
+        if( !parse_uint(val, &i) ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:integer", feat, val);
+            return 2;
+        }
+        if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, feat ) )
+            db_ctx->slow_ns = i * 1000;
+        else
+            db_ctx->slow_rate = i;
+        return 0;
+    }
+
+    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED, feat ) || 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, feat ) ) {
+        if( 0 != strcmp("0", val) ) {
+            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:integer, can only reset to 0", feat, val);
+            return 2;
+        }
+        if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED, feat ) )
+            db_ctx->count_inserted = 0;
+        else
+            db_ctx->count_ignored = 0;
+        return 0;
+    }
+
+    {
+        const int pragma = tuning_pragma_for_feature(feat);
+        if( 0 <= pragma ) {
+            if( !tuning_value_valid(pragma, val) ) {
+                librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"", feat, val);
+                return 2;
+            }
+            if( db_ctx->in_transaction ) {
+                librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "cannot change <%s> within a transaction", feat);
+                return 4;
+            }
+            const size_t len = strlen(val);
+            char *value = LIBRDF_MALLOC(char *, len + 1);
+            if( !value )
+                return 5;
+            strncpy(value, val, len + 1);
+            if( db_ctx->tuning_override[pragma] )
+                LIBRDF_FREE(char *, db_ctx->tuning_override[pragma]);
+            db_ctx->tuning_override[pragma] = value;
+            return db_ctx->db && SQLITE_OK != tuning_apply_pragma(db_ctx, pragma) ? 5 : 0;
         }
-        const sqlite_rc_t begin = transaction_start(storage);
-        for( int v = schema_version; migrations[v]; v++ ) {
-            if( SQLITE_OK != ( rc = exec_stmt(db_ctx->db, migrations[v]) ) ) {
-                transaction_rollback(storage, begin);
-                pub_close(storage);
-                return rc;
+    }
+    return 1;
+}
+
+
+#pragma mark Transactions
+
+
+static sqlite_rc_t pub_transaction_start(librdf_storage *storage)
+{
+    if( read_only_refused(storage, "transaction") )
+        return SQLITE_READONLY;
+    return transaction_start(storage);
+}
+
+
+static sqlite_rc_t pub_transaction_commit(librdf_storage *storage)
+{
+    return transaction_commit(storage, SQLITE_OK);
+}
+
+
+static sqlite_rc_t pub_transaction_rollback(librdf_storage *storage)
+{
+    return transaction_rollback(storage, SQLITE_OK);
+}
+
+
+#pragma mark Iterator
+
+
+typedef struct
+{
+    librdf_storage *storage;
+    librdf_statement *pattern;
+    librdf_statement *statement;
+    librdf_node *context;
+
+    sqlite3_stmt *stmt;
+    sqlite_rc_t txn;
+    sqlite_rc_t rc;
+    bool dirty;
+
+    sql_find_param_t params;
+    bool cached; // stmt came from stmt_find
+    sqlite3_uint64 rows;
+    metric_span_t span;
+}
+iterator_t;
+
+// pool_alloc hands out POOL_SLOT_SIZE bytes, checked at compile time as asserts may be off
+typedef char iterator_fits_pool_slot[sizeof(iterator_t) <= POOL_SLOT_SIZE ? 1 : -1];
+
+
+static int pub_iter_end_of_stream(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    iterator_t *ctx = (iterator_t *)_ctx;
+    return SQLITE_ROW != ctx->rc;
+}
+
+
+static int pub_iter_next_statement(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    iterator_t *ctx = (iterator_t *)_ctx;
+    if( pub_iter_end_of_stream(ctx) )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(ctx->storage);
+    span_resume(db_ctx, &(ctx->span) );
+    TIMER_DECL;
+    ctx->dirty = true;
+    ctx->rc = TIMED(db_ctx, STEP_FIND, sqlite3_step(ctx->stmt) );
+    span_phase(db_ctx, &(ctx->span), LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    if( pub_iter_end_of_stream(ctx) )
+        return RET_ERROR;
+    ctx->rows++;
+    return RET_OK;
+}
+
+
+static void *pub_iter_get_statement(void *_ctx, const int _flags)
+{
+    assert(_ctx && "context mustn't be NULL");
+    const librdf_iterator_get_method_flags flags = (librdf_iterator_get_method_flags)_flags;
+    iterator_t *ctx = (iterator_t *)_ctx;
+
+    switch( flags ) {
+    case LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT: {
+        if( ctx->dirty && !pub_iter_end_of_stream(_ctx) ) {
+            assert(ctx->statement && "statement mustn't be NULL");
+            instance_t *db_ctx = get_instance(ctx->storage);
+            span_resume(db_ctx, &(ctx->span) );
+            TIMER_DECL;
+            TIMER_START();
+            librdf_world *w = get_world(ctx->storage);
+            librdf_statement *st = ctx->statement;
+            sqlite3_stmt *stm = ctx->stmt;
+            librdf_statement_clear(st);
+            // stmt columns refer to find_triples_sql
+            {
+                /* subject */
+                librdf_node *node = NULL;
+                const str_uri_t uri = column_uri_string(stm, IDX_S_URI);
+                if( uri ) {
+                    assert('\0' != uri[0] && "empty uri");
+                    node = librdf_new_node_from_uri_string(w, uri);
+                }
+                if( !node ) {
+                    const str_blank_t blank = column_blank_string(stm, IDX_S_BLANK);
+                    if( blank ) {
+                        assert('\0' != blank[0] && "empty blank");
+                        node = librdf_new_node_from_blank_identifier(w, blank);
+                    }
+                }
+                if( !node )
+                    return NULL;
+                librdf_statement_set_subject(st, node);
             }
             {
-                // assert new schema version
-                sqlite3_stmt *stmt = NULL;
-                prep_stmt(db_ctx->db, &stmt, "PRAGMA user_version");
-                if( SQLITE_ROW != ( rc = sqlite3_step(stmt) ) ) {
-                    sqlite3_finalize(stmt);
-                    pub_close(storage);
-                    return rc;
+                /* predicate */
+                librdf_node *node = NULL;
+                const str_uri_t uri = column_uri_string(stm, IDX_P_URI);
+                if( uri )
+                    node = librdf_new_node_from_uri_string(w, uri);
+                if( !node )
+                    return NULL;
+                librdf_statement_set_predicate(st, node);
+            }
+            {
+                /* object */
+                librdf_node *node = NULL;
+                const str_uri_t uri = column_uri_string(stm, IDX_O_URI);
+                if( uri )
+                    node = librdf_new_node_from_uri_string(w, uri);
+                if( !node ) {
+                    const str_blank_t blank = column_blank_string(stm, IDX_O_BLANK);
+                    if( blank )
+                        node = librdf_new_node_from_blank_identifier(w, blank);
                 }
-                const int v_new = sqlite3_column_int(stmt, 0);
-                if( SQLITE_DONE != ( rc = sqlite3_step(stmt) ) ) {
-                    sqlite3_finalize(stmt);
-                    pub_close(storage);
-                    return rc;
+                if( !node ) {
+                    const str_lit_val_t val = (str_lit_val_t)sqlite3_column_text(stm, IDX_O_TEXT);
+                    const str_lang_t lang = (str_lang_t)column_language(stm, IDX_O_LANGUAGE);
+                    const str_uri_t uri = column_uri_string(stm, IDX_O_DATATYPE);
+                    librdf_uri *t = uri ? librdf_new_uri(w, uri) : NULL;
+                    node = librdf_new_node_from_typed_literal(w, val, lang, t);
+                    librdf_free_uri(t);
                 }
-                sqlite3_finalize(stmt);
-                assert(v + 1 == v_new && "invalid schema version after migration.");
+                if( !node )
+                    return NULL;
+                librdf_statement_set_object(st, node);
             }
+            assert(librdf_statement_is_complete(st) && "found statement must be complete");
+            assert( ( (NULL == ctx->pattern) || librdf_statement_match(st, ctx->pattern) ) && "match candidate doesn't match." );
+            assert(st == ctx->statement && "mismatch.");
+            ctx->dirty = false;
+            TIMER_STOP(db_ctx, NEW_NODE);
+            span_phase(db_ctx, &(ctx->span), LIBRDF_STORAGE_SQLITE_MRO_PHASE_MATERIALISE);
         }
-        if( SQLITE_OK != ( rc = transaction_commit(storage, begin) ) ) {
-            pub_close(storage);
-            return rc;
-        }
+        assert(librdf_statement_is_complete(ctx->statement) && "found statement must be complete");
+        assert( ( (NULL == ctx->pattern) || librdf_statement_match(ctx->statement, ctx->pattern) ) && "match candidate doesn't match." );
+        return ctx->statement;
+    }
+    case LIBRDF_ITERATOR_GET_METHOD_GET_CONTEXT:
+        return ctx->context;
+    default:
+        librdf_log(get_world(ctx->storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "Unknown iterator method flag %d", flags);
+        return NULL;
     }
+    return NULL;
+}
+
+
+static void pub_iter_finished(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    iterator_t *ctx = (iterator_t *)_ctx;
+    span_record(ctx->storage, &(ctx->span), LIBRDF_STORAGE_SQLITE_MRO_OP_FIND, ctx->params, ctx->rows, ctx->pattern, ctx->context, ctx->cached);
+    librdf_storage *storage = ctx->storage;
+    instance_t *db_ctx = get_instance(storage);
+    db_ctx->iterators--;
+    db_ctx->iterator_bytes -= sizeof(*ctx);
+
+    // recycle the statements, the compiled SQL and the iterator itself, they all belong to the storage
+    statement_shell_release(db_ctx, ctx->pattern);
+    statement_shell_release(db_ctx, ctx->statement);
+    transaction_rollback(storage, ctx->txn);
+    find_stmt_release(db_ctx, ctx->params, ctx->stmt);
+    pool_release(db_ctx, ctx);
+    librdf_storage_remove_reference(storage);
+}
+
+
+typedef struct
+{
+    librdf_storage *storage;
+    librdf_node *context;
+
+    sqlite3_stmt *stmt;
+    sqlite_rc_t rc;
+    bool dirty;
+}
+context_iterator_t;
+
+// pool_alloc hands out POOL_SLOT_SIZE bytes, checked at compile time as asserts may be off
+typedef char context_iterator_fits_pool_slot[sizeof(context_iterator_t) <= POOL_SLOT_SIZE ? 1 : -1];
+
+
+static int context_iter_is_end(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    context_iterator_t *ctx = (context_iterator_t *)_ctx;
+    return SQLITE_ROW != ctx->rc;
+}
+
+
+static int context_iter_get_next(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    context_iterator_t *ctx = (context_iterator_t *)_ctx;
+    if( context_iter_is_end(ctx) )
+        return RET_ERROR;
+    ctx->dirty = true;
+    ctx->rc = sqlite3_step(ctx->stmt);
+    if( context_iter_is_end(ctx) )
+        return RET_ERROR;
     return RET_OK;
 }
 
 
-/**
- * librdf_storage_sqlite_get_feature:
- * @storage: #librdf_storage object
- * @feature: #librdf_uri feature property
- *
- * Get the value of a storage feature.
+static void *context_iter_get_context(void *_ctx, const int _flags)
+{
+    assert(_ctx && "context mustn't be NULL");
+    const librdf_iterator_get_method_flags flags = (librdf_iterator_get_method_flags)_flags;
+    context_iterator_t *ctx = (context_iterator_t *)_ctx;
+
+    switch( flags ) {
+    case LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT:
+        break;
+    case LIBRDF_ITERATOR_GET_METHOD_GET_CONTEXT:
+        return NULL;
+    default:
+        librdf_log(get_world(ctx->storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "Unknown iterator method flag %d", flags);
+        return NULL;
+    }
+
+    if( ctx->dirty && !context_iter_is_end(_ctx) ) {
+        librdf_world *w = get_world(ctx->storage);
+        sqlite3_stmt *stm = ctx->stmt;
+        librdf_node *node = NULL;
+        const str_uri_t uri = column_uri_string(stm, 0);
+        if( uri )
+            node = librdf_new_node_from_uri_string(w, uri);
+        if( ctx->context )
+            librdf_free_node(ctx->context);
+
+        ctx->context = node;
+        ctx->dirty = false;
+    }
+
+    return ctx->context;
+}
+
+
+static void context_iter_finished(void *_ctx)
+{
+    assert(_ctx && "context mustn't be NULL");
+    context_iterator_t *ctx = (context_iterator_t *)_ctx;
+    if( ctx->context )
+        librdf_free_node(ctx->context);
+    librdf_storage *storage = ctx->storage;
+    instance_t *db_ctx = get_instance(storage);
+    db_ctx->iterators--;
+    db_ctx->iterator_bytes -= sizeof(*ctx);
+
+    sqlite3_finalize(ctx->stmt);
+    pool_release(db_ctx, ctx);
+    librdf_storage_remove_reference(storage);
+}
+
+
+#pragma mark Query & Iterate
+
+
+static const char find_triples_sql[] = // generated via tools/sql2c.sh find_triples.sql
+    " -- result columns must match as in enum idx_triple_column_t" "\n" \
+    "SELECT" "\n" \
+    " -- all *_id (hashes):" "\n" \
+    "  id" "\n" \
+    "  ,s_uri_id" "\n" \
+    "  ,s_blank_id" "\n" \
+    "  ,p_uri_id" "\n" \
+    "  ,o_uri_id" "\n" \
+    "  ,o_blank_id" "\n" \
+    "  ,o_lit_id" "\n" \
+    "  ,o_datatype_id" "\n" \
+    "  ,c_uri_id" "\n" \
+    " -- all values:" "\n" \
+    "  ,s_uri" "\n" \
+    "  ,s_blank" "\n" \
+    "  ,p_uri" "\n" \
+    "  ,o_uri" "\n" \
+    "  ,o_blank" "\n" \
+    "  ,o_text" "\n" \
+    "  ,o_language" "\n" \
+    "  ,o_datatype" "\n" \
+    "  ,c_uri" "\n" \
+    "FROM triples" "\n" \
+    "WHERE 1" "\n" \
+    " -- subject" "\n" \
+    "AND s_uri_id   = :s_uri_id" "\n" \
+    "AND s_blank_id = :s_blank_id" "\n" \
+    "AND p_uri_id   = :p_uri_id" "\n" \
+    " -- object" "\n" \
+    "AND o_uri_id   = :o_uri_id" "\n" \
+    "AND o_blank_id = :o_blank_id" "\n" \
+    "AND o_lit_id   = :o_lit_id" "\n" \
+    " -- context node" "\n" \
+    "AND c_uri_id   = :c_uri_id" "\n" \
+;
+
+
+/** Copy find_triples_sql into sql and comment out the terms not in params.
  *
- * Return value: #librdf_node feature value or NULL if no such feature
- * exists or the value is empty.
- **/
-static librdf_node *pub_get_feature(librdf_storage *storage, librdf_uri *feature)
+ * @param sql working copy (e.g. on stack), at least sizeof(find_triples_sql).
+ */
+static void sculpt_find_triples_sql(const sql_find_param_t params, char *sql)
 {
-    assert(storage && "storage must be set");
-    if( !feature )
+    memcpy( sql, find_triples_sql, sizeof(find_triples_sql) );
+    // sculpt the SQL instead building it: comment out the NULL parameter terms
+    if( 0 == (P_S_URI & params) )
+        strncpy(strstr(sql, "AND s_uri_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND s_uri_id' not found in find_triples.sql");
+    if( 0 == (P_S_BLANK & params) )
+        strncpy(strstr(sql, "AND s_blank_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND s_blank_id' not found in find_triples.sql");
+    if( 0 == (P_P_URI & params) )
+        strncpy(strstr(sql, "AND p_uri_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND p_uri_id' not found in find_triples.sql");
+    if( 0 == (P_O_URI & params) )
+        strncpy(strstr(sql, "AND o_uri_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND o_uri_id' not found in find_triples.sql");
+    if( 0 == (P_O_BLANK & params) )
+        strncpy(strstr(sql, "AND o_blank_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND o_blank_id' not found in find_triples.sql");
+    if( 0 == (P_O_TEXT & params) )
+        strncpy(strstr(sql, "AND o_lit_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND o_lit_id' not found in find_triples.sql");
+    if( 0 == (P_C_URI & params) )
+        strncpy(strstr(sql, "AND c_uri_id"), "-- ", 3);
+    assert('-' != sql[0] && "'AND c_uri_id' not found in find_triples.sql");
+}
+
+
+static int pub_size(librdf_storage *storage)
+{
+    instance_t *db_ctx = get_instance(storage);
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+    const bool cached = NULL != db_ctx->stmt_size;
+    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_size), "SELECT COUNT(id) FROM triple_relations");
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+    const sqlite_rc_t rc = sqlite3_step(stmt);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    span_record(storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_SIZE, -1, 1, NULL, NULL, cached);
+    return SQLITE_ROW == rc ? sqlite3_column_int(stmt, 0) : -1;
+}
+
+
+static librdf_iterator *pub_get_contexts(librdf_storage *storage)
+{
+    instance_t *db_ctx = get_instance(storage);
+
+    context_iterator_t *iter = (context_iterator_t *)pool_alloc( db_ctx, sizeof(context_iterator_t) );
+    if( !iter )
         return NULL;
-    const char *feat = (char *)librdf_uri_as_string(feature);
-    if( !feat )
+    iter->storage = storage;
+    iter->stmt = prep_stmt(db_ctx->db, &(iter->stmt), db_ctx->uri_prefixes
+                           ? "SELECT ns_uris.prefix || c_uris.uri FROM c_uris INNER JOIN ns_uris ON c_uris.ns_id = ns_uris.id"
+                           : "SELECT uri FROM c_uris");
+    if( !iter->stmt ) {
+        pool_release(db_ctx, iter);
         return NULL;
+    }
+    iter->rc = sqlite3_step(iter->stmt);
+    iter->dirty = true;
+    db_ctx->iterators++;
+    db_ctx->iterator_bytes += sizeof(*iter);
+    librdf_storage_add_reference(iter->storage);
+
+    librdf_iterator *iterator = librdf_new_iterator(get_world(storage), iter, &context_iter_is_end, &context_iter_get_next, &context_iter_get_context, &context_iter_finished);
+    if( !iterator ) {
+        context_iter_finished(iter);
+    }
+    return iterator;
+}
+
+
+static int pub_contains_statement(librdf_storage *storage, librdf_statement *statement)
+{
+    return NULL != find_statement(storage, NULL, statement, false);
+}
+
+
+/** The pattern shape, i.e. the bitmask of parameters to set (non-NULL). */
+static sql_find_param_t find_params(librdf_statement *statement, librdf_node *context_node)
+{
+    librdf_node *s = statement ? librdf_statement_get_subject(statement) : NULL;
+    librdf_node *p = statement ? librdf_statement_get_predicate(statement) : NULL;
+    librdf_node *o = statement ? librdf_statement_get_object(statement) : NULL;
+
+    const int params = 0
+                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(s) ? P_S_URI : 0)
+                       | (LIBRDF_NODE_TYPE_BLANK == node_type(s) ? P_S_BLANK : 0)
+                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(p) ? P_P_URI : 0)
+                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(o) ? P_O_URI : 0)
+                       | (LIBRDF_NODE_TYPE_BLANK == node_type(o) ? P_O_BLANK : 0)
+                       | (LIBRDF_NODE_TYPE_LITERAL == node_type(o) ? P_O_TEXT : 0)
+                       | (NULL != literal_type_uri(o) ? P_O_DATATYPE : 0)
+                       | (NULL != literal_language(o) ? P_O_LANGUAGE : 0)
+                       | (context_node ? P_C_URI : 0)
+    ;
+    assert(params <= ALL_PARAMS && "params bitmask overflow");
+    return (sql_find_param_t)params;
+}
+
+
+/** The compiled find statement of the shape, from the cache if possible. Release with find_stmt_release. */
+static sqlite3_stmt *find_stmt_prepare(librdf_storage *storage, const sql_find_param_t params, bool *cached)
+{
     instance_t *db_ctx = get_instance(storage);
+    sqlite3_stmt *stmt = find_stmt_take(db_ctx, params);
+    *cached = NULL != stmt;
+    if( !stmt ) {
+        char sql[sizeof(find_triples_sql)];
+        sculpt_find_triples_sql(params, sql);
+        librdf_log(librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "Created SQL statement #%d", params);
+        prep_stmt(db_ctx->db, &stmt, sql);
+    } // else if( false ) {
+      // toggle via "profile" feature?
+      // librdf_log( librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "%s", librdf_statement_to_string(statement) );
+      // }
+    return stmt;
+}
 
-    librdf_node *ret = NULL;
-    librdf_uri *uri_xsd_boolean = librdf_new_uri(get_world(storage), (str_uri_t)"http://www.w3.org/2000/10/XMLSchema#" "boolean");
-    librdf_uri *uri_xsd_unsignedShort = librdf_new_uri(get_world(storage), (str_uri_t)"http://www.w3.org/2000/10/XMLSchema#" "unsignedShort");
 
-    if( !ret && 0 == strcmp(LIBRDF_MODEL_FEATURE_CONTEXTS, feat) )
-        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(true ? "1" : "0"), NULL, uri_xsd_boolean);
-    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE, feat ) )
-        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->do_profile ? "true" : "false"), NULL, uri_xsd_boolean);
-    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN, (char *)feat ) )
-        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_lit_val_t)(db_ctx->do_explain_query_plan ? "true" : "false"), NULL, uri_xsd_boolean);
-    if( !ret && 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK, feat ) ) {
-        char buf[10];
-        snprintf(buf, sizeof(buf) - 1, "%d", db_ctx->sql_cache_mask);
-        ret = librdf_new_node_from_typed_literal(get_world(storage), (str_uri_t)buf, NULL, uri_xsd_unsignedShort);
+static librdf_stream *pub_context_find_statements(librdf_storage *storage, librdf_statement *statement, librdf_node *context_node)
+{
+    const sql_find_param_t params = find_params(statement, context_node);
+    const sqlite_rc_t begin = RET_ERROR; // transaction_start(storage);
+    instance_t *db_ctx = get_instance(storage);
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+
+    bool cached = false;
+    sqlite3_stmt *stmt = find_stmt_prepare(storage, params, &cached);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+
+    TIMER_DECL;
+    const sqlite_rc_t rc = TIMED(db_ctx, BIND, bind_stmt(db_ctx, statement, context_node, stmt) );
+    assert(SQLITE_OK == rc && "find_statements: failed to bind SQL parameters");
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+
+    if( db_ctx->do_explain_query_plan ) {
+        librdf_log(librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "Execute SQL statement #%d", params);
+        printExplainQueryPlan(stmt);
     }
+    librdf_world *w = get_world(storage);
+    // create iterator
+    iterator_t *iter = (iterator_t *)pool_alloc( db_ctx, sizeof(iterator_t) );
+    iter->storage = storage;
+    iter->context = context_node;
+    iter->pattern = statement_shell_copy(db_ctx, w, statement);
+    iter->stmt = stmt;
+    iter->txn = begin;
+    iter->params = params;
+    iter->cached = cached;
+    span_resume(db_ctx, &span); // don't count our own allocations
+    iter->rc = TIMED(db_ctx, STEP_FIND, sqlite3_step(stmt) );
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    iter->rows = SQLITE_ROW == iter->rc;
+    iter->span = span;
+    iter->statement = statement_shell(db_ctx, w);
+    iter->dirty = true;
+    db_ctx->iterators++;
+    db_ctx->iterator_bytes += sizeof(*iter);
 
-    librdf_free_uri(uri_xsd_boolean);
-    librdf_free_uri(uri_xsd_unsignedShort);
+    librdf_storage_add_reference(iter->storage);
+    librdf_stream *stream = librdf_new_stream(w, iter, &pub_iter_end_of_stream, &pub_iter_next_statement, &pub_iter_get_statement, &pub_iter_finished);
+
+    return stream;
+}
+
+
+static librdf_stream *pub_find_statements(librdf_storage *storage, librdf_statement *statement)
+{
+    return pub_context_find_statements(storage, statement, NULL);
+}
+
+
+static librdf_stream *pub_context_serialise(librdf_storage *storage, librdf_node *context_node)
+{
+    return pub_context_find_statements(storage, NULL, context_node);
+}
+
+
+static librdf_stream *pub_serialise(librdf_storage *storage)
+{
+    return pub_context_serialise(storage, NULL);
+}
+
+
+#pragma mark Visitor
+
+
+typedef librdf_storage_sqlite_mro_term term_t;
+
+
+/** Point term at the column, id 0 and value NULL if SQL NULL. */
+static inline void visit_term(term_t *term, sqlite3_stmt *stmt, const idx_triple_column_t id_col, const idx_triple_column_t col, const librdf_storage_sqlite_mro_term_type type)
+{
+    term->value = sqlite3_column_text(stmt, col);
+    if( !term->value )
+        return;
+    term->type = type;
+    term->length = sqlite3_column_bytes(stmt, col);
+    term->id = (unsigned long long)sqlite3_column_int64(stmt, id_col);
+}
+
+
+int librdf_storage_sqlite_mro_for_each_match(librdf_storage *storage, librdf_statement *pattern, librdf_node *context_node, librdf_storage_sqlite_mro_visitor visitor, void *user_data)
+{
+    assert(storage && "storage must be set.");
+    assert(visitor && "visitor must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx || !db_ctx->db )
+        return RET_ERROR;
+    const sql_find_param_t params = find_params(pattern, context_node);
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+
+    bool cached = false;
+    sqlite3_stmt *stmt = find_stmt_prepare(storage, params, &cached);
+    if( !stmt )
+        return RET_ERROR;
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+    TIMER_DECL;
+    sqlite_rc_t rc = TIMED(db_ctx, BIND, bind_stmt(db_ctx, pattern, context_node, stmt) );
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+
+    sqlite3_uint64 rows = 0;
+    while( SQLITE_OK == rc || SQLITE_ROW == rc ) {
+        if( SQLITE_ROW != ( rc = TIMED(db_ctx, STEP_FIND, sqlite3_step(stmt) ) ) )
+            break;
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+        rows++;
+        // stmt columns refer to find_triples_sql
+        librdf_storage_sqlite_mro_row row;
+        memset( &row, 0, sizeof(row) );
+        row.id = (unsigned long long)sqlite3_column_int64(stmt, IDX_ID);
+        visit_term(&row.subject, stmt, IDX_S_URI_ID, IDX_S_URI, LIBRDF_STORAGE_SQLITE_MRO_TERM_URI);
+        if( !row.subject.value )
+            visit_term(&row.subject, stmt, IDX_S_BLANK_ID, IDX_S_BLANK, LIBRDF_STORAGE_SQLITE_MRO_TERM_BLANK);
+        visit_term(&row.predicate, stmt, IDX_P_URI_ID, IDX_P_URI, LIBRDF_STORAGE_SQLITE_MRO_TERM_URI);
+        visit_term(&row.object, stmt, IDX_O_URI_ID, IDX_O_URI, LIBRDF_STORAGE_SQLITE_MRO_TERM_URI);
+        if( !row.object.value )
+            visit_term(&row.object, stmt, IDX_O_BLANK_ID, IDX_O_BLANK, LIBRDF_STORAGE_SQLITE_MRO_TERM_BLANK);
+        if( !row.object.value ) {
+            visit_term(&row.object, stmt, IDX_O_LIT_ID, IDX_O_TEXT, LIBRDF_STORAGE_SQLITE_MRO_TERM_LITERAL);
+            row.language = sqlite3_column_text(stmt, IDX_O_LANGUAGE);
+            row.language_length = sqlite3_column_bytes(stmt, IDX_O_LANGUAGE);
+            visit_term(&row.datatype, stmt, IDX_O_DATATYPE_ID, IDX_O_DATATYPE, LIBRDF_STORAGE_SQLITE_MRO_TERM_URI);
+        }
+        visit_term(&row.context, stmt, IDX_C_URI_ID, IDX_C_URI, LIBRDF_STORAGE_SQLITE_MRO_TERM_URI);
+        span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_MATERIALISE);
+        const int stop = visitor(user_data, &row);
+        span_resume(db_ctx, &span); // don't count the visitor
+        if( stop ) {
+            rc = SQLITE_DONE;
+            break;
+        }
+    }
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    span_record(storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_FIND, params, rows, pattern, context_node, cached);
+    const sqlite_rc_t ret = SQLITE_DONE == rc ? RET_OK : log_error(db_ctx->db, sqlite3_sql(stmt), rc);
+    find_stmt_release(db_ctx, params, stmt);
     return ret;
 }
 
 
-/**
- * librdf_storage_set_feature:
- * @storage: #librdf_storage object
- * @feature: #librdf_uri feature property
- * @value: #librdf_node feature property value
- *
- * Set the value of a storage feature.
+#pragma mark Add
+
+
+static int pub_context_add_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement)
+{
+    if( !storage )
+        return RET_ERROR;
+    if( read_only_refused(storage, "add") )
+        return RET_ERROR;
+    if( !statement )
+        return RET_OK;
+    // librdf_log( librdf_storage_get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "%s", librdf_statement_to_string(statement) );
+    if( NULL == find_statement(storage, context_node, statement, true) )
+        return RET_ERROR;
+    stats_maintain(get_instance(storage), false);
+    return RET_OK;
+}
+
+
+/** Add up to batch_size statements, copy them to retry if non-NULL.
  *
- * Return value: non 0 on failure (negative if no such feature)
- **/
-static int pub_set_feature(librdf_storage *storage, librdf_uri *feature, librdf_node *value)
+ * Consumes the whole batch from the stream even after a failure, unless the policy is to abort anyway.
+ */
+static int add_statements_batch(librdf_storage *storage, librdf_node *context_node, librdf_stream *statement_stream, librdf_statement **retry, size_t *count)
 {
-    assert(storage && "storage must be set");
-    if( !feature )
-        return -1;
-    const char *feat = (char *)librdf_uri_as_string(feature);
-    if( !feat )
-        return -1;
-    const char *val = (char *)librdf_node_get_literal_value(value);
-    // librdf_log(get_world(storage), 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "pub_set_feature('%s', '%s')", feat, val);
+    instance_t *db_ctx = get_instance(storage);
+    int rc = RET_OK;
+    size_t i = 0;
+    for( ; i < db_ctx->batch_size && !librdf_stream_end(statement_stream); i++, librdf_stream_next(statement_stream) ) {
+        librdf_statement *stmt = librdf_stream_get_object(statement_stream);
+        if( retry )
+            retry[i] = stmt ? librdf_new_statement_from_statement(stmt) : NULL;
+        if( RET_OK == rc )
+            rc = pub_context_add_statement(storage, context_node, stmt);
+        else if( BATCH_ABORT == db_ctx->batch_policy )
+            break;
+    }
+    *count = i;
+    return rc;
+}
 
+
+/** Add in batches, each within a savepoint, and handle failing batches according to batch_policy.
+ */
+static int add_statements_batched(librdf_storage *storage, librdf_node *context_node, librdf_stream *statement_stream)
+{
     instance_t *db_ctx = get_instance(storage);
-    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK, feat ) ) {
-        if( 0 == strcmp("0", val) ) {
-            db_ctx->sql_cache_mask = 0;
-        } else {
-            char *end = NULL;
-            const long i = strtol(val, &end, 10);
-            if( NULL == end || '\0' != *end ) {
-                librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:unsignedShort", feat, val);
-                return 3;
+    librdf_statement **retry = NULL;
+    if( BATCH_RETRY == db_ctx->batch_policy && !( retry = LIBRDF_CALLOC(librdf_statement * *, db_ctx->batch_size, sizeof(*retry)) ) )
+        return RET_ERROR;
+    int rc = RET_OK;
+    for( size_t batch = 0; RET_OK == rc && !librdf_stream_end(statement_stream); batch++ ) {
+        const sqlite3_uint64 inserted = db_ctx->count_inserted;
+        const sqlite3_uint64 ignored = db_ctx->count_ignored;
+        const sqlite_rc_t sp = transaction_start(storage);
+        if( SQLITE_OK != sp ) {
+            rc = sp;
+            break;
+        }
+        size_t count = 0;
+        rc = add_statements_batch(storage, context_node, statement_stream, retry, &count);
+        if( RET_OK != rc && retry ) {
+            transaction_rollback(storage, sp);
+            db_ctx->count_inserted = inserted;
+            db_ctx->count_ignored = ignored;
+            if( SQLITE_OK != ( rc = transaction_start(storage) ) )
+                break;
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL, "retrying batch #%zu", batch);
+            for( size_t i = 0; i < count && RET_OK == rc; i++ )
+                rc = pub_context_add_statement(storage, context_node, retry[i]);
+        }
+        if( retry )
+            for( size_t i = 0; i < count; i++ ) {
+                librdf_free_statement(retry[i]);
+                retry[i] = NULL;
             }
-            db_ctx->sql_cache_mask = ALL_PARAMS & i; // clip range
+        if( RET_OK == rc ) {
+            rc = transaction_commit(storage, sp);
+            continue;
         }
-        // librdf_log(NULL, 0, LIBRDF_LOG_DEBUG, LIBRDF_FROM_STORAGE, NULL, "good value: <%s> \"%d\"^^xsd:unsignedShort", feat, db_ctx->sql_cache_mask);
-        return 0;
-    }
-
-    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE, feat ) ) {
-        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) ) {
-            db_ctx->do_profile = true;
-            if( db_ctx->db )
-                sqlite3_profile(db_ctx->db, &profile, storage);
-        } else if( 0 == strcmp("0", val) || 0 == strcmp("false", val) ) {
-            db_ctx->do_profile = false;
-            if( db_ctx->db )
-                sqlite3_profile(db_ctx->db, NULL, NULL);
-        } else {
-            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
-            return 2;
+        transaction_rollback(storage, sp);
+        db_ctx->count_inserted = inserted;
+        db_ctx->count_ignored = ignored;
+        if( BATCH_SKIP == db_ctx->batch_policy ) {
+            librdf_log(get_world(storage), 0, LIBRDF_LOG_WARN, LIBRDF_FROM_STORAGE, NULL, "skipped batch #%zu of %zu statements, error %d", batch, count, rc);
+            rc = RET_OK;
         }
-        return 0;
     }
+    if( retry )
+        LIBRDF_FREE(librdf_statement * *, retry);
+    return rc;
+}
 
-    if( 0 == strcmp( (char *)LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN, feat ) ) {
-        if( 0 == strcmp("1", val) || 0 == strcmp("true", val) )
-            db_ctx->do_explain_query_plan = true;
-        else if( 0 == strcmp("0", val) || 0 == strcmp("false", val) )
-            db_ctx->do_explain_query_plan = false;
-        else {
-            librdf_log(NULL, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "invalid value: <%s> \"%s\"^^xsd:boolean", feat, val);
-            return 2;
-        }
-        return 0;
+
+static int pub_context_add_statements(librdf_storage *storage, librdf_node *context_node, librdf_stream *statement_stream)
+{
+    if( read_only_refused(storage, "add") )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(storage);
+    const sqlite3_uint64 inserted = db_ctx->count_inserted;
+    const sqlite3_uint64 ignored = db_ctx->count_ignored;
+    const sqlite_rc_t txn = transaction_start(storage);
+    int rc = RET_OK;
+    if( db_ctx->batch_size > 0 )
+        rc = add_statements_batched(storage, context_node, statement_stream);
+    else
+        for( ; RET_OK == rc && !librdf_stream_end(statement_stream); librdf_stream_next(statement_stream) )
+            rc = pub_context_add_statement( storage, context_node, librdf_stream_get_object(statement_stream) );
+    if( RET_OK == rc ) {
+        rc = transaction_commit(storage, txn);
+        if( SQLITE_OK == rc )
+            stats_maintain(db_ctx, true);
+        return rc;
     }
-    return 1;
+    if( SQLITE_OK == txn && SQLITE_OK == transaction_rollback(storage, txn) ) {
+        db_ctx->count_inserted = inserted;
+        db_ctx->count_ignored = ignored;
+    }
+    return rc;
+}
+
+
+static int pub_add_statement(librdf_storage *storage, librdf_statement *statement)
+{
+    return pub_context_add_statement(storage, NULL, statement);
 }
 
 
-#pragma mark Transactions
+static int pub_add_statements(librdf_storage *storage, librdf_stream *statement_stream)
+{
+    return pub_context_add_statements(storage, NULL, statement_stream);
+}
 
 
-static sqlite_rc_t pub_transaction_start(librdf_storage *storage)
+#pragma mark Remove
+
+
+static int pub_context_remove_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement)
 {
-    return transaction_start(storage);
+    if( !statement )
+        return RET_OK;
+    if( !librdf_statement_is_complete(statement) )
+        return RET_ERROR;
+    assert(storage && "must be set");
+    if( read_only_refused(storage, "remove") )
+        return RET_ERROR;
+
+    instance_t *db_ctx = get_instance(storage);
+    TIMER_DECL;
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+
+    TIMER_START();
+    const hash_t stmt_id = stmt_hash(statement, context_node, db_ctx->digest);
+    TIMER_STOP(db_ctx, HASH);
+    assert(!isNULL_ID(stmt_id) && "mustn't be nil");
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_HASH);
+
+    const bool cached = NULL != db_ctx->stmt_triple_delete;
+    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_delete), "DELETE FROM triples WHERE id = :stmt_id");
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+    {
+        const sqlite_rc_t rc = bind_int(stmt, ":stmt_id", stmt_id);
+        if( SQLITE_OK != rc )
+            return rc;
+    }
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+    const sqlite_rc_t rc = TIMED(db_ctx, STEP_DELETE, sqlite3_step(stmt) );
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    span_record(storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_REMOVE, -1, SQLITE_DONE == rc ? sqlite3_changes(db_ctx->db) : 0, statement, context_node, cached);
+    if( SQLITE_DONE != rc )
+        return rc;
+    stats_maintain(db_ctx, false);
+    return RET_OK;
 }
 
 
-static sqlite_rc_t pub_transaction_commit(librdf_storage *storage)
+static int pub_remove_statement(librdf_storage *storage, librdf_statement *statement)
 {
-    return transaction_commit(storage, SQLITE_OK);
+    return pub_context_remove_statement(storage, NULL, statement);
 }
 
 
-static sqlite_rc_t pub_transaction_rollback(librdf_storage *storage)
+#if 0
+static int pub_context_remove_statements(librdf_storage *storage, librdf_node *context_node)
 {
-    return transaction_rollback(storage, SQLITE_OK);
+    const sqlite_rc_t txn = transaction_start(storage);
+    for( librdf_statement *stmt = librdf_stream_get_object(statement_stream); !librdf_stream_end(statement_stream); librdf_stream_next(statement_stream) ) {
+        const int rc = pub_context_remove_statement(storage, context_node, stmt);
+        if( RET_OK != rc ) {
+            transaction_rollback(storage, txn);
+            return rc;
+        }
+    }
+    return transaction_commit(storage, txn);
 }
 
 
-#pragma mark Iterator
+#endif
+
+
+#pragma mark Bulk Load
 
 
 typedef struct
 {
     librdf_storage *storage;
-    librdf_statement *pattern;
-    librdf_statement *statement;
-    librdf_node *context;
-
-    sqlite3_stmt *stmt;
-    sqlite_rc_t txn;
+    raptor_parser *parser;
     sqlite_rc_t rc;
-    bool dirty;
 }
-iterator_t;
+loader_t;
 
 
-static int pub_iter_end_of_stream(void *_ctx)
+static void load_statement_handler(void *user_data, raptor_statement *statement)
 {
-    assert(_ctx && "context mustn't be NULL");
-    iterator_t *ctx = (iterator_t *)_ctx;
-    return SQLITE_ROW != ctx->rc;
+    loader_t *ld = (loader_t *)user_data;
+    if( SQLITE_OK != ld->rc )
+        return;
+    instance_t *db_ctx = get_instance(ld->storage);
+    metric_span_t span = {
+        0
+    };
+    span_resume(db_ctx, &span);
+    const bool cached = NULL != db_ctx->stmt_triple_insert;
+    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_insert), insert_triple_sql);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE);
+    TIMER_DECL;
+    sqlite_rc_t rc = TIMED(db_ctx, BIND, bind_raptor_stmt(db_ctx, statement, stmt) );
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND);
+    if( SQLITE_OK == rc )
+        rc = step_insert(db_ctx, stmt);
+    span_phase(db_ctx, &span, LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP);
+    span_record(ld->storage, &span, LIBRDF_STORAGE_SQLITE_MRO_OP_ADD, -1, SQLITE_DONE == rc, NULL, NULL, cached);
+    if( SQLITE_DONE == rc )
+        return;
+    ld->rc = log_error(db_ctx->db, insert_triple_sql, SQLITE_OK == rc ? SQLITE_ERROR : rc);
+    raptor_parser_parse_abort(ld->parser);
 }
 
 
-static int pub_iter_next_statement(void *_ctx)
+int librdf_storage_sqlite_mro_load_file(librdf_storage *storage, const char *path, const char *syntax)
 {
-    assert(_ctx && "context mustn't be NULL");
-    iterator_t *ctx = (iterator_t *)_ctx;
-    if( pub_iter_end_of_stream(ctx) )
+    assert(storage && "storage must be set.");
+    if( !path )
         return RET_ERROR;
-    ctx->dirty = true;
-    ctx->rc = sqlite3_step(ctx->stmt);
-    if( pub_iter_end_of_stream(ctx) )
+    if( read_only_refused(storage, "load") )
         return RET_ERROR;
-    return RET_OK;
+    librdf_world *world = get_world(storage);
+    raptor_world *rw = librdf_world_get_raptor(world);
+
+    loader_t ld = {
+        .storage = storage,
+        .parser = raptor_new_parser(rw, syntax ? syntax : "guess"),
+        .rc = SQLITE_OK
+    };
+    if( !ld.parser ) {
+        librdf_log(world, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "no raptor parser '%s'", syntax ? syntax : "guess");
+        return RET_ERROR;
+    }
+    unsigned char *uri_str = raptor_uri_filename_to_uri_string(path);
+    raptor_uri *uri = uri_str ? raptor_new_uri(rw, uri_str) : NULL;
+    raptor_free_memory(uri_str);
+    if( !uri ) {
+        raptor_free_parser(ld.parser);
+        return RET_ERROR;
+    }
+    raptor_parser_set_statement_handler(ld.parser, &ld, &load_statement_handler);
+
+    instance_t *db_ctx = get_instance(storage);
+    const sqlite3_uint64 inserted = db_ctx->count_inserted;
+    const sqlite3_uint64 ignored = db_ctx->count_ignored;
+    const sqlite_rc_t txn = transaction_start(storage);
+    const int err = raptor_parser_parse_file(ld.parser, uri, NULL);
+    raptor_free_uri(uri);
+    raptor_free_parser(ld.parser);
+    if( err || SQLITE_OK != ld.rc ) {
+        if( SQLITE_OK == txn && SQLITE_OK == transaction_rollback(storage, txn) ) {
+            db_ctx->count_inserted = inserted;
+            db_ctx->count_ignored = ignored;
+        }
+        return SQLITE_OK != ld.rc ? ld.rc : RET_ERROR;
+    }
+    const sqlite_rc_t rc = transaction_commit(storage, txn);
+    if( SQLITE_OK == rc )
+        stats_maintain(db_ctx, true);
+    return rc;
 }
 
 
-static void *pub_iter_get_statement(void *_ctx, const int _flags)
-{
-    assert(_ctx && "context mustn't be NULL");
-    const librdf_iterator_get_method_flags flags = (librdf_iterator_get_method_flags)_flags;
-    iterator_t *ctx = (iterator_t *)_ctx;
+#pragma mark Counters
 
-    switch( flags ) {
-    case LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT: {
-        if( ctx->dirty && !pub_iter_end_of_stream(_ctx) ) {
-            assert(ctx->statement && "statement mustn't be NULL");
-            librdf_world *w = get_world(ctx->storage);
-            librdf_statement *st = ctx->statement;
-            sqlite3_stmt *stm = ctx->stmt;
-            librdf_statement_clear(st);
-            // stmt columns refer to find_triples_sql
-            {
-                /* subject */
-                librdf_node *node = NULL;
-                const str_uri_t uri = column_uri_string(stm, IDX_S_URI);
-                if( uri ) {
-                    assert('\0' != uri[0] && "empty uri");
-                    node = librdf_new_node_from_uri_string(w, uri);
-                }
-                if( !node ) {
-                    const str_blank_t blank = column_blank_string(stm, IDX_S_BLANK);
-                    if( blank ) {
-                        assert('\0' != blank[0] && "empty blank");
-                        node = librdf_new_node_from_blank_identifier(w, blank);
-                    }
-                }
-                if( !node )
-                    return NULL;
-                librdf_statement_set_subject(st, node);
-            }
-            {
-                /* predicate */
-                librdf_node *node = NULL;
-                const str_uri_t uri = column_uri_string(stm, IDX_P_URI);
-                if( uri )
-                    node = librdf_new_node_from_uri_string(w, uri);
-                if( !node )
-                    return NULL;
-                librdf_statement_set_predicate(st, node);
-            }
-            {
-                /* object */
-                librdf_node *node = NULL;
-                const str_uri_t uri = column_uri_string(stm, IDX_O_URI);
-                if( uri )
-                    node = librdf_new_node_from_uri_string(w, uri);
-                if( !node ) {
-                    const str_blank_t blank = column_blank_string(stm, IDX_O_BLANK);
-                    if( blank )
-                        node = librdf_new_node_from_blank_identifier(w, blank);
-                }
-                if( !node ) {
-                    const str_lit_val_t val = (str_lit_val_t)sqlite3_column_text(stm, IDX_O_TEXT);
-                    const str_lang_t lang = (str_lang_t)column_language(stm, IDX_O_LANGUAGE);
-                    const str_uri_t uri = column_uri_string(stm, IDX_O_DATATYPE);
-                    librdf_uri *t = uri ? librdf_new_uri(w, uri) : NULL;
-                    node = librdf_new_node_from_typed_literal(w, val, lang, t);
-                    librdf_free_uri(t);
-                }
-                if( !node )
-                    return NULL;
-                librdf_statement_set_object(st, node);
-            }
-            assert(librdf_statement_is_complete(st) && "found statement must be complete");
-            assert( ( (NULL == ctx->pattern) || librdf_statement_match(st, ctx->pattern) ) && "match candidate doesn't match." );
-            assert(st == ctx->statement && "mismatch.");
-            ctx->dirty = false;
-        }
-        assert(librdf_statement_is_complete(ctx->statement) && "found statement must be complete");
-        assert( ( (NULL == ctx->pattern) || librdf_statement_match(ctx->statement, ctx->pattern) ) && "match candidate doesn't match." );
-        return ctx->statement;
-    }
-    case LIBRDF_ITERATOR_GET_METHOD_GET_CONTEXT:
-        return ctx->context;
-    default:
-        librdf_log(get_world(ctx->storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "Unknown iterator method flag %d", flags);
-        return NULL;
+
+int librdf_storage_sqlite_mro_add_counts(librdf_storage *storage, unsigned long long *inserted, unsigned long long *ignored, const int reset)
+{
+    assert(storage && "storage must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx )
+        return RET_ERROR;
+    if( inserted )
+        *inserted = db_ctx->count_inserted;
+    if( ignored )
+        *ignored = db_ctx->count_ignored;
+    if( reset ) {
+        db_ctx->count_inserted = 0;
+        db_ctx->count_ignored = 0;
     }
-    return NULL;
+    return RET_OK;
 }
 
 
-static void pub_iter_finished(void *_ctx)
-{
-    assert(_ctx && "context mustn't be NULL");
-    iterator_t *ctx = (iterator_t *)_ctx;
-    if( ctx->pattern )
-        librdf_free_statement(ctx->pattern);
-    if( ctx->statement )
-        librdf_free_statement(ctx->statement);
-    librdf_storage_remove_reference(ctx->storage);
-    transaction_rollback(ctx->storage, ctx->txn);
-    sqlite3_finalize(ctx->stmt);
+#pragma mark Metrics API
 
-    LIBRDF_FREE(iterator_t *, ctx);
+
+const librdf_storage_sqlite_mro_metrics *librdf_storage_sqlite_mro_get_metrics(librdf_storage *storage)
+{
+    assert(storage && "storage must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    return db_ctx ? db_ctx->metrics : NULL;
 }
 
 
-typedef struct
+void librdf_storage_sqlite_mro_reset_metrics(librdf_storage *storage)
 {
-    librdf_storage *storage;
-    librdf_node *context;
+    assert(storage && "storage must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( db_ctx && db_ctx->metrics )
+        memset( db_ctx->metrics, 0, sizeof(*db_ctx->metrics) );
+}
 
-    sqlite3_stmt *stmt;
-    sqlite_rc_t rc;
-    bool dirty;
+
+unsigned long long librdf_storage_sqlite_mro_metric_percentile(const librdf_storage_sqlite_mro_metric *metric, const double percentile)
+{
+    if( !metric || 0 == metric->calls )
+        return 0;
+    const double p = percentile < 0.0 ? 0.0 : percentile > 1.0 ? 1.0 : percentile;
+    unsigned long long rank = (unsigned long long)(p * (double)metric->calls + 0.5);
+    if( rank < 1 )
+        rank = 1;
+    unsigned long long seen = 0;
+    for( int i = 0; i < LIBRDF_STORAGE_SQLITE_MRO_HISTOGRAM_BUCKETS; i++ ) {
+        seen += metric->histogram[i];
+        if( seen >= rank ) {
+            const sqlite3_uint64 ns = metric_bucket_ns(i);
+            return ns < metric->ns_max ? ns : metric->ns_max;
+        }
+    }
+    return metric->ns_max;
 }
-context_iterator_t;
 
 
-static int context_iter_is_end(void *_ctx)
+#pragma mark Slow Operation Log
+
+
+void librdf_storage_sqlite_mro_set_slow_handler(librdf_storage *storage, librdf_storage_sqlite_mro_slow_handler handler, void *user_data)
 {
-    assert(_ctx && "context mustn't be NULL");
-    context_iterator_t *ctx = (context_iterator_t *)_ctx;
-    return SQLITE_ROW != ctx->rc;
+    assert(storage && "storage must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx )
+        return;
+    db_ctx->slow_handler = handler;
+    db_ctx->slow_user_data = user_data;
 }
 
 
-static int context_iter_get_next(void *_ctx)
+#pragma mark Query Plans
+
+
+/** Garbage collection subqueries of the triples_delete trigger, EXPLAIN QUERY PLAN doesn't descend into triggers. */
+static const char *const query_plan_gc_sql[][2] = {
+    { "gc s_uri_id", "SELECT COUNT(id) FROM triple_relations WHERE s_uri_id = :id" },
+    { "gc s_blank_id", "SELECT COUNT(id) FROM triple_relations WHERE s_blank_id = :id" },
+    { "gc p_uri_id", "SELECT COUNT(id) FROM triple_relations WHERE p_uri_id = :id" },
+    { "gc o_uri_id", "SELECT COUNT(id) FROM triple_relations WHERE o_uri_id = :id" },
+    { "gc o_blank_id", "SELECT COUNT(id) FROM triple_relations WHERE o_blank_id = :id" },
+    { "gc o_lit_id", "SELECT COUNT(id) FROM triple_relations WHERE o_lit_id = :id" },
+    { "gc o_datatype_id", "SELECT COUNT(id) FROM o_literals WHERE datatype_id = :id" },
+    { "gc c_uri_id", "SELECT COUNT(id) FROM triple_relations WHERE c_uri_id = :id" },
+};
+
+
+int librdf_storage_sqlite_mro_query_plans(librdf_storage *storage, librdf_storage_sqlite_mro_query_plan **plans, int *count)
 {
-    assert(_ctx && "context mustn't be NULL");
-    context_iterator_t *ctx = (context_iterator_t *)_ctx;
-    if( context_iter_is_end(ctx) )
+    assert(storage && "storage must be set.");
+    assert(plans && "plans must be set.");
+    assert(count && "count must be set.");
+    *plans = NULL;
+    *count = 0;
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx || !db_ctx->db )
         return RET_ERROR;
-    ctx->dirty = true;
-    ctx->rc = sqlite3_step(ctx->stmt);
-    if( context_iter_is_end(ctx) )
+
+    const int gc_count = array_length(query_plan_gc_sql);
+    const int n = LIBRDF_STORAGE_SQLITE_MRO_SHAPES + 4 + gc_count;
+    librdf_storage_sqlite_mro_query_plan *ret = LIBRDF_CALLOC(librdf_storage_sqlite_mro_query_plan *, n, sizeof(librdf_storage_sqlite_mro_query_plan) );
+    if( !ret )
         return RET_ERROR;
+
+    sqlite_rc_t rc = SQLITE_OK;
+    int i = 0;
+    for( int shape = 0; SQLITE_OK == rc && shape < LIBRDF_STORAGE_SQLITE_MRO_SHAPES; shape++ ) {
+        char sql[sizeof(find_triples_sql)];
+        sculpt_find_triples_sql( (sql_find_param_t)shape, sql );
+        rc = query_plan_explain(db_ctx->db, "find", shape, sql, &ret[i++]);
+    }
+    if( SQLITE_OK == rc )
+        rc = query_plan_explain(db_ctx->db, "insert", -1, insert_triple_sql, &ret[i++]);
+    if( SQLITE_OK == rc )
+        rc = query_plan_explain(db_ctx->db, "delete", -1, "DELETE FROM triples WHERE id = :stmt_id", &ret[i++]);
+    if( SQLITE_OK == rc )
+        rc = query_plan_explain(db_ctx->db, "contains", -1, "SELECT id FROM triple_relations WHERE id = :stmt_id", &ret[i++]);
+    if( SQLITE_OK == rc )
+        rc = query_plan_explain(db_ctx->db, "size", -1, "SELECT COUNT(id) FROM triple_relations", &ret[i++]);
+    for( int g = 0; SQLITE_OK == rc && g < gc_count; g++ )
+        rc = query_plan_explain(db_ctx->db, query_plan_gc_sql[g][0], -1, query_plan_gc_sql[g][1], &ret[i++]);
+
+    if( SQLITE_OK != rc ) {
+        log_error(db_ctx->db, "EXPLAIN QUERY PLAN", rc);
+        librdf_storage_sqlite_mro_free_query_plans(ret, i);
+        return rc;
+    }
+    assert(n == i && "query plan count mismatch.");
+    *plans = ret;
+    *count = n;
     return RET_OK;
 }
 
 
-static void *context_iter_get_context(void *_ctx, const int _flags)
+void librdf_storage_sqlite_mro_free_query_plans(librdf_storage_sqlite_mro_query_plan *plans, const int count)
 {
-    assert(_ctx && "context mustn't be NULL");
-    const librdf_iterator_get_method_flags flags = (librdf_iterator_get_method_flags)_flags;
-    context_iterator_t *ctx = (context_iterator_t *)_ctx;
-
-    switch( flags ) {
-    case LIBRDF_ITERATOR_GET_METHOD_GET_OBJECT:
-        break;
-    case LIBRDF_ITERATOR_GET_METHOD_GET_CONTEXT:
-        return NULL;
-    default:
-        librdf_log(get_world(ctx->storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "Unknown iterator method flag %d", flags);
-        return NULL;
-    }
+    if( !plans )
+        return;
+    for( int i = 0; i < count; i++ )
+        free(plans[i].plan);
+    LIBRDF_FREE(librdf_storage_sqlite_mro_query_plan *, plans);
+}
 
-    if( ctx->dirty && !context_iter_is_end(_ctx) ) {
-        assert(ctx->context && "context mustn't be NULL");
-        librdf_world *w = get_world(ctx->storage);
-        sqlite3_stmt *stm = ctx->stmt;
-        librdf_node *node = NULL;
-        const str_uri_t uri = column_uri_string(stm, 0);
-        if( uri )
-            node = librdf_new_node_from_uri_string(w, uri);
-        if( ctx->context )
-            librdf_free_node(ctx->context);
 
-        ctx->context = node;
-        ctx->dirty = false;
-    }
+#pragma mark Export
 
-    return ctx->context;
+
+/** Output buffer, fwrite only when full. */
+typedef struct
+{
+    FILE *out;
+    size_t len;
+    bool failed;
+    unsigned char buf[1 << 18];
 }
+export_buf_t;
 
 
-static void context_iter_finished(void *_ctx)
+static void export_flush(export_buf_t *b)
 {
-    assert(_ctx && "context mustn't be NULL");
-    context_iterator_t *ctx = (context_iterator_t *)_ctx;
-    if( ctx->context )
-        librdf_free_node(ctx->context);
+    if( 0 == b->len || b->failed )
+        return;
+    b->failed = b->len != fwrite(b->buf, 1, b->len, b->out);
+    b->len = 0;
+}
 
-    librdf_storage_remove_reference(ctx->storage);
-    sqlite3_finalize(ctx->stmt);
 
-    LIBRDF_FREE(iterator_t *, ctx);
+static inline void export_put(export_buf_t *b, const unsigned char *str, const size_t len)
+{
+    if( b->len + len > sizeof(b->buf) )
+        export_flush(b);
+    if( len > sizeof(b->buf) ) {
+        b->failed = b->failed || len != fwrite(str, 1, len, b->out);
+        return;
+    }
+    memcpy(b->buf + b->len, str, len);
+    b->len += len;
 }
 
 
-#pragma mark Query & Iterate
+static inline void export_puts(export_buf_t *b, const char *str)
+{
+    export_put( b, (const unsigned char *)str, strlen(str) );
+}
 
 
-static int pub_size(librdf_storage *storage)
+static inline bool needs_escape_iri(const unsigned char c)
 {
-    instance_t *db_ctx = get_instance(storage);
-    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_size), "SELECT COUNT(id) FROM triple_relations");
-    const sqlite_rc_t rc = sqlite3_step(stmt);
-    return SQLITE_ROW == rc ? sqlite3_column_int(stmt, 0) : -1;
+    return c <= 0x20 || '<' == c || '>' == c || '"' == c || '{' == c || '}' == c || '|' == c || '^' == c || '`' == c || '\\' == c;
 }
 
 
-static librdf_iterator *pub_get_contexts(librdf_storage *storage)
+/** An IRIREF allows UCHAR escapes only, \n or \" (ECHAR) are for string literals. */
+static const char *iri_escape(const unsigned char c, char u[8])
 {
-    instance_t *db_ctx = get_instance(storage);
+    snprintf(u, 8, "\\u%04X", c);
+    return u;
+}
 
-    context_iterator_t *iter = LIBRDF_CALLOC(context_iterator_t*, sizeof(context_iterator_t), 1);
-    iter->storage = storage;
-    iter->stmt = prep_stmt(db_ctx->db, &(iter->stmt), "SELECT uri FROM c_uris");
-    if( !iter->stmt ) {
-        LIBRDF_FREE(context_iterator_t*, iter);
-        return NULL;
-    }
-    iter->rc = sqlite3_step(iter->stmt);
-    iter->dirty = true;
-    librdf_storage_add_reference(iter->storage);
 
-    librdf_iterator *iterator = librdf_new_iterator(get_world(storage), iter, &context_iter_is_end, &context_iter_get_next, &context_iter_get_context, &context_iter_finished);
-    if( !iterator ) {
-        context_iter_finished(iter);
+/** N-Triples escaping, copies runs of plain bytes in one go. UTF-8 passes through unchanged.
+ */
+static void export_put_escaped(export_buf_t *b, const unsigned char *str, const size_t len, bool (*needs_escape)(const unsigned char), const char *(*escape)(const unsigned char, char[8]))
+{
+    size_t run = 0;
+    for( size_t i = 0; i < len; i++ ) {
+        const unsigned char c = str[i];
+        if( !needs_escape(c) )
+            continue;
+        export_put(b, str + run, i - run);
+        run = i + 1;
+        char u[8];
+        export_puts( b, escape(c, u) );
     }
-    return iterator;
+    export_put(b, str + run, len - run);
 }
 
 
-static int pub_contains_statement(librdf_storage *storage, librdf_statement *statement)
+static void export_put_iri(export_buf_t *b, sqlite3_stmt *stmt, const int iCol)
 {
-    return NULL != find_statement(storage, NULL, statement, false);
+    export_puts(b, "<");
+    export_put_escaped( b, column_uri_string(stmt, iCol), sqlite3_column_bytes(stmt, iCol), &needs_escape_iri, &iri_escape );
+    export_puts(b, ">");
 }
 
 
-static librdf_stream *pub_context_find_statements(librdf_storage *storage, librdf_statement *statement, librdf_node *context_node)
+/** Plain in an N-Triples BLANK_NODE_LABEL, '_' is the escape. UTF-8 passes through unchanged. */
+static inline bool blank_label_plain(const unsigned char c, const bool first)
 {
-    librdf_node *s = librdf_statement_get_subject(statement);
-    librdf_node *p = librdf_statement_get_predicate(statement);
-    librdf_node *o = librdf_statement_get_object(statement);
+    return ( 'a' <= c && c <= 'z' ) || ( 'A' <= c && c <= 'Z' ) || ( '0' <= c && c <= '9' ) || c >= 0x80 || ( '-' == c && !first );
+}
 
-    // build the bitmask of parameters to set (non-NULL)
-    const int params = 0
-                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(s) ? P_S_URI : 0)
-                       | (LIBRDF_NODE_TYPE_BLANK == node_type(s) ? P_S_BLANK : 0)
-                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(p) ? P_P_URI : 0)
-                       | (LIBRDF_NODE_TYPE_RESOURCE == node_type(o) ? P_O_URI : 0)
-                       | (LIBRDF_NODE_TYPE_BLANK == node_type(o) ? P_O_BLANK : 0)
-                       | (LIBRDF_NODE_TYPE_LITERAL == node_type(o) ? P_O_TEXT : 0)
-                       | (NULL != literal_type_uri(o) ? P_O_DATATYPE : 0)
-                       | (NULL != literal_language(o) ? P_O_LANGUAGE : 0)
-                       | (context_node ? P_C_URI : 0)
-    ;
-    assert(params <= ALL_PARAMS && "params bitmask overflow");
 
-    const sqlite_rc_t begin = RET_ERROR; // transaction_start(storage);
+/** Labels have no escapes, so other bytes become _XX (hex). Keeps distinct labels distinct. */
+static void export_put_blank(export_buf_t *b, sqlite3_stmt *stmt, const int iCol)
+{
+    const unsigned char *str = column_blank_string(stmt, iCol);
+    const size_t len = sqlite3_column_bytes(stmt, iCol);
+    export_puts(b, "_:");
+    size_t run = 0;
+    for( size_t i = 0; i < len; i++ ) {
+        if( blank_label_plain(str[i], 0 == i) )
+            continue;
+        export_put(b, str + run, i - run);
+        run = i + 1;
+        char x[4];
+        snprintf(x, sizeof(x), "_%02X", str[i]);
+        export_puts(b, x);
+    }
+    export_put(b, str + run, len - run);
+}
+
+
+int librdf_storage_sqlite_mro_export(librdf_storage *storage, librdf_node *context_node, FILE *out, const int flags)
+{
+    assert(storage && "storage must be set.");
+    if( !out )
+        return RET_ERROR;
     instance_t *db_ctx = get_instance(storage);
 
+    const char order_by_sql[] = "ORDER BY c_uri, s_uri, s_blank, p_uri, o_uri, o_blank, o_text, o_language, o_datatype" "\n";
+    char sql[sizeof(find_triples_sql) + sizeof(order_by_sql)];
+    sculpt_find_triples_sql(context_node ? P_C_URI : 0, sql);
+    if( LIBRDF_STORAGE_SQLITE_MRO_EXPORT_ORDERED & flags )
+        strcat(sql, order_by_sql); // sql has room for it
+
     sqlite3_stmt *stmt = NULL;
-    {
-        const char find_triples_sql[] = // generated via tools/sql2c.sh find_triples.sql
-                                        " -- result columns must match as in enum idx_triple_column_t" "\n" \
-                                        "SELECT" "\n" \
-                                        " -- all *_id (hashes):" "\n" \
-                                        "  id" "\n" \
-                                        "  ,s_uri_id" "\n" \
-                                        "  ,s_blank_id" "\n" \
-                                        "  ,p_uri_id" "\n" \
-                                        "  ,o_uri_id" "\n" \
-                                        "  ,o_blank_id" "\n" \
-                                        "  ,o_lit_id" "\n" \
-                                        "  ,o_datatype_id" "\n" \
-                                        "  ,c_uri_id" "\n" \
-                                        " -- all values:" "\n" \
-                                        "  ,s_uri" "\n" \
-                                        "  ,s_blank" "\n" \
-                                        "  ,p_uri" "\n" \
-                                        "  ,o_uri" "\n" \
-                                        "  ,o_blank" "\n" \
-                                        "  ,o_text" "\n" \
-                                        "  ,o_language" "\n" \
-                                        "  ,o_datatype" "\n" \
-                                        "  ,c_uri" "\n" \
-                                        "FROM triples" "\n" \
-                                        "WHERE 1" "\n" \
-                                        " -- subject" "\n" \
-                                        "AND s_uri_id   = :s_uri_id" "\n" \
-                                        "AND s_blank_id = :s_blank_id" "\n" \
-                                        "AND p_uri_id   = :p_uri_id" "\n" \
-                                        " -- object" "\n" \
-                                        "AND o_uri_id   = :o_uri_id" "\n" \
-                                        "AND o_blank_id = :o_blank_id" "\n" \
-                                        "AND o_lit_id   = :o_lit_id" "\n" \
-                                        " -- context node" "\n" \
-                                        "AND c_uri_id   = :c_uri_id" "\n" \
-        ;
-
-        // create a SQL working copy (on stack) to fiddle with.
-        const size_t siz = sizeof(find_triples_sql);
-        char sql[siz];
-        strncpy(sql, find_triples_sql, siz);
-        // sculpt the SQL instead building it: comment out the NULL parameter terms
-        if( 0 == (P_S_URI & params) )
-            strncpy(strstr(sql, "AND s_uri_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND s_uri_id' not found in find_triples.sql");
-        if( 0 == (P_S_BLANK & params) )
-            strncpy(strstr(sql, "AND s_blank_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND s_blank_id' not found in find_triples.sql");
-        if( 0 == (P_P_URI & params) )
-            strncpy(strstr(sql, "AND p_uri_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND p_uri_id' not found in find_triples.sql");
-        if( 0 == (P_O_URI & params) )
-            strncpy(strstr(sql, "AND o_uri_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND o_uri_id' not found in find_triples.sql");
-        if( 0 == (P_O_BLANK & params) )
-            strncpy(strstr(sql, "AND o_blank_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND o_blank_id' not found in find_triples.sql");
-        if( 0 == (P_O_TEXT & params) )
-            strncpy(strstr(sql, "AND o_lit_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND o_lit_id' not found in find_triples.sql");
-        if( 0 == (P_C_URI & params) )
-            strncpy(strstr(sql, "AND c_uri_id"), "-- ", 3);
-        assert('-' != sql[0] && "'AND c_uri_id' not found in find_triples.sql");
+    if( SQLITE_OK != log_error( db_ctx->db, sql, sqlite3_prepare_v2(db_ctx->db, sql, -1, &stmt, NULL) ) )
+        return RET_ERROR;
+    sqlite_rc_t rc = SQLITE_OK;
+    if( SQLITE_OK != ( rc = bind_node_uri_id(stmt, db_ctx->digest, ":c_uri_id", context_node, NULL) ) ) {
+        sqlite3_finalize(stmt);
+        return rc;
+    }
 
-        librdf_log(librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "Created SQL statement #%d", params);
-        prep_stmt(db_ctx->db, &stmt, sql);
-    } // else if( false ) {
-      // toggle via "profile" feature?
-      // librdf_log( librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "%s", librdf_statement_to_string(statement) );
-      // }
+    export_buf_t *b = LIBRDF_MALLOC(export_buf_t *, sizeof(export_buf_t));
+    if( !b ) {
+        sqlite3_finalize(stmt);
+        return RET_ERROR;
+    }
+    b->out = out;
+    b->len = 0;
+    b->failed = false;
+    const bool graphs = 0 == (LIBRDF_STORAGE_SQLITE_MRO_EXPORT_NTRIPLES & flags);
+    while( SQLITE_ROW == ( rc = sqlite3_step(stmt) ) && !b->failed ) {
+        // stmt columns refer to find_triples_sql
+        if( SQLITE_NULL != sqlite3_column_type(stmt, IDX_S_URI) )
+            export_put_iri(b, stmt, IDX_S_URI);
+        else
+            export_put_blank(b, stmt, IDX_S_BLANK);
+        export_puts(b, " ");
+        export_put_iri(b, stmt, IDX_P_URI);
+        export_puts(b, " ");
+        if( SQLITE_NULL != sqlite3_column_type(stmt, IDX_O_URI) )
+            export_put_iri(b, stmt, IDX_O_URI);
+        else if( SQLITE_NULL != sqlite3_column_type(stmt, IDX_O_BLANK) )
+            export_put_blank(b, stmt, IDX_O_BLANK);
+        else {
+            export_puts(b, "\"");
+            export_put_escaped( b, sqlite3_column_text(stmt, IDX_O_TEXT), sqlite3_column_bytes(stmt, IDX_O_TEXT), &needs_escape_literal, &ntriples_escape );
+            export_puts(b, "\"");
+            if( SQLITE_NULL != sqlite3_column_type(stmt, IDX_O_LANGUAGE) ) {
+                export_puts(b, "@");
+                export_put( b, sqlite3_column_text(stmt, IDX_O_LANGUAGE), sqlite3_column_bytes(stmt, IDX_O_LANGUAGE) );
+            } else if( SQLITE_NULL != sqlite3_column_type(stmt, IDX_O_DATATYPE) ) {
+                export_puts(b, "^^");
+                export_put_iri(b, stmt, IDX_O_DATATYPE);
+            }
+        }
+        if( graphs && SQLITE_NULL != sqlite3_column_type(stmt, IDX_C_URI) ) {
+            export_puts(b, " ");
+            export_put_iri(b, stmt, IDX_C_URI);
+        }
+        export_puts(b, " .\n");
+    }
+    export_flush(b);
+    const bool failed = b->failed;
+    LIBRDF_FREE(export_buf_t *, b);
+    sqlite3_finalize(stmt);
+    if( failed )
+        return RET_ERROR;
+    return SQLITE_DONE == rc ? RET_OK : log_error(db_ctx->db, sql, rc);
+}
 
-    const sqlite_rc_t rc = bind_stmt(db_ctx, statement, context_node, stmt);
-    assert(SQLITE_OK == rc && "find_statements: failed to bind SQL parameters");
 
-    if( db_ctx->do_explain_query_plan ) {
-        librdf_log(librdf_storage_get_world(storage), 0, LIBRDF_LOG_INFO, LIBRDF_FROM_STORAGE, NULL, "Execute SQL statement #%d", params);
-        printExplainQueryPlan(stmt);
-    }
-    librdf_world *w = get_world(storage);
-    // create iterator
-    iterator_t *iter = LIBRDF_CALLOC(iterator_t *, sizeof(iterator_t), 1);
-    iter->storage = storage;
-    iter->context = context_node;
-    iter->pattern = librdf_new_statement_from_statement(statement);
-    iter->stmt = stmt;
-    iter->txn = begin;
-    iter->rc = sqlite3_step(stmt);
-    iter->statement = librdf_new_statement(w);
-    iter->dirty = true;
+#pragma mark Backup
 
-    librdf_storage_add_reference(iter->storage);
-    librdf_stream *stream = librdf_new_stream(w, iter, &pub_iter_end_of_stream, &pub_iter_next_statement, &pub_iter_get_statement, &pub_iter_finished);
 
-    return stream;
-}
+/** Consecutive SQLITE_BUSY/SQLITE_LOCKED steps before backup_run gives up, BACKUP_BUSY_MS apart. */
+#define BACKUP_BUSY_RETRIES 100
+#define BACKUP_BUSY_MS 10
 
 
-static librdf_stream *pub_find_statements(librdf_storage *storage, librdf_statement *statement)
+/** Copy all pages of src into dst, pages_per_step at a time (all at once if <= 0).
+ *
+ * Locks on src are held during a step only, so other connections get their turn in between.
+ * A progress callback returning non 0 aborts with SQLITE_ABORT and leaves dst as it was.
+ */
+static sqlite_rc_t backup_run(sqlite3 *dst, sqlite3 *src, const int pages_per_step, librdf_storage_sqlite_mro_progress progress, void *user_data)
 {
-    return pub_context_find_statements(storage, statement, NULL);
+    sqlite3_backup *backup = sqlite3_backup_init(dst, "main", src, "main");
+    if( !backup )
+        return sqlite3_errcode(dst);
+    sqlite_rc_t rc = SQLITE_OK;
+    for( int busy = 0; busy < BACKUP_BUSY_RETRIES; ) {
+        rc = sqlite3_backup_step(backup, pages_per_step > 0 ? pages_per_step : -1);
+        if( SQLITE_BUSY == rc || SQLITE_LOCKED == rc ) {
+            busy++;
+            sqlite3_sleep(BACKUP_BUSY_MS);
+        } else if( SQLITE_OK == rc || SQLITE_DONE == rc ) {
+            busy = 0;
+            if( progress && progress( user_data, sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup) ) ) {
+                rc = SQLITE_ABORT;
+                break;
+            }
+            if( SQLITE_DONE == rc )
+                break;
+        } else
+            break;
+    }
+    const sqlite_rc_t rc_finish = sqlite3_backup_finish(backup);
+    return SQLITE_DONE == rc ? rc_finish : rc;
 }
 
 
-static librdf_stream *pub_context_serialise(librdf_storage *storage, librdf_node *context_node)
+/** Whether path is the storage's own database file, also via another name or a link. */
+static bool is_own_file(instance_t *db_ctx, const char *path)
 {
-    return pub_context_find_statements(storage, NULL, context_node);
+    const char *own = sqlite3_db_filename(db_ctx->db, "main");
+    struct stat a, b;
+    return own && *own && 0 == stat(own, &a) && 0 == stat(path, &b) && a.st_dev == b.st_dev && a.st_ino == b.st_ino;
 }
 
 
-static librdf_stream *pub_serialise(librdf_storage *storage)
+/** Log and return SQLITE_MISUSE if path is the storage's own file, SQLITE_OK otherwise. */
+static sqlite_rc_t refuse_own_file(librdf_storage *storage, const char *what, const char *path)
 {
-    return pub_context_serialise(storage, NULL);
+    instance_t *db_ctx = get_instance(storage);
+    if( !is_own_file(db_ctx, path) )
+        return SQLITE_OK;
+    librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "%s of %s to %s refused - same file", what, db_ctx->name, path);
+    return SQLITE_MISUSE;
 }
 
 
-#pragma mark Add
+int librdf_storage_sqlite_mro_backup_save(librdf_storage *storage, const char *path, const int pages_per_step)
+{
+    assert(storage && "storage must be set.");
+    if( !path )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    if( SQLITE_OK != refuse_own_file(storage, "backup", path) )
+        return SQLITE_MISUSE;
+    sqlite3 *dst = NULL;
+    sqlite_rc_t rc = sqlite3_open(path, &dst);
+    if( SQLITE_OK == rc )
+        rc = backup_run(dst, db_ctx->db, pages_per_step, NULL, NULL);
+    if( SQLITE_OK != rc )
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "backup of %s to %s failed - %s", db_ctx->name, path, sqlite3_errstr(rc) );
+    sqlite3_close(dst);
+    return rc;
+}
 
 
-static int pub_context_add_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement)
+int librdf_storage_sqlite_mro_backup_load(librdf_storage *storage, const char *path, const int pages_per_step)
 {
-    if( !storage )
+    assert(storage && "storage must be set.");
+    if( !path )
         return RET_ERROR;
-    if( !statement )
-        return RET_OK;
-    // librdf_log( librdf_storage_get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "%s", librdf_statement_to_string(statement) );
-    return NULL == find_statement(storage, context_node, statement, true) ? RET_ERROR : RET_OK;
+    if( read_only_refused(storage, "backup load") )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    // SQLite doesn't allow using the destination during the backup
+    if( db_ctx->in_transaction || db_ctx->iterators > 0 )
+        return SQLITE_MISUSE;
+    // cached statements may still hold a read transaction, e.g. stmt_size
+    for( sqlite3_stmt *stmt = sqlite3_next_stmt(db_ctx->db, NULL); stmt; stmt = sqlite3_next_stmt(db_ctx->db, stmt) )
+        if( sqlite3_stmt_busy(stmt) )
+            sqlite3_reset(stmt);
+    sqlite3 *src = NULL;
+    sqlite_rc_t rc = sqlite3_open_v2(path, &src, SQLITE_OPEN_READONLY, NULL);
+    if( SQLITE_OK == rc ) {
+        // no migrations here, so accept the current schema only
+        sqlite3_stmt *stmt = NULL;
+        rc = sqlite3_prepare_v2(src, "PRAGMA user_version", -1, &stmt, NULL);
+        if( SQLITE_OK == rc )
+            rc = SQLITE_ROW == sqlite3_step(stmt) && SCHEMA_VERSION == sqlite3_column_int(stmt, 0) ? SQLITE_OK : SQLITE_MISMATCH;
+        sqlite3_finalize(stmt);
+    }
+    if( SQLITE_OK == rc )
+        rc = backup_run(db_ctx->db, src, pages_per_step, NULL, NULL);
+    if( SQLITE_OK == rc )
+        schema_detect(db_ctx);
+    else
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "backup of %s to %s failed - %s", path, db_ctx->name, sqlite3_errstr(rc) );
+    sqlite3_close(src);
+    return rc;
 }
 
 
-static int pub_context_add_statements(librdf_storage *storage, librdf_node *context_node, librdf_stream *statement_stream)
+/** Copy the committed state via a connection of its own, so the storage's connection can go on writing.
+ *
+ * In WAL mode that connection holds one read transaction throughout, a consistent snapshot that doesn't block
+ * writers. Otherwise each backup step takes its own lock and the backup restarts when others commit in between.
+ */
+int librdf_storage_sqlite_mro_snapshot(librdf_storage *storage, const char *path, const int flags, const int pages_per_step, librdf_storage_sqlite_mro_progress progress, void *user_data)
 {
-    const sqlite_rc_t txn = transaction_start(storage);
-    for( ; !librdf_stream_end(statement_stream); librdf_stream_next(statement_stream) ) {
-        librdf_statement *stmt = librdf_stream_get_object(statement_stream);
-        const int rc = pub_context_add_statement(storage, context_node, stmt);
-        if( RET_OK != rc ) {
-            transaction_rollback(storage, txn);
-            return rc;
+    assert(storage && "storage must be set.");
+    if( !path )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    const bool vacuum = LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_VACUUM & flags;
+    if( SQLITE_OK != refuse_own_file(storage, "snapshot", path) )
+        return SQLITE_MISUSE;
+
+    // a memory store has no file to open again, so it's its own source
+    sqlite3 *src = NULL;
+    sqlite_rc_t rc = SQLITE_OK;
+    if( db_ctx->memory ) {
+        if( vacuum && db_ctx->in_transaction )
+            return SQLITE_MISUSE; // VACUUM can't run within a transaction
+        src = db_ctx->db;
+    } else {
+        char *uri = read_only_uri(db_ctx->name, db_ctx->immutable);
+        rc = uri ? sqlite3_open_v2(uri, &src, SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, NULL) : SQLITE_NOMEM;
+        LIBRDF_FREE(char *, uri);
+        if( SQLITE_OK == rc )
+            rc = sqlite3_busy_timeout(src, BACKUP_BUSY_RETRIES * BACKUP_BUSY_MS);
+    }
+    bool wal = false;
+    if( SQLITE_OK == rc ) {
+        sqlite3_stmt *stmt = NULL;
+        rc = sqlite3_prepare_v2(src, "PRAGMA journal_mode", -1, &stmt, NULL);
+        if( SQLITE_OK == rc && SQLITE_ROW == sqlite3_step(stmt) )
+            wal = 0 == strcmp( "wal", (const char *)sqlite3_column_text(stmt, 0) );
+        sqlite3_finalize(stmt);
+    }
+    const bool hold = wal && !vacuum && src != db_ctx->db;
+    if( SQLITE_OK == rc && hold )
+        // the read transaction starts with the first read
+        if( SQLITE_OK == ( rc = exec_stmt(src, "BEGIN DEFERRED TRANSACTION;") ) )
+            rc = exec_stmt(src, "SELECT COUNT(*) FROM sqlite_master;");
+
+    if( SQLITE_OK == rc && vacuum ) {
+        // VACUUM INTO refuses existing files, so write aside and replace path when complete
+        const size_t len = strlen(path);
+        char *tmp = LIBRDF_MALLOC(char *, len + sizeof(".tmp") );
+        rc = tmp ? SQLITE_OK : SQLITE_NOMEM;
+        if( SQLITE_OK == rc ) {
+            memcpy(tmp, path, len);
+            memcpy(tmp + len, ".tmp", sizeof(".tmp") );
+            unlink(tmp);
         }
+        sqlite3_stmt *stmt = NULL;
+        if( SQLITE_OK == rc )
+            rc = sqlite3_prepare_v2(src, "VACUUM INTO :path", -1, &stmt, NULL);
+        if( SQLITE_OK == rc )
+            rc = sqlite3_bind_text(stmt, 1, tmp, -1, SQLITE_STATIC);
+        if( SQLITE_OK == rc ) {
+            rc = sqlite3_step(stmt);
+            rc = SQLITE_DONE == rc ? SQLITE_OK : rc;
+        }
+        sqlite3_finalize(stmt);
+        if( SQLITE_OK == rc && progress && progress(user_data, 0, 0) )
+            rc = SQLITE_ABORT;
+        if( SQLITE_OK == rc && 0 != rename(tmp, path) )
+            rc = SQLITE_CANTOPEN;
+        if( SQLITE_OK != rc && tmp )
+            unlink(tmp);
+        LIBRDF_FREE(char *, tmp);
+    } else if( SQLITE_OK == rc ) {
+        sqlite3 *dst = NULL;
+        rc = sqlite3_open(path, &dst);
+        if( SQLITE_OK == rc )
+            rc = backup_run(dst, src, pages_per_step, progress, user_data);
+        sqlite3_close(dst);
     }
-    return transaction_commit(storage, txn);
+
+    if( hold )
+        exec_stmt(src, "COMMIT TRANSACTION;");
+    if( SQLITE_OK != rc )
+        librdf_log(get_world(storage), 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "snapshot of %s to %s failed - %s", db_ctx->name, path, sqlite3_errstr(rc) );
+    if( src != db_ctx->db )
+        sqlite3_close(src);
+    return rc;
 }
 
 
-static int pub_add_statement(librdf_storage *storage, librdf_statement *statement)
+#pragma mark Space
+
+
+int librdf_storage_sqlite_mro_space_report(librdf_storage *storage, librdf_storage_sqlite_mro_space *space, const int detailed)
 {
-    return pub_context_add_statement(storage, NULL, statement);
+    assert(storage && "storage must be set.");
+    assert(space && "space must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    space->page_size = query_int(db_ctx->db, "PRAGMA page_size");
+    space->page_count = query_int(db_ctx->db, "PRAGMA page_count");
+    space->freelist_count = query_int(db_ctx->db, "PRAGMA freelist_count");
+    space->auto_vacuum = (int)query_int(db_ctx->db, "PRAGMA auto_vacuum");
+    space->fragmentation = -1;
+    if( space->page_size < 0 || space->page_count < 0 || space->freelist_count < 0 || space->auto_vacuum < 0 )
+        return RET_ERROR;
+    if( !detailed )
+        return RET_OK;
+    // needs SQLITE_ENABLE_DBSTAT_VTAB, so no log_error for a missing dbstat
+    sqlite3_stmt *stmt = NULL;
+    if( SQLITE_OK != sqlite3_prepare_v2(db_ctx->db, "SELECT SUM(unused), SUM(pgsize) FROM dbstat WHERE pagetype IN ('internal', 'leaf')", -1, &stmt, NULL) )
+        return RET_OK;
+    if( SQLITE_ROW == sqlite3_step(stmt) && sqlite3_column_int64(stmt, 1) > 0 )
+        space->fragmentation = (double)sqlite3_column_int64(stmt, 0) / sqlite3_column_int64(stmt, 1);
+    sqlite3_finalize(stmt);
+    return RET_OK;
 }
 
 
-static int pub_add_statements(librdf_storage *storage, librdf_stream *statement_stream)
+int librdf_storage_sqlite_mro_incremental_vacuum(librdf_storage *storage, const int pages, int *freed)
 {
-    return pub_context_add_statements(storage, NULL, statement_stream);
+    assert(storage && "storage must be set.");
+    if( freed )
+        *freed = 0;
+    if( read_only_refused(storage, "incremental vacuum") )
+        return RET_ERROR;
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    const sqlite3_int64 before = query_int(db_ctx->db, "PRAGMA freelist_count");
+    char sql[50];
+    const size_t len = snprintf(sql, sizeof(sql) - 1, "PRAGMA incremental_vacuum(%d);", pages > 0 ? pages : 0);
+    assert(len < sizeof(sql) && "buffer too small.");
+    const sqlite_rc_t rc = log_error( db_ctx->db, sql, exec_stmt(db_ctx->db, sql) );
+    if( SQLITE_OK != rc )
+        return rc;
+    if( freed )
+        *freed = (int)( before - query_int(db_ctx->db, "PRAGMA freelist_count") );
+    return RET_OK;
 }
 
 
-#pragma mark Remove
+#pragma mark Memory Pressure
 
 
-static int pub_context_remove_statement(librdf_storage *storage, librdf_node *context_node, librdf_statement *statement)
+int librdf_storage_sqlite_mro_release_memory(librdf_storage *storage, long long *released)
 {
-    if( !statement )
-        return RET_OK;
-    if( !librdf_statement_is_complete(statement) )
-        return RET_ERROR;
-    assert(storage && "must be set");
-
+    assert(storage && "storage must be set.");
+    if( released )
+        *released = 0;
     instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    const sqlite3_int64 before = sqlite3_memory_used();
+    // statements in use (iterators, a pending size) stay, the others get compiled again when needed
+    sqlite3_stmt **const cached[] = {
+        &(db_ctx->stmt_txn_start), &(db_ctx->stmt_txn_commit), &(db_ctx->stmt_txn_rollback),
+        &(db_ctx->stmt_savepoint_start), &(db_ctx->stmt_savepoint_release), &(db_ctx->stmt_savepoint_rollback),
+        &(db_ctx->stmt_triple_find), &(db_ctx->stmt_triple_insert), &(db_ctx->stmt_triple_delete), &(db_ctx->stmt_size)
+    };
+    for( size_t i = 0; i < array_length(cached); i++ )
+        if( *cached[i] && !sqlite3_stmt_busy(*cached[i]) )
+            finalize_stmt(cached[i]);
+    find_stmt_cache_trim(db_ctx, true);
+    statement_shells_done(db_ctx);
+    const size_t module = pool_trim(db_ctx);
+    const sqlite_rc_t rc = sqlite3_db_release_memory(db_ctx->db);
+    if( released )
+        *released = (long long)( before - sqlite3_memory_used() + module );
+    return SQLITE_OK == rc ? RET_OK : rc;
+}
 
-    const hash_t stmt_id = stmt_hash(statement, context_node, db_ctx->digest);
-    assert(!isNULL_ID(stmt_id) && "mustn't be nil");
 
-    sqlite3_stmt *stmt = prep_stmt(db_ctx->db, &(db_ctx->stmt_triple_delete), "DELETE FROM triples WHERE id = :stmt_id");
-    {
-        const sqlite_rc_t rc = bind_int(stmt, ":stmt_id", stmt_id);
-        if( SQLITE_OK != rc )
-            return rc;
-    }
-    const sqlite_rc_t rc = sqlite3_step(stmt);
-    return SQLITE_DONE == rc ? RET_OK : rc;
-}
+#pragma mark Warm-up API
 
 
-static int pub_remove_statement(librdf_storage *storage, librdf_statement *statement)
+int librdf_storage_sqlite_mro_warm_up(librdf_storage *storage, const long long budget, const int flags, librdf_storage_sqlite_mro_warm_up_done done, void *user_data)
 {
-    return pub_context_remove_statement(storage, NULL, statement);
+    assert(storage && "storage must be set.");
+    instance_t *db_ctx = get_instance(storage);
+    if( !db_ctx->db )
+        return RET_ERROR;
+    return warm_up_start(storage, budget, flags, done, user_data);
 }
 
 
-#if 0
-static int pub_context_remove_statements(librdf_storage *storage, librdf_node *context_node)
+int librdf_storage_sqlite_mro_warm_up_wait(librdf_storage *storage, long long *bytes)
 {
-    const sqlite_rc_t txn = transaction_start(storage);
-    for( librdf_statement *stmt = librdf_stream_get_object(statement_stream); !librdf_stream_end(statement_stream); librdf_stream_next(statement_stream) ) {
-        const int rc = pub_context_remove_statement(storage, context_node, stmt);
-        if( RET_OK != rc ) {
-            transaction_rollback(storage, txn);
-            return rc;
-        }
-    }
-    return transaction_commit(storage, txn);
+    assert(storage && "storage must be set.");
+    sqlite3_int64 b = 0;
+    const sqlite_rc_t rc = warm_up_join(get_instance(storage), false, &b);
+    if( bytes )
+        *bytes = b;
+    return rc;
 }
 
 
-#endif
-
-
 #pragma mark Register Storage Factory
 
 
@@ -1872,3 +5039,34 @@ int librdf_init_storage_sqlite_mro(librdf_world *world)
 {
     return librdf_storage_register_factory(world, LIBRDF_STORAGE_SQLITE_MRO, "SQLite", &register_factory);
 }
+
+
+int librdf_init_storage_sqlite_mro_memory(librdf_world *world, const librdf_storage_sqlite_mro_memory_config *config)
+{
+    if( !config )
+        return librdf_init_storage_sqlite_mro(world);
+    if( config->lookaside_slot_size < 0 || config->lookaside_slots < 0 || config->pagecache_slot_size < 0 || config->pagecache_slots < 0 )
+        return RET_ERROR;
+    // sqlite3_config refuses (SQLITE_MISUSE) once SQLite is initialised, i.e. after the first sqlite3_open
+    if( config->lookaside_slot_size > 0 && config->lookaside_slots > 0 ) {
+        const sqlite_rc_t rc = sqlite3_config(SQLITE_CONFIG_LOOKASIDE, config->lookaside_slot_size, config->lookaside_slots);
+        if( SQLITE_OK != rc ) {
+            librdf_log(world, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLITE_CONFIG_LOOKASIDE failed: %s", sqlite3_errstr(rc));
+            return rc;
+        }
+    }
+    if( config->pagecache_slot_size > 0 && config->pagecache_slots > 0 ) {
+        // owned by SQLite until sqlite3_shutdown, so never freed
+        void *region = LIBRDF_MALLOC(void *, (size_t)config->pagecache_slot_size * (size_t)config->pagecache_slots);
+        if( !region )
+            return RET_ERROR;
+        const sqlite_rc_t rc = sqlite3_config(SQLITE_CONFIG_PAGECACHE, region, config->pagecache_slot_size, config->pagecache_slots);
+        if( SQLITE_OK != rc ) {
+            LIBRDF_FREE(void *, region);
+            librdf_log(world, 0, LIBRDF_LOG_ERROR, LIBRDF_FROM_STORAGE, NULL, "SQLITE_CONFIG_PAGECACHE failed: %s", sqlite3_errstr(rc));
+            return rc;
+        }
+    }
+    memory_config = *config;
+    return librdf_init_storage_sqlite_mro(world);
+}
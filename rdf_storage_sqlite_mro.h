@@ -36,6 +36,11 @@
 #include <stdbool.h>
 #endif
 
+/** Compile hot path timers into rdf_storage_sqlite_mro.c, see librdf_storage_sqlite_mro_get_timers. */
+#ifndef LIBRDF_STORAGE_SQLITE_MRO_TIMERS
+#define LIBRDF_STORAGE_SQLITE_MRO_TIMERS 0
+#endif
+
 #include <librdf.h>
 
 /** Storage Factory name. */
@@ -59,6 +64,437 @@ extern "C" {
  */
 int librdf_init_storage_sqlite_mro(librdf_world *);
 
+/** Opt-in memory subsystem, see librdf_init_storage_sqlite_mro_memory. 0 keeps the respective default. */
+typedef struct {
+    /** SQLITE_CONFIG_LOOKASIDE, bytes per slot and slots of each connection's lookaside for small, short lived allocations.
+     *  No effect if SQLite is built with SQLITE_OMIT_LOOKASIDE (e.g. Debian). */
+    int lookaside_slot_size;
+    int lookaside_slots;
+    /** SQLITE_CONFIG_PAGECACHE, preallocated process wide page cache. A slot holds a page plus header, e.g. 4096 + 256 bytes. */
+    int pagecache_slot_size;
+    int pagecache_slots;
+    /** find and context iterators per storage served from preallocated slots instead of malloc. */
+    size_t pool_slots;
+} librdf_storage_sqlite_mro_memory_config;
+
+/** Register factory like librdf_init_storage_sqlite_mro and configure memory.
+ *
+ * The SQLite part is process wide and must precede any other SQLite use in the process.
+ * Usage is reported by librdf_storage_sqlite_mro_get_memory_stats (lookaside_*, pagecache_*, pool_*).
+ *
+ * @param config NULL behaves like librdf_init_storage_sqlite_mro.
+ * @return 0 on success. Non 0 if SQLite refused, e.g. as already initialised. The factory isn't registered then.
+ */
+int librdf_init_storage_sqlite_mro_memory(librdf_world *, const librdf_storage_sqlite_mro_memory_config *config);
+
+/** Parse a file and add the statements right away, no librdf_statement / librdf_node in between.
+ *
+ * Way faster than librdf_parser_parse_into_model(...) for large files. N-Quads graph names become contexts.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param path file name.
+ * @param syntax raptor parser name, e.g. "ntriples", "nquads", "turtle". NULL to guess.
+ * @return 0 on success. Rolls back all statements of the file on failure unless within a transaction already.
+ */
+int librdf_storage_sqlite_mro_load_file(librdf_storage *storage, const char *path, const char *syntax);
+
+/** Flags for librdf_storage_sqlite_mro_export, may be combined. */
+typedef enum {
+    /** N-Quads, the default */
+    LIBRDF_STORAGE_SQLITE_MRO_EXPORT_NQUADS = 0,
+    /** N-Triples, omit the graph names */
+    LIBRDF_STORAGE_SQLITE_MRO_EXPORT_NTRIPLES = 1 << 0,
+    /** sort by graph, subject, predicate, object. Costs a temporary b-tree. */
+    LIBRDF_STORAGE_SQLITE_MRO_EXPORT_ORDERED = 1 << 1
+} librdf_storage_sqlite_mro_export_flags;
+
+/** Write statements as N-Quads (or N-Triples) straight from the SQL result rows, no librdf_node in between.
+ *
+ * Way faster than librdf_model_write(...), e.g. for backups.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param context_node only this context or NULL for all.
+ * @param out file to write to.
+ * @param flags librdf_storage_sqlite_mro_export_flags.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_export(librdf_storage *storage, librdf_node *context_node, FILE *out, int flags);
+
+/** Copy the whole database file-to-file via SQLite's online backup API, e.g. to persist a memory='yes' storage.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param path file to overwrite, not the storage's own.
+ * @param pages_per_step pages copied per lock, <= 0 for all at once.
+ * @return 0 on success, SQLITE_MISUSE if path is the storage's own file.
+ */
+int librdf_storage_sqlite_mro_backup_save(librdf_storage *storage, const char *path, int pages_per_step);
+
+/** Replace the storage's content by a store file via SQLite's online backup API, e.g. to fill a memory='yes' storage.
+ *
+ * The file must have the current schema version. A memory storage requires the file's page_size to be the SQLite
+ * default or match the tuning, SQLite can't change it there.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO, open, not read only, without open iterators or transaction.
+ * @param path store file to copy from.
+ * @param pages_per_step pages copied per lock, <= 0 for all at once.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_backup_load(librdf_storage *storage, const char *path, int pages_per_step);
+
+typedef struct {
+    /** PRAGMA page_size in bytes */
+    long long page_size;
+    /** PRAGMA page_count, the file size in pages */
+    long long page_count;
+    /** PRAGMA freelist_count, unused pages an incremental vacuum can give back */
+    long long freelist_count;
+    /** PRAGMA auto_vacuum, 0: none, 1: full, 2: incremental. New stores are 2, older ones need a VACUUM to switch. */
+    int auto_vacuum;
+    /** unused share of the bytes in b-tree pages, 0..1. -1 unless detailed and SQLite has SQLITE_ENABLE_DBSTAT_VTAB. */
+    double fragmentation;
+} librdf_storage_sqlite_mro_space;
+
+/** File space usage, to decide about librdf_storage_sqlite_mro_incremental_vacuum or a full VACUUM.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param detailed non 0 to compute fragmentation, reads the whole file.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_space_report(librdf_storage *storage, librdf_storage_sqlite_mro_space *space, int detailed);
+
+/** Give up to pages free pages back to the file system, e.g. in small slices while idle after large deletes.
+ *
+ * Has an effect with auto_vacuum incremental only, see librdf_storage_sqlite_mro_space.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO, open and not read only.
+ * @param pages <= 0 for all.
+ * @param freed NULL or set to the pages given back.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_incremental_vacuum(librdf_storage *storage, int pages, int *freed);
+
+/** Flags for librdf_storage_sqlite_mro_warm_up, may be combined. */
+typedef enum {
+    /** run on a thread of its own, see librdf_storage_sqlite_mro_warm_up_wait. Same as storage option 'warm_up_background'. */
+    LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_BACKGROUND = 1 << 0,
+    /** ask the OS to read ahead the first budget bytes of the file, too. Same as storage option 'warm_up_madvise'. */
+    LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_MADVISE = 1 << 1
+} librdf_storage_sqlite_mro_warm_up_flags;
+
+/** Completion of librdf_storage_sqlite_mro_warm_up, on the warm-up thread in the background case.
+ *
+ * @param bytes read.
+ * @param rc 0 on success, SQLITE_INTERRUPT if cut short by closing the storage.
+ */
+typedef void (*librdf_storage_sqlite_mro_warm_up_done)(void *user_data, long long bytes, int rc);
+
+/** Read the triple_relations indexes and the term tables into the OS page cache, for fast first queries after a deploy.
+ *
+ * Reads through a connection of its own, so the storage serves queries meanwhile. Storage option 'warm_up' does
+ * the same at open. No effect for memory='yes'.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param budget bytes to read at most, <= 0 for all.
+ * @param flags librdf_storage_sqlite_mro_warm_up_flags.
+ * @param done NULL or called when finished.
+ * @return 0 on success, resp. started if LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_BACKGROUND.
+ */
+int librdf_storage_sqlite_mro_warm_up(librdf_storage *storage, long long budget, int flags, librdf_storage_sqlite_mro_warm_up_done done, void *user_data);
+
+/** Wait for a background warm-up, e.g. the one started by storage options 'warm_up' plus 'warm_up_background'.
+ *
+ * @param bytes NULL or set to the bytes read, 0 if none was running.
+ * @return result of the warm-up, 0 if none was running.
+ */
+int librdf_storage_sqlite_mro_warm_up_wait(librdf_storage *storage, long long *bytes);
+
+/** Progress of librdf_storage_sqlite_mro_snapshot, return non 0 to abort. */
+typedef int (*librdf_storage_sqlite_mro_progress)(void *user_data, int remaining_pages, int total_pages);
+
+/** Flags for librdf_storage_sqlite_mro_snapshot. */
+typedef enum {
+    /** copy the pages via SQLite's online backup API, the default. Progress after each step. */
+    LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_BACKUP = 0,
+    /** VACUUM INTO, a compacted copy. Written next to path as path.tmp and renamed when complete. One single step, so progress once at the end with 0 pages. */
+    LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_VACUUM = 1 << 0
+} librdf_storage_sqlite_mro_snapshot_flags;
+
+/** Write a consistent copy of the last committed state while the storage stays in use.
+ *
+ * Reads through a connection of its own. In WAL mode (journal_mode='wal') that's one read transaction for the
+ * whole copy, so writers go on undisturbed. In the other journal modes writers wait for one step at a time and
+ * their commits restart the copy.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param path file to overwrite, not the storage's own.
+ * @param flags librdf_storage_sqlite_mro_snapshot_flags.
+ * @param pages_per_step pages copied per step, <= 0 for all at once.
+ * @param progress NULL or called after each step.
+ * @param user_data passed to progress.
+ * @return 0 on success, SQLITE_MISUSE if path is the storage's own file.
+ */
+int librdf_storage_sqlite_mro_snapshot(librdf_storage *storage, const char *path, int flags, int pages_per_step, librdf_storage_sqlite_mro_progress progress, void *user_data);
+
+typedef enum {
+    LIBRDF_STORAGE_SQLITE_MRO_TERM_NONE = 0,
+    LIBRDF_STORAGE_SQLITE_MRO_TERM_URI,
+    LIBRDF_STORAGE_SQLITE_MRO_TERM_BLANK,
+    LIBRDF_STORAGE_SQLITE_MRO_TERM_LITERAL
+} librdf_storage_sqlite_mro_term_type;
+
+/** A term of a librdf_storage_sqlite_mro_row, straight from the SQL result. */
+typedef struct {
+    librdf_storage_sqlite_mro_term_type type;
+    /** UTF-8, NUL terminated. NULL if type is NONE. */
+    const unsigned char *value;
+    /** bytes without the NUL. */
+    size_t length;
+    /** hash id as stored in the database, 0 if type is NONE. */
+    unsigned long long id;
+} librdf_storage_sqlite_mro_term;
+
+/** A matching statement. All pointers are valid during the visitor call only. */
+typedef struct {
+    /** statement id */
+    unsigned long long id;
+    librdf_storage_sqlite_mro_term subject;
+    librdf_storage_sqlite_mro_term predicate;
+    librdf_storage_sqlite_mro_term object;
+    /** literal objects only, NULL otherwise. */
+    const unsigned char *language;
+    size_t language_length;
+    /** literal objects only, type NONE otherwise. */
+    librdf_storage_sqlite_mro_term datatype;
+    /** type NONE if in no context. */
+    librdf_storage_sqlite_mro_term context;
+} librdf_storage_sqlite_mro_row;
+
+/** @return non 0 to stop. */
+typedef int (*librdf_storage_sqlite_mro_visitor)(void *user_data, const librdf_storage_sqlite_mro_row *row);
+
+/** Call visitor for each statement matching pattern, no librdf_statement / librdf_node in between.
+ *
+ * Like librdf_storage_find_statements, way faster if only the strings or ids are needed.
+ * The storage mustn't be changed from within the visitor.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param pattern NULL for all.
+ * @param context_node only this context or NULL for all.
+ * @return 0 on success, also if the visitor stopped.
+ */
+int librdf_storage_sqlite_mro_for_each_match(librdf_storage *storage, librdf_statement *pattern, librdf_node *context_node, librdf_storage_sqlite_mro_visitor visitor, void *user_data);
+
+/** How many statements add_statement(s) and librdf_storage_sqlite_mro_load_file actually inserted
+ *  vs. ignored as already present. Saves a contains_statement before each add for change detection.
+ *
+ * Counted since the storage was created or the last reset, a rollback by the storage itself restores the previous counts.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO.
+ * @param inserted may be NULL.
+ * @param ignored may be NULL.
+ * @param reset non 0 to reset both counters to 0 after reading.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_add_counts(librdf_storage *storage, unsigned long long *inserted, unsigned long long *ignored, int reset);
+
+/** Operations measured by metrics. */
+typedef enum {
+    LIBRDF_STORAGE_SQLITE_MRO_OP_ADD = 0,
+    LIBRDF_STORAGE_SQLITE_MRO_OP_CONTAINS,
+    LIBRDF_STORAGE_SQLITE_MRO_OP_FIND,
+    LIBRDF_STORAGE_SQLITE_MRO_OP_REMOVE,
+    LIBRDF_STORAGE_SQLITE_MRO_OP_SIZE,
+    LIBRDF_STORAGE_SQLITE_MRO_OP_COUNT
+} librdf_storage_sqlite_mro_op;
+
+/** Where the time of an operation goes. Bind includes hashing where both interleave (add, find). */
+typedef enum {
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_PREPARE = 0,
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_HASH,
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_BIND,
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_STEP,
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_MATERIALISE,
+    LIBRDF_STORAGE_SQLITE_MRO_PHASE_COUNT
+} librdf_storage_sqlite_mro_phase;
+
+/** Log-linear latency buckets, 4 per power of two from 64ns up to ~5 minutes. */
+#define LIBRDF_STORAGE_SQLITE_MRO_HISTOGRAM_BUCKETS 128
+/** Find pattern shapes, the bitmask of bound subject uri/blank, predicate, object uri/blank/text/language/datatype, context. */
+#define LIBRDF_STORAGE_SQLITE_MRO_SHAPES 512
+
+typedef struct {
+    unsigned long long calls;
+    unsigned long long rows;
+    unsigned long long ns_total;
+    unsigned long long ns_max;
+    unsigned long long ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_COUNT];
+    unsigned int histogram[LIBRDF_STORAGE_SQLITE_MRO_HISTOGRAM_BUCKETS];
+} librdf_storage_sqlite_mro_metric;
+
+typedef struct {
+    librdf_storage_sqlite_mro_metric op[LIBRDF_STORAGE_SQLITE_MRO_OP_COUNT];
+    /** find by pattern shape, a find lasts from librdf_storage_find_statements until the stream is freed,
+     *  but counts only the time spent within the storage. */
+    librdf_storage_sqlite_mro_metric find[LIBRDF_STORAGE_SQLITE_MRO_SHAPES];
+} librdf_storage_sqlite_mro_metrics;
+
+/** Metrics collected since enabled or reset, see LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS.
+ *
+ * @return NULL if not enabled. Valid until disabled or the storage is freed.
+ */
+const librdf_storage_sqlite_mro_metrics *librdf_storage_sqlite_mro_get_metrics(librdf_storage *storage);
+
+/** Zero all metrics. */
+void librdf_storage_sqlite_mro_reset_metrics(librdf_storage *storage);
+
+/** Latency percentile from the histogram, e.g. 0.99.
+ *
+ * @return upper bound in nanoseconds of the bucket containing the percentile.
+ */
+unsigned long long librdf_storage_sqlite_mro_metric_percentile(const librdf_storage_sqlite_mro_metric *metric, double percentile);
+
+/** An operation that took at least LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD. Valid during the handler call only. */
+typedef struct {
+    librdf_storage_sqlite_mro_op op;
+    /** find pattern shape, -1 otherwise. */
+    int shape;
+    unsigned long long rows;
+    unsigned long long ns;
+    /** non 0 if the SQL statement was compiled before. */
+    int cached;
+    /** subject, predicate, object and context in N-Triples syntax, truncated. NULL if unbound or unknown (librdf_storage_sqlite_mro_load_file). */
+    const char *term[4];
+    /** hash ids of term as stored in the database, 0 if NULL. */
+    unsigned long long term_id[4];
+    /** slow operations dropped by the rate limit since the previous report. */
+    unsigned long long suppressed;
+} librdf_storage_sqlite_mro_slow_op;
+
+typedef void (*librdf_storage_sqlite_mro_slow_handler)(void *user_data, const librdf_storage_sqlite_mro_slow_op *slow);
+
+/** Report slow operations to handler instead of librdf_log (LIBRDF_LOG_WARN).
+ *
+ * @param handler NULL to log again.
+ */
+void librdf_storage_sqlite_mro_set_slow_handler(librdf_storage *storage, librdf_storage_sqlite_mro_slow_handler handler, void *user_data);
+
+/** Hot path timers, only with LIBRDF_STORAGE_SQLITE_MRO_TIMERS. */
+typedef enum {
+    /** term ids, digest plus binding the id. add, find, load_file, contains and remove. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_HASH = 0,
+    /** all parameters, includes HASH. add, find and load_file. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND,
+    /** insert into the triples view, i.e. the INSTEAD OF trigger. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_INSERT,
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_CONTAINS,
+    /** delete from the triples view incl. the trigger's garbage collection. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_DELETE,
+    /** each row of a find. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_FIND,
+    /** librdf_new_node_* per row of a find. */
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_NEW_NODE,
+    LIBRDF_STORAGE_SQLITE_MRO_TIMER_COUNT
+} librdf_storage_sqlite_mro_timer;
+
+typedef struct {
+    unsigned long long calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_COUNT];
+    unsigned long long ticks[LIBRDF_STORAGE_SQLITE_MRO_TIMER_COUNT];
+    /** 1: ticks are CPU cycles (rdtsc), 0: nanoseconds. */
+    int cycles;
+} librdf_storage_sqlite_mro_timers;
+
+/** Hot path timers accumulated since open or the last reset.
+ *
+ * @param reset non 0 to zero them after reading.
+ * @return 0 on success, non 0 if not compiled with LIBRDF_STORAGE_SQLITE_MRO_TIMERS.
+ */
+int librdf_storage_sqlite_mro_get_timers(librdf_storage *storage, librdf_storage_sqlite_mro_timers *timers, int reset);
+
+/** Memory and page cache usage, see librdf_storage_sqlite_mro_get_memory_stats. */
+typedef struct {
+    // sqlite3_db_status of this storage, https://www.sqlite.org/c3ref/c_dbstatus_options.html
+    /** page cache bytes */
+    long long cache_used;
+    long long cache_hit;
+    long long cache_miss;
+    long long cache_write;
+    /** bytes */
+    long long schema_used;
+    /** bytes of all compiled statements */
+    long long stmt_used;
+    long long lookaside_used;
+    long long lookaside_highwater;
+    long long lookaside_hit;
+    long long lookaside_miss_size;
+    long long lookaside_miss_full;
+
+    // sqlite3_status64, process wide, https://www.sqlite.org/c3ref/c_status_malloc_count.html
+    long long memory_used;
+    long long memory_highwater;
+    long long malloc_count;
+    long long malloc_size_highwater;
+    long long pagecache_used;
+    long long pagecache_overflow;
+    long long pagecache_size_highwater;
+
+    // the storage module itself
+    /** compiled statements of this storage, incl. those of open iterators */
+    long long statements;
+    /** compiled statements kept for reuse */
+    long long statements_cached;
+    /** open find and context iterators */
+    long long iterators;
+    /** bytes held by the module outside SQLite: instance, metrics, iterators, pool */
+    long long module_used;
+    /** iterator pool, see librdf_storage_sqlite_mro_memory_config. miss: exhausted, fell back to malloc. */
+    long long pool_slots;
+    long long pool_used;
+    long long pool_hit;
+    long long pool_miss;
+} librdf_storage_sqlite_mro_memory_stats;
+
+/** Memory and page cache usage of SQLite and the module.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param reset non 0 to reset the hit/miss counters and highwater marks (also the process wide ones) after reading.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_get_memory_stats(librdf_storage *storage, librdf_storage_sqlite_mro_memory_stats *stats, int reset);
+
+/** Give back memory, e.g. from a low memory warning. Safe with open iterators and within transactions.
+ *
+ * Drops the compiled statements not in use and the recycled statements and iterators, then
+ * sqlite3_db_release_memory frees the unused page cache. Everything is rebuilt on demand.
+ * Options 'statement_cache_max' and 'soft_heap_limit' keep the usage low in the first place.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param released NULL or set to the bytes given back by SQLite (process wide count) and the iterator pool.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_release_memory(librdf_storage *storage, long long *released);
+
+typedef struct {
+    /** "find", "insert", "delete", "contains", "size" or "gc <column>" for the delete trigger's reference counts. */
+    const char *op;
+    /** find pattern shape, -1 otherwise. */
+    int shape;
+    /** non 0 if the plan scans triple_relations or one of its indexes entirely. */
+    int full_scan;
+    /** EXPLAIN QUERY PLAN detail lines, separated by " | ". */
+    char *plan;
+} librdf_storage_sqlite_mro_query_plan;
+
+/** EXPLAIN QUERY PLAN of all find shapes, insert, delete, contains and size without executing them.
+ *
+ * @param storage must be of type LIBRDF_STORAGE_SQLITE_MRO and open.
+ * @param plans free with librdf_storage_sqlite_mro_free_query_plans.
+ * @param count number of plans.
+ * @return 0 on success.
+ */
+int librdf_storage_sqlite_mro_query_plans(librdf_storage *storage, librdf_storage_sqlite_mro_query_plan **plans, int *count);
+
+void librdf_storage_sqlite_mro_free_query_plans(librdf_storage_sqlite_mro_query_plan *plans, int count);
+
 
 #if LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE
 
@@ -85,10 +521,82 @@ int librdf_storage_get_feature_mro_int(librdf_storage *, const unsigned char *fe
  */
 extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK;
 
-/** Register sqlite3_profile or not. http://www.w3.org/2000/10/XMLSchema#boolean. */
+/** Print each SQL statement with its runtime to stderr (sqlite3_trace_v2) or not. http://www.w3.org/2000/10/XMLSchema#boolean. */
 extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_PROFILE;
 
 /** Print (some) sqlite3 'EXPLAIN QUERY PLAN' or not. http://www.w3.org/2000/10/XMLSchema#boolean. */
 extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQLITE3_EXPLAIN_QUERY_PLAN;
+/** librdf_storage_sqlite_mro_query_plans as CSV op,shape,full_scan,plan, http://www.w3.org/2000/10/XMLSchema#string. Read only. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_QUERY_PLANS;
+
+/** Named set of SQLite PRAGMAs, http://www.w3.org/2000/10/XMLSchema#string.
+ *  One of 'default', 'bulk-load', 'read-mostly', 'low-memory'. Same as storage option 'tuning'.
+ *  Setting it (re-)applies all PRAGMAs and drops overrides, not allowed within a transaction.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING;
+
+// Override single PRAGMAs of the tuning, same as storage options named like the PRAGMA, e.g. "cache_size='-65536'".
+// Reading returns the effective value as reported by SQLite.
+
+/** PRAGMA page_size, http://www.w3.org/2000/10/XMLSchema#integer. Effective for new stores only. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_PAGE_SIZE;
+/** PRAGMA locking_mode, http://www.w3.org/2000/10/XMLSchema#string. 'normal' or 'exclusive'. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_LOCKING_MODE;
+/** PRAGMA journal_mode, http://www.w3.org/2000/10/XMLSchema#string. 'delete', 'truncate', 'persist', 'memory', 'wal' or 'off'. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_JOURNAL_MODE;
+/** PRAGMA cache_size, http://www.w3.org/2000/10/XMLSchema#integer. Pages if positive, KiB if negative. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE;
+/** PRAGMA mmap_size, http://www.w3.org/2000/10/XMLSchema#integer. Bytes. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_MMAP_SIZE;
+/** PRAGMA temp_store, http://www.w3.org/2000/10/XMLSchema#string. 'default', 'file' or 'memory', reads back as 0, 1 or 2. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_TEMP_STORE;
+
+/** Collect metrics, see librdf_storage_sqlite_mro_get_metrics. http://www.w3.org/2000/10/XMLSchema#boolean.
+ *  Off by default. Switching on starts from zero.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS;
+/** Metrics as CSV, one line per operation and find shape, http://www.w3.org/2000/10/XMLSchema#string. Read only. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_DUMP;
+/** Set http://www.w3.org/2000/10/XMLSchema#boolean 'true' to zero all metrics. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_RESET;
+
+/** Report operations taking at least this many microseconds, http://www.w3.org/2000/10/XMLSchema#integer.
+ *  0 (the default) is off. Same as storage option 'slow_threshold_us'. See librdf_storage_sqlite_mro_set_slow_handler.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD;
+/** Report at most this many slow operations per second, http://www.w3.org/2000/10/XMLSchema#integer.
+ *  Default 10, 0 is unlimited. Same as storage option 'slow_rate'.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE;
+
+/** librdf_storage_sqlite_mro_get_memory_stats as CSV name,value, http://www.w3.org/2000/10/XMLSchema#string. Read only. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_MEMORY_STATS;
+
+/** Whether the store keeps URIs as namespace prefix plus local name, http://www.w3.org/2000/10/XMLSchema#boolean. Read only.
+ *  Chosen by storage option uri_prefixes='yes' when the store is created. Smaller files, a bit more work per find row.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES;
+
+/** Whether the store keeps language tags in a dictionary and literal texts above 256 bytes out-of-line, shared by
+ *  content hash, http://www.w3.org/2000/10/XMLSchema#boolean. Read only.
+ *  Chosen by storage option compact_literals='yes' when the store is created.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COMPACT_LITERALS;
+
+/** Whether the store was opened read only by storage option mode='ro' or immutable='yes',
+ *  http://www.w3.org/2000/10/XMLSchema#boolean. Read only. Writes and transactions then fail right away.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_READ_ONLY;
+
+/** Whether the query planner statistics are missing or outdated, http://www.w3.org/2000/10/XMLSchema#boolean.
+ *  Set true to run ANALYZE (within a row limit per index) now. The storage does so itself after storage option
+ *  'analyze_after' changes, after bulk loads without statistics, and runs PRAGMA optimize on close.
+ */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE;
+
+/** Statements added that weren't present before, http://www.w3.org/2000/10/XMLSchema#integer. Set 0 to reset. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED;
+/** Statements added that were already present, http://www.w3.org/2000/10/XMLSchema#integer. Set 0 to reset. */
+extern const unsigned char *LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED;
 
 #endif
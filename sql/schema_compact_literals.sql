@@ -0,0 +1,86 @@
+--
+-- Copyright (c) 2015, Marcus Rohrmoser mobile Software, http://purl.mro.name/rdf/sqlite
+-- All rights reserved.
+--
+-- Redistribution and use in source and binary forms, with or without modification, are permitted
+-- provided that the following conditions are met:
+--
+-- 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+--    and the following disclaimer.
+--
+-- 2. The software must not be used for military or intelligence or related purposes nor
+--    anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+--
+-- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+-- IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+-- FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+-- CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+-- DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+-- DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+-- IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+-- THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-- Optional schema for new stores (option compact_literals='yes'): language tags go into a dictionary,
+-- literal texts longer than 256 bytes go out-of-line into o_bodies keyed by mro_hash(text), so
+-- literals differing only in language or datatype share one body. o_literals becomes a view with
+-- the same columns, so the triples view and its triggers stay unchanged.
+-- The view uses scalar subqueries, not joins, so it's flattened into the triples view's LEFT JOIN.
+
+CREATE TABLE o_languages (
+  id INTEGER PRIMARY KEY
+  ,language TEXT NOT NULL
+);
+CREATE UNIQUE INDEX o_languages_index_language ON o_languages(language);
+
+CREATE TABLE o_bodies (
+  id INTEGER PRIMARY KEY -- mro_hash(text)
+  ,text TEXT NOT NULL
+);
+
+-- move the triple_relations.o_lit_id foreign key over to o_literal_rows, a view can't be referenced.
+-- legacy_alter_table keeps the triples view and triggers pointing at o_literals.
+PRAGMA legacy_alter_table = ON;
+ALTER TABLE o_literals RENAME TO o_literal_rows;
+PRAGMA legacy_alter_table = OFF;
+-- drops o_literals_index_datatype_id, too
+DROP TABLE o_literal_rows;
+
+CREATE TABLE o_literal_rows (
+  id INTEGER PRIMARY KEY
+  ,datatype_id INTEGER NULL REFERENCES t_uris(id)
+  ,language_id INTEGER NULL REFERENCES o_languages(id)
+  ,text TEXT NULL -- either text
+  ,body_id INTEGER NULL REFERENCES o_bodies(id) -- or body
+);
+CREATE INDEX o_literal_rows_index_datatype_id ON o_literal_rows(datatype_id);
+CREATE INDEX o_literal_rows_index_language_id ON o_literal_rows(language_id) WHERE language_id IS NOT NULL;
+CREATE INDEX o_literal_rows_index_body_id     ON o_literal_rows(body_id)     WHERE body_id IS NOT NULL;
+
+CREATE VIEW o_literals AS
+SELECT
+  o_literal_rows.id AS id
+  ,o_literal_rows.datatype_id AS datatype_id
+  ,(SELECT language FROM o_languages WHERE id = o_literal_rows.language_id) AS language
+  ,CASE WHEN o_literal_rows.body_id IS NULL THEN o_literal_rows.text ELSE (SELECT text FROM o_bodies WHERE id = o_literal_rows.body_id) END AS text
+  ,o_literal_rows.language_id AS language_id
+  ,o_literal_rows.body_id AS body_id
+FROM o_literal_rows
+;
+
+CREATE TRIGGER o_literals_insert INSTEAD OF INSERT ON o_literals
+FOR EACH ROW BEGIN
+  -- NULL language inserts nothing, the NOT NULL constraint makes OR IGNORE skip it.
+  INSERT OR IGNORE INTO o_languages(language) VALUES (NEW.language);
+  INSERT OR IGNORE INTO o_bodies(id,text) SELECT mro_hash(NEW.text), NEW.text WHERE length(CAST(NEW.text AS BLOB)) > 256;
+  INSERT OR IGNORE INTO o_literal_rows(id,datatype_id,language_id,text,body_id)
+  SELECT NEW.id, NEW.datatype_id, (SELECT id FROM o_languages WHERE language = NEW.language)
+    ,CASE WHEN length(CAST(NEW.text AS BLOB)) > 256 THEN NULL ELSE NEW.text END
+    ,CASE WHEN length(CAST(NEW.text AS BLOB)) > 256 THEN mro_hash(NEW.text) ELSE NULL END;
+END;
+
+CREATE TRIGGER o_literals_delete INSTEAD OF DELETE ON o_literals
+FOR EACH ROW BEGIN
+  DELETE FROM o_literal_rows WHERE id = OLD.id;
+  DELETE FROM o_bodies    WHERE (OLD.body_id     IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literal_rows WHERE body_id     = OLD.body_id))     AND (id = OLD.body_id);
+  DELETE FROM o_languages WHERE (OLD.language_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literal_rows WHERE language_id = OLD.language_id)) AND (id = OLD.language_id);
+END;
@@ -0,0 +1,96 @@
+--
+-- Copyright (c) 2015, Marcus Rohrmoser mobile Software, http://purl.mro.name/rdf/sqlite
+-- All rights reserved.
+--
+-- Redistribution and use in source and binary forms, with or without modification, are permitted
+-- provided that the following conditions are met:
+--
+-- 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+--    and the following disclaimer.
+--
+-- 2. The software must not be used for military or intelligence or related purposes nor
+--    anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+--
+-- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+-- IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+-- FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+-- CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+-- DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+-- DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+-- IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+-- THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+--
+
+-- Optional schema for new stores (option uri_prefixes='yes'): URIs are stored as namespace prefix
+-- (up to and including the last '/' or '#') plus local name. Ids remain the hashes of the full URIs.
+
+CREATE TABLE ns_uris (
+  id INTEGER PRIMARY KEY
+  ,prefix TEXT NOT NULL
+);
+CREATE UNIQUE INDEX ns_uris_index_prefix ON ns_uris(prefix);
+
+ALTER TABLE so_uris ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);
+ALTER TABLE p_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);
+ALTER TABLE t_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);
+ALTER TABLE c_uris  ADD COLUMN ns_id INTEGER NULL REFERENCES ns_uris(id);
+
+-- drops the triggers, too
+DROP VIEW triples;
+
+CREATE VIEW triples AS
+SELECT
+  -- all *_id (hashes):
+  triple_relations.id AS id
+  ,s_uri_id
+  ,s_blank_id
+  ,p_uri_id
+  ,o_uri_id
+  ,o_blank_id
+  ,o_lit_id
+  ,o_literals.datatype_id AS o_datatype_id
+  ,c_uri_id
+  -- all joined values:
+  ,s_ns.prefix || s_uris.uri     AS s_uri
+  ,s_blanks.blank                AS s_blank
+  ,p_ns.prefix || p_uris.uri     AS p_uri
+  ,o_ns.prefix || o_uris.uri     AS o_uri
+  ,o_blanks.blank                AS o_blank
+  ,o_literals.text               AS o_text
+  ,o_literals.language           AS o_language
+  ,t_ns.prefix || o_lit_uris.uri AS o_datatype
+  ,c_ns.prefix || c_uris.uri     AS c_uri
+FROM triple_relations
+LEFT OUTER JOIN so_uris    AS s_uris     ON triple_relations.s_uri_id   = s_uris.id
+LEFT OUTER JOIN ns_uris    AS s_ns       ON s_uris.ns_id                = s_ns.id
+LEFT OUTER JOIN so_blanks  AS s_blanks   ON triple_relations.s_blank_id = s_blanks.id
+INNER      JOIN p_uris     AS p_uris     ON triple_relations.p_uri_id   = p_uris.id
+INNER      JOIN ns_uris    AS p_ns       ON p_uris.ns_id                = p_ns.id
+LEFT OUTER JOIN so_uris    AS o_uris     ON triple_relations.o_uri_id   = o_uris.id
+LEFT OUTER JOIN ns_uris    AS o_ns       ON o_uris.ns_id                = o_ns.id
+LEFT OUTER JOIN so_blanks  AS o_blanks   ON triple_relations.o_blank_id = o_blanks.id
+LEFT OUTER JOIN o_literals AS o_literals ON triple_relations.o_lit_id   = o_literals.id
+LEFT OUTER JOIN t_uris     AS o_lit_uris ON o_literals.datatype_id      = o_lit_uris.id
+LEFT OUTER JOIN ns_uris    AS t_ns       ON o_lit_uris.ns_id            = t_ns.id
+LEFT OUTER JOIN c_uris     AS c_uris     ON triple_relations.c_uri_id   = c_uris.id
+LEFT OUTER JOIN ns_uris    AS c_ns       ON c_uris.ns_id                = c_ns.id
+;
+
+CREATE TRIGGER triples_delete INSTEAD OF DELETE ON triples
+FOR EACH ROW BEGIN
+  -- subject uri/blank
+  DELETE FROM so_uris    WHERE (OLD.s_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_uri_id    = OLD.s_uri_id))      AND (id = OLD.s_uri_id);
+  DELETE FROM so_blanks  WHERE (OLD.s_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE s_blank_id  = OLD.s_blank_id))    AND (id = OLD.s_blank_id);
+  -- predicate uri
+  DELETE FROM p_uris     WHERE (OLD.p_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE p_uri_id    = OLD.p_uri_id))      AND (id = OLD.p_uri_id);
+  -- object uri/blank
+  DELETE FROM so_uris    WHERE (OLD.o_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_uri_id    = OLD.o_uri_id))      AND (id = OLD.o_uri_id);
+  DELETE FROM so_blanks  WHERE (OLD.o_blank_id    IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_blank_id  = OLD.o_blank_id))    AND (id = OLD.o_blank_id);
+  -- object literal
+  DELETE FROM o_literals WHERE (OLD.o_lit_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE o_lit_id    = OLD.o_lit_id))      AND (id = OLD.o_lit_id);
+  DELETE FROM t_uris     WHERE (OLD.o_datatype_id IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM o_literals       WHERE datatype_id = OLD.o_datatype_id)) AND (id = OLD.o_datatype_id);
+  -- context uri
+  DELETE FROM c_uris     WHERE (OLD.c_uri_id      IS NOT NULL) AND (0 == (SELECT COUNT(id) FROM triple_relations WHERE c_uri_id    = OLD.c_uri_id))      AND (id = OLD.c_uri_id);
+  -- triple
+  DELETE FROM triple_relations WHERE id = OLD.id;
+END;
@@ -0,0 +1,51 @@
+--
+-- Copyright (c) 2015, Marcus Rohrmoser mobile Software, http://purl.mro.name/rdf/sqlite
+-- All rights reserved.
+--
+-- Redistribution and use in source and binary forms, with or without modification, are permitted
+-- provided that the following conditions are met:
+--
+-- 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+--    and the following disclaimer.
+--
+-- 2. The software must not be used for military or intelligence or related purposes nor
+--    anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+--
+-- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+-- IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+-- FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+-- CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+-- DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+-- DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+-- IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+-- THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+--
+
+-- continued from schema_uri_prefixes_1.sql, split to stay below 4095 bytes per C string.
+
+-- split off the prefix: rtrim drops the trailing characters other than '/' and '#'.
+-- NULL URIs insert nothing, the NOT NULL constraint makes OR IGNORE skip them.
+CREATE TRIGGER triples_insert INSTEAD OF INSERT ON triples
+FOR EACH ROW BEGIN
+  -- subject uri/blank
+  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.s_uri, replace(replace(NEW.s_uri, '/', ''), '#', '')));
+  INSERT OR IGNORE INTO so_uris   (id,ns_id,uri) SELECT NEW.s_uri_id, id, substr(NEW.s_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.s_uri, replace(replace(NEW.s_uri, '/', ''), '#', ''));
+  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.s_blank_id,    NEW.s_blank);
+  -- predicate uri
+  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.p_uri, replace(replace(NEW.p_uri, '/', ''), '#', '')));
+  INSERT OR IGNORE INTO p_uris    (id,ns_id,uri) SELECT NEW.p_uri_id, id, substr(NEW.p_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.p_uri, replace(replace(NEW.p_uri, '/', ''), '#', ''));
+  -- object uri/blank
+  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.o_uri, replace(replace(NEW.o_uri, '/', ''), '#', '')));
+  INSERT OR IGNORE INTO so_uris   (id,ns_id,uri) SELECT NEW.o_uri_id, id, substr(NEW.o_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.o_uri, replace(replace(NEW.o_uri, '/', ''), '#', ''));
+  INSERT OR IGNORE INTO so_blanks (id,blank) VALUES (NEW.o_blank_id,    NEW.o_blank);
+  -- object literal
+  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.o_datatype, replace(replace(NEW.o_datatype, '/', ''), '#', '')));
+  INSERT OR IGNORE INTO t_uris    (id,ns_id,uri) SELECT NEW.o_datatype_id, id, substr(NEW.o_datatype, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.o_datatype, replace(replace(NEW.o_datatype, '/', ''), '#', ''));
+  INSERT OR IGNORE INTO o_literals(id,datatype_id,language,text) VALUES (NEW.o_lit_id, NEW.o_datatype_id, NEW.o_language, NEW.o_text);
+  -- context uri
+  INSERT OR IGNORE INTO ns_uris   (prefix)   VALUES (rtrim(NEW.c_uri, replace(replace(NEW.c_uri, '/', ''), '#', '')));
+  INSERT OR IGNORE INTO c_uris    (id,ns_id,uri) SELECT NEW.c_uri_id, id, substr(NEW.c_uri, length(prefix) + 1) FROM ns_uris WHERE prefix = rtrim(NEW.c_uri, replace(replace(NEW.c_uri, '/', ''), '#', ''));
+  -- triple
+  INSERT INTO triple_relations(id, s_uri_id, s_blank_id, p_uri_id, o_uri_id, o_blank_id, o_lit_id, c_uri_id)
+  VALUES (NEW.id, NEW.s_uri_id, NEW.s_blank_id, NEW.p_uri_id, NEW.o_uri_id, NEW.o_blank_id, NEW.o_lit_id, NEW.c_uri_id);
+END;
@@ -0,0 +1,53 @@
+//
+// mtest-rdf.h
+//
+// Copyright (c) 2015-2026, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// statements for the tests, include after the storage header.
+//
+
+#ifndef MTEST_RDF_H
+#define MTEST_RDF_H
+
+#include <stdio.h>
+
+/** <http://example.com/s> <http://example.com/p> "o" */
+static inline librdf_statement *new_statement(librdf_world *world, const char *o)
+{
+    return librdf_new_statement_from_nodes(
+        world,
+        librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+        librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+        librdf_new_node_from_literal(world, (const unsigned char *)o, NULL, 0)
+        );
+}
+
+
+/** new_statement with the decimal i as object. */
+static inline librdf_statement *new_statement_int(librdf_world *world, const int i)
+{
+    char o[20];
+    snprintf(o, sizeof(o), "%d", i);
+    return new_statement(world, o);
+}
+
+#endif
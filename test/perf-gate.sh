@@ -0,0 +1,129 @@
+#!/bin/bash
+#
+# Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted
+# provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+# and the following disclaimer.
+#
+# 2. The software must not be used for military or intelligence or related purposes nor
+# anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+# IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+# FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+# IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+# THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Performance regression gate: runs tst-bench with a fixed workload and compares time and
+# SQLite allocations per operation against perf-baseline.csv, prints a table and fails on regressions.
+#
+# Times are relative to the plain SQLite 'calibrate' run to be comparable across machines.
+#
+#   $ make perf                        # compare
+#   $ make perf-baseline               # rewrite perf-baseline.csv after an intended change
+#
+# Each operation includes librdf's and raptor2's share, so write the baseline against the real ones in use.
+#
+# The time_tolerance and malloc_tolerance columns apply per row and may be edited by hand.
+#
+cd "$(dirname "$0")"
+
+BENCH="${BENCH:-build/tst-bench}"
+RDFGEN="${RDFGEN:-build/rdfgen}"
+BASELINE="${PERF_BASELINE:-perf-baseline.csv}"
+SIZE="${PERF_SIZE:-20000}"
+RUNS="${PERF_RUNS:-3}"
+TIME_TOLERANCE="${PERF_TIME_TOLERANCE:-2.0}"
+# scans (size, visit, export, file loads, finds without bound subject or object) are few, long and noisy
+SCAN_TIME_TOLERANCE="${PERF_SCAN_TIME_TOLERANCE:-3.0}"
+MALLOC_TOLERANCE="${PERF_MALLOC_TOLERANCE:-1.25}"
+
+[ -x "$BENCH" ] || { echo "$BENCH missing, e.g. $ make $BENCH" 1>&2 && exit 1 ; }
+[ -x "$RDFGEN" ] || { echo "$RDFGEN missing, e.g. $ make $RDFGEN" 1>&2 && exit 1 ; }
+[ "$1" = "update" ] || [ -r "$BASELINE" ] || { echo "$BASELINE missing, e.g. $ make perf-baseline" 1>&2 && exit 1 ; }
+mkdir -p tmp
+
+# skewed data for load_gen and visit_gen, deterministic
+GENERATED="tmp/perf-gen-$SIZE.nq"
+"$RDFGEN" -n "$SIZE" -g 8 > "$GENERATED" || { echo "rdfgen failed" 1>&2 && exit 1 ; }
+
+# best of $RUNS to tame noise, time per op relative to calibrate
+measure() {
+  for i in $(seq "$RUNS") ; do
+    "$BENCH" csv mro -f "$GENERATED" "$SIZE" || exit 1
+  done | awk -F, '
+    $1 == "storage" { next }
+    $3 == "calibrate" { if( cal == "" || $7 < cal ) cal = $7 ; next }
+    {
+      k = $3 "," $4
+      if( !(k in ns) ) order[n++] = k
+      if( !(k in ns) || $7 < ns[k] ) ns[k] = $7
+      m = $5 > 0 ? $9 / $5 : 0
+      if( !(k in mal) || m < mal[k] ) mal[k] = m
+    }
+    END {
+      if( cal <= 0 ) exit 1
+      for( i = 0; i < n; i++ )
+        printf "%s,%.3f,%.2f\n", order[i], ns[order[i]] / cal, mal[order[i]]
+    }'
+}
+
+CURRENT="$(measure)" || { echo "benchmark failed" 1>&2 && exit 1 ; }
+rm -f "$GENERATED"
+
+if [ "$1" = "update" ] ; then
+  {
+    echo "op,shape,rel_ns_per_op,mallocs_per_op,time_tolerance,malloc_tolerance"
+    echo "$CURRENT" | awk -F, -v tt="$TIME_TOLERANCE" -v st="$SCAN_TIME_TOLERANCE" -v mt="$MALLOC_TOLERANCE" '
+      {
+        scan = $1 == "find" ? $2 % 4 == 0 && int($2 / 8) % 8 == 0 : $1 != "contains" && $1 != "delete" && $1 != "load"
+        print $0 "," (scan ? st : tt) "," mt
+      }'
+  } > "$BASELINE"
+  echo "wrote $BASELINE ($(echo "$CURRENT" | wc -l) measurements, size $SIZE)"
+  exit 0
+fi
+
+echo "$CURRENT" | awk -F, -v baseline="$BASELINE" '
+  BEGIN {
+    while( (getline line < baseline) > 0 ) {
+      split(line, f, ",")
+      if( f[1] == "op" ) continue
+      k = f[1] "," f[2]
+      order[n++] = k
+      b_ns[k] = f[3] ; b_mal[k] = f[4] ; t_ns[k] = f[5] ; t_mal[k] = f[6]
+    }
+    printf "%-16s %6s %10s %10s %7s %12s %12s %7s  %s\n", "op", "shape", "base_rel", "rel", "ratio", "base_malloc", "malloc", "ratio", "status"
+  }
+  { k = $1 "," $2 ; c_ns[k] = $3 ; c_mal[k] = $4 }
+  END {
+    fail = 0
+    for( i = 0; i < n; i++ ) {
+      k = order[i]
+      split(k, f, ",")
+      if( !(k in c_ns) ) {
+        printf "%-16s %6s %10.3f %10s %7s %12.2f %12s %7s  MISSING\n", f[1], f[2], b_ns[k], "-", "-", b_mal[k], "-", "-"
+        fail++
+        continue
+      }
+      r_ns = b_ns[k] > 0 ? c_ns[k] / b_ns[k] : 1
+      r_mal = b_mal[k] > 0 ? c_mal[k] / b_mal[k] : (c_mal[k] > 0 ? 999 : 1)
+      status = "ok"
+      if( r_ns > t_ns[k] ) status = "SLOWER"
+      if( r_mal > t_mal[k] ) status = status == "ok" ? "MALLOCS" : status "+MALLOCS"
+      if( status != "ok" ) fail++
+      printf "%-16s %6s %10.3f %10.3f %7.2f %12.2f %12.2f %7.2f  %s\n", f[1], f[2], b_ns[k], c_ns[k], r_ns, b_mal[k], c_mal[k], r_mal, status
+    }
+    if( fail ) {
+      printf "\nPERFORMANCE REGRESSION: %d of %d measurements beyond tolerance (see %s)\n", fail, n, baseline
+      exit 1
+    }
+    printf "\nperformance ok: %d measurements within tolerance\n", n
+  }'
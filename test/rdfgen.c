@@ -0,0 +1,318 @@
+//
+// rdfgen.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Synthetic, deterministic RDF as N-Triples or N-Quads on stdout. Same seed and options, same bytes.
+//
+// $ make build/rdfgen
+// $ build/rdfgen -n 1000000 -g 16 -z 1.1 > tmp/1m.nq
+// $ build/rdfgen -h
+//
+// Subjects, predicates and objects are drawn from power-law (zipf) distributions,
+// so few are very frequent and most are rare, like in real data.
+//
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct
+{
+    unsigned long long triples;
+    unsigned long long seed;
+    unsigned long long subjects;
+    unsigned long long predicates;
+    unsigned long long objects;
+    unsigned int graphs; // 0: N-Triples
+    double skew; // zipf exponent, 0: uniform
+    unsigned int literal_length; // mean
+    double literal_ratio; // of objects
+    double language_ratio; // of literals
+    double datatype_ratio; // of literals
+    double blank_ratio; // of subjects and non-literal objects
+}
+options_t;
+
+
+#pragma mark Random
+
+
+/** xorshift64*, seeded via splitmix64. */
+typedef struct
+{
+    uint64_t s;
+}
+rnd_t;
+
+static void rnd_seed(rnd_t *r, uint64_t seed)
+{
+    seed += 0x9E3779B97F4A7C15ull;
+    seed = (seed ^ (seed >> 30) ) * 0xBF58476D1CE4E5B9ull;
+    seed = (seed ^ (seed >> 27) ) * 0x94D049BB133111EBull;
+    r->s = (seed ^ (seed >> 31) ) | 1;
+}
+
+
+static inline uint64_t rnd_next(rnd_t *r)
+{
+    r->s ^= r->s >> 12;
+    r->s ^= r->s << 25;
+    r->s ^= r->s >> 27;
+    return r->s * 0x2545F4914F6CDD1Dull;
+}
+
+
+/** uniform in [0,1) */
+static inline double rnd_unit(rnd_t *r)
+{
+    return (rnd_next(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/** rank in [0,n), zipf-like with exponent s via the inverse of the continuous power-law CDF, O(1). */
+static inline uint64_t rnd_zipf(rnd_t *r, const uint64_t n, const double s)
+{
+    if( n <= 1 )
+        return 0;
+    const double u = rnd_unit(r);
+    double x;
+    if( s <= 0.0 )
+        x = 1.0 + u * (double)n;
+    else if( fabs(s - 1.0) < 1e-9 )
+        x = exp(u * log( (double)n + 1.0 ) );
+    else {
+        const double a = 1.0 - s;
+        x = pow(u * (pow( (double)n + 1.0, a ) - 1.0) + 1.0, 1.0 / a);
+    }
+    const uint64_t k = (uint64_t)x - 1;
+    return k < n ? k : n - 1;
+}
+
+
+/** scatter ranks, so frequent ids aren't all small numbers (and thus neighbours in the b-tree).
+ *
+ * A permutation of [0,n): odd multiply, add and xorshift are each bijective on [0,2^bits),
+ * cycle walking keeps the result below n, in less than 2 rounds on average.
+ */
+static inline uint64_t scatter(const uint64_t rank, const uint64_t n)
+{
+    if( n <= 1 )
+        return 0;
+    unsigned int bits = 1;
+    while( bits < 64 && (1ull << bits) < n )
+        bits++;
+    const uint64_t mask = bits < 64 ? (1ull << bits) - 1 : ~0ull;
+    uint64_t x = rank;
+    do {
+        x = (x * 0x9E3779B97F4A7C15ull + 0x632BE59BD9B4E019ull) & mask;
+        x ^= x >> (bits / 2 + 1);
+    } while( x >= n );
+    return x;
+}
+
+
+#pragma mark Output
+
+
+static const char *const words[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel", "india", "juliett",
+    "kilo", "lima", "mike", "november", "oscar", "papa", "quebec", "romeo", "sierra", "tango",
+    "uniform", "victor", "whiskey", "xray", "yankee", "zulu", "Haus", "Baum", "maison", "arbre"
+};
+
+static const char *const languages[] = {
+    "en", "de", "fr", "es", "it", "nl", "en-GB", "de-CH"
+};
+
+static const char *const datatypes[] = {
+    "http://www.w3.org/2001/XMLSchema#integer",
+    "http://www.w3.org/2001/XMLSchema#decimal",
+    "http://www.w3.org/2001/XMLSchema#boolean",
+    "http://www.w3.org/2001/XMLSchema#date",
+    "http://www.w3.org/2001/XMLSchema#string"
+};
+
+#define array_length(a) ( sizeof(a) / sizeof( (a)[0] ) )
+
+static void put_literal(FILE *out, rnd_t *r, const options_t *o, const uint64_t id)
+{
+    const double kind = rnd_unit(r);
+    if( kind < o->datatype_ratio ) {
+        const size_t dt = id % array_length(datatypes);
+        switch( dt ) {
+        case 0: fprintf(out, "\"%llu\"", (unsigned long long)id); break;
+        case 1: fprintf(out, "\"%llu.%02u\"", (unsigned long long)(id / 100), (unsigned)(id % 100) ); break;
+        case 2: fprintf(out, "\"%s\"", id % 2 ? "true" : "false"); break;
+        case 3: fprintf(out, "\"%04u-%02u-%02u\"", 1900 + (unsigned)(id % 200), 1 + (unsigned)(id % 12), 1 + (unsigned)(id % 28) ); break;
+        default: fprintf(out, "\"s%llu\"", (unsigned long long)id); break;
+        }
+        fprintf(out, "^^<%s>", datatypes[dt]);
+        return;
+    }
+    // text: words picked by the literal id, length varies around the mean
+    rnd_t w;
+    rnd_seed(&w, id);
+    const size_t len = o->literal_length / 2 + rnd_next(&w) % (o->literal_length + 1);
+    size_t l = 0;
+    fputc('"', out);
+    for( int first = 1; l < len || first; first = 0 ) {
+        const char *word = words[rnd_next(&w) % array_length(words)];
+        if( !first ) {
+            fputc(' ', out);
+            l++;
+        }
+        fputs(word, out);
+        l += strlen(word);
+    }
+    fputc('"', out);
+    if( kind < o->datatype_ratio + o->language_ratio )
+        fprintf(out, "@%s", languages[id % array_length(languages)]);
+}
+
+
+static void put_resource(FILE *out, rnd_t *r, const options_t *o, const char *kind, const uint64_t id)
+{
+    if( rnd_unit(r) < o->blank_ratio )
+        fprintf(out, "_:%c%llu", kind[0], (unsigned long long)id);
+    else
+        fprintf(out, "<http://example.com/%s/%llu>", kind, (unsigned long long)id);
+}
+
+
+static void generate(FILE *out, const options_t *o)
+{
+    rnd_t r;
+    rnd_seed(&r, o->seed);
+    for( unsigned long long i = 0; i < o->triples; i++ ) {
+        const uint64_t s = scatter(rnd_zipf(&r, o->subjects, o->skew), o->subjects);
+        const uint64_t p = rnd_zipf(&r, o->predicates, o->skew);
+        const uint64_t obj = scatter(rnd_zipf(&r, o->objects, o->skew), o->objects);
+        // a blank or not must be stable per id, so derive it from the id, not the sequence
+        rnd_t rs;
+        rnd_seed(&rs, s ^ o->seed);
+        put_resource(out, &rs, o, "s", s);
+        fprintf(out, " <http://example.com/p/%llu> ", (unsigned long long)p);
+        rnd_t ro;
+        rnd_seed(&ro, obj ^ ~o->seed);
+        if( rnd_unit(&ro) < o->literal_ratio )
+            put_literal(out, &ro, o, obj);
+        else
+            put_resource(out, &ro, o, "o", obj);
+        if( o->graphs )
+            fprintf(out, " <http://example.com/g/%llu>", (unsigned long long)(rnd_next(&r) % o->graphs) );
+        fputs(" .\n", out);
+    }
+}
+
+
+#pragma mark Main
+
+
+#ifndef RDFGEN_NO_MAIN // test-rdfgen.c includes the generator
+
+
+static void usage(const char *name, const options_t *o)
+{
+    fprintf(stderr,
+            "usage: %s [options] > out.nq\n"
+            "  -n count   triples (%llu)\n"
+            "  -r seed    random seed (%llu)\n"
+            "  -g count   named graphs, 0 writes N-Triples (%u)\n"
+            "  -S count   distinct subjects (triples / 10)\n"
+            "  -P count   distinct predicates (%llu)\n"
+            "  -O count   distinct objects (triples / 4)\n"
+            "  -z skew    zipf exponent for subjects, predicates and objects, 0 is uniform (%.2f)\n"
+            "  -l length  mean literal length (%u)\n"
+            "  -L ratio   literals among objects (%.2f)\n"
+            "  -t ratio   language tagged literals (%.2f)\n"
+            "  -d ratio   typed literals (%.2f)\n"
+            "  -b ratio   blank nodes among subjects and resource objects (%.2f)\n",
+            name, o->triples, o->seed, o->graphs, o->predicates, o->skew, o->literal_length,
+            o->literal_ratio, o->language_ratio, o->datatype_ratio, o->blank_ratio);
+}
+
+
+static int ratio(const char *arg, double *value)
+{
+    char *end = NULL;
+    const double v = strtod(arg, &end);
+    if( '\0' != *end || v < 0.0 || v > 1.0 )
+        return 1;
+    *value = v;
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    options_t o = {
+        .triples = 1000,
+        .seed = 1,
+        .subjects = 0,
+        .predicates = 50,
+        .objects = 0,
+        .graphs = 0,
+        .skew = 1.0,
+        .literal_length = 24,
+        .literal_ratio = 0.5,
+        .language_ratio = 0.3,
+        .datatype_ratio = 0.2,
+        .blank_ratio = 0.1
+    };
+    int err = 0;
+    for( int c; -1 != ( c = getopt(argc, argv, "n:r:g:S:P:O:z:l:L:t:d:b:h") ); ) {
+        switch( c ) {
+        case 'n': o.triples = strtoull(optarg, NULL, 10); break;
+        case 'r': o.seed = strtoull(optarg, NULL, 10); break;
+        case 'g': o.graphs = (unsigned int)strtoul(optarg, NULL, 10); break;
+        case 'S': o.subjects = strtoull(optarg, NULL, 10); break;
+        case 'P': o.predicates = strtoull(optarg, NULL, 10); break;
+        case 'O': o.objects = strtoull(optarg, NULL, 10); break;
+        case 'z': o.skew = strtod(optarg, NULL); break;
+        case 'l': o.literal_length = (unsigned int)strtoul(optarg, NULL, 10); break;
+        case 'L': err |= ratio(optarg, &o.literal_ratio); break;
+        case 't': err |= ratio(optarg, &o.language_ratio); break;
+        case 'd': err |= ratio(optarg, &o.datatype_ratio); break;
+        case 'b': err |= ratio(optarg, &o.blank_ratio); break;
+        default: err = 1; break;
+        }
+    }
+    if( err || optind != argc || o.language_ratio + o.datatype_ratio > 1.0 || 0 == o.predicates ) {
+        usage(argv[0], &o);
+        return 1;
+    }
+    if( 0 == o.subjects )
+        o.subjects = o.triples / 10 + 1;
+    if( 0 == o.objects )
+        o.objects = o.triples / 4 + 1;
+
+    static char buf[1 << 20];
+    setvbuf(stdout, buf, _IOFBF, sizeof(buf) );
+    generate(stdout, &o);
+    return 0 == fflush(stdout) ? 0 : 2;
+}
+#endif
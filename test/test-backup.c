@@ -0,0 +1,245 @@
+//
+// test-backup.c
+//
+// Copyright (c) 2015-2026, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include "mtest-rdf.h"
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+int tests_run = 0;
+
+
+static int add(librdf_world *world, librdf_storage *storage, const int count)
+{
+    int rc = 0;
+    for( int i = 0; 0 == rc && i < count; i++ ) {
+        librdf_statement *stmt = new_statement_int(world, i);
+        rc = librdf_storage_add_statement(storage, stmt);
+        librdf_free_statement(stmt);
+    }
+    return rc;
+}
+
+
+static char *test_memory_save()
+{
+    unlink("tmp/test-backup.sqlite");
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-backup-memory.sqlite", "new='yes', memory='yes', uri_prefixes='yes'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 != access("tmp/test-backup-memory.sqlite", F_OK), "no file");
+        MUAssert(0 == add(world, storage, 1000), "add failed");
+        MUAssert(0 == librdf_storage_sqlite_mro_backup_save(storage, "tmp/test-backup.sqlite", 1), "save");
+        MUAssert(0 != librdf_storage_sqlite_mro_backup_save(storage, "tmp/no-such-dir/test-backup.sqlite", 1), "save must fail");
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-backup.sqlite", "new='no'");
+        MUAssert(storage, "Failed to open storage");
+        MUAssert(1000 == librdf_storage_size(storage), "size");
+        bool on = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES, &on), "get feature");
+        MUAssert(on, "uri_prefixes");
+        librdf_statement *stmt = new_statement_int(world, 999);
+        MUAssert(librdf_storage_contains_statement(storage, stmt), "contains");
+        librdf_free_statement(stmt);
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_memory_load()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, ":memory:", "new='yes'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == add(world, storage, 1), "add failed");
+        {
+            librdf_stream *stream = librdf_storage_find_statements(storage, NULL);
+            MUAssert(SQLITE_MISUSE == librdf_storage_sqlite_mro_backup_load(storage, "tmp/test-backup.sqlite", 2), "busy with iterator");
+            librdf_free_stream(stream);
+        }
+        MUAssert(0 != librdf_storage_sqlite_mro_backup_load(storage, "tmp/no-such-file.sqlite", 2), "no file");
+        MUAssert(1 == librdf_storage_size(storage), "unchanged");
+
+        MUAssert(0 == librdf_storage_sqlite_mro_backup_load(storage, "tmp/test-backup.sqlite", 2), "load");
+        MUAssert(1000 == librdf_storage_size(storage), "size");
+        bool on = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES, &on), "get feature");
+        MUAssert(on, "uri_prefixes come with the file");
+        librdf_statement *stmt = new_statement_int(world, 1000);
+        MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+        MUAssert(librdf_storage_contains_statement(storage, stmt), "contains");
+        librdf_free_statement(stmt);
+        MUAssert(1001 == librdf_storage_size(storage), "size");
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-backup.sqlite", "new='no'");
+        MUAssert(storage, "Failed to open storage");
+        MUAssert(1000 == librdf_storage_size(storage), "file unchanged");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+typedef struct {
+    librdf_world *world;
+    librdf_storage *storage;
+    int object; // added on the first call
+    int calls;
+    int remaining;
+    int abort_at;
+    int write_rc;
+} progress_t;
+
+
+/** writes into the storage during the snapshot */
+static int progress(void *user_data, const int remaining, const int total)
+{
+    progress_t *p = (progress_t *)user_data;
+    if( 0 == p->calls++ ) {
+        librdf_statement *stmt = new_statement_int(p->world, p->object);
+        p->write_rc = librdf_storage_add_statement(p->storage, stmt);
+        librdf_free_statement(stmt);
+    }
+    p->remaining = remaining;
+    return p->calls == p->abort_at;
+}
+
+
+static int size_of(librdf_world *world, const char *path)
+{
+    librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, path, "new='no'");
+    if( !storage )
+        return -1;
+    const int ret = librdf_storage_size(storage);
+    librdf_free_storage(storage);
+    return ret;
+}
+
+
+static char *test_snapshot()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-backup-live.sqlite", "new='yes', synchronous='off', journal_mode='wal'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == add(world, storage, 1000), "add failed");
+        {
+            progress_t p = {
+                .world = world, .storage = storage, .object = -1, .remaining = -1
+            };
+            MUAssert(0 == librdf_storage_sqlite_mro_snapshot(storage, "tmp/test-backup.sqlite", LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_BACKUP, 2, &progress, &p), "snapshot");
+            MUAssert(0 == p.write_rc, "writer not blocked");
+            MUAssert(p.calls > 1, "steps");
+            MUAssert(0 == p.remaining, "done");
+            MUAssert(1001 == librdf_storage_size(storage), "size live");
+            MUAssert(1000 == size_of(world, "tmp/test-backup.sqlite"), "size snapshot");
+        }
+        {
+            progress_t p = {
+                .world = world, .storage = storage, .object = -2, .remaining = -1
+            };
+            MUAssert(0 == librdf_storage_sqlite_mro_snapshot(storage, "tmp/test-backup.sqlite", LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_VACUUM, 0, &progress, &p), "snapshot");
+            MUAssert(0 == p.write_rc, "writer not blocked");
+            MUAssert(1 == p.calls, "one step");
+            MUAssert(1002 == librdf_storage_size(storage), "size live");
+            MUAssert(1001 == size_of(world, "tmp/test-backup.sqlite"), "size snapshot");
+        }
+        {
+            progress_t p = {
+                .world = world, .storage = storage, .object = -3, .abort_at = 2
+            };
+            MUAssert(SQLITE_ABORT == librdf_storage_sqlite_mro_snapshot(storage, "tmp/test-backup.sqlite", 0, 1, &progress, &p), "aborted");
+            MUAssert(2 == p.calls, "aborted at 2");
+            MUAssert(1001 == size_of(world, "tmp/test-backup.sqlite"), "previous snapshot untouched");
+        }
+        {
+            progress_t p = {
+                .world = world, .storage = storage, .object = -4, .abort_at = 1
+            };
+            MUAssert(SQLITE_ABORT == librdf_storage_sqlite_mro_snapshot(storage, "tmp/test-backup.sqlite", LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_VACUUM, 0, &progress, &p), "aborted");
+            MUAssert(1001 == size_of(world, "tmp/test-backup.sqlite"), "previous snapshot untouched");
+            MUAssert(0 != access("tmp/test-backup.sqlite.tmp", F_OK), "no leftover");
+        }
+        {
+            const char *own[] = { "tmp/test-backup-live.sqlite", "./tmp/../tmp/test-backup-live.sqlite", NULL };
+            for( int i = 0; own[i]; i++ ) {
+                MUAssert(SQLITE_MISUSE == librdf_storage_sqlite_mro_snapshot(storage, own[i], LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_VACUUM, 0, NULL, NULL), "own file refused");
+                MUAssert(SQLITE_MISUSE == librdf_storage_sqlite_mro_snapshot(storage, own[i], LIBRDF_STORAGE_SQLITE_MRO_SNAPSHOT_BACKUP, 0, NULL, NULL), "own file refused");
+                MUAssert(SQLITE_MISUSE == librdf_storage_sqlite_mro_backup_save(storage, own[i], 0), "own file refused");
+            }
+            MUAssert(1004 == librdf_storage_size(storage), "live intact");
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_memory_save);
+    MUTestRun(test_memory_load);
+    MUTestRun(test_snapshot);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,500 @@
+//
+// test-load.c
+//
+// Copyright (c) 2015-2018, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+#include "mtest.h"
+#include <unistd.h>
+#include <string.h>
+
+int tests_run = 0;
+
+static const char nquads[] =
+    "<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n"
+    "<http://example.com/s> <http://example.com/p> \"plain\" .\n"
+    "<http://example.com/s> <http://example.com/p> \"hallo\"@de <http://example.com/g1> .\n"
+    "<http://example.com/s> <http://example.com/p> \"42\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.com/g1> .\n"
+    "_:b0 <http://example.com/p> _:b1 <http://example.com/g2> .\n"
+    "<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n"
+;
+
+static char *write_file(const char *path, const char *content)
+{
+    FILE *f = fopen(path, "w");
+    MUAssert(f, "couldn't write file");
+    fputs(content, f);
+    fclose(f);
+    return NULL;
+}
+
+
+static int count_stream(librdf_stream *stream)
+{
+    int count = 0;
+    for( ; !librdf_stream_end(stream); librdf_stream_next(stream) )
+        count++;
+    librdf_free_stream(stream);
+    return count;
+}
+
+
+static char *test_load_nquads()
+{
+    char *msg = write_file("tmp/test-load.nq", nquads);
+    if( msg ) return msg;
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nq", "nquads"), "load failed");
+        MUAssert(5 == librdf_storage_size(storage), "duplicate or missing statements");
+        {
+            // ids must match the ones computed from librdf nodes
+            librdf_uri *dt = librdf_new_uri(world, (const unsigned char *)"http://www.w3.org/2001/XMLSchema#integer");
+            librdf_statement *stmt = librdf_new_statement_from_nodes(world,
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                                     librdf_new_node_from_typed_literal(world, (const unsigned char *)"plain", NULL, NULL)
+                                                                     );
+            MUAssert(librdf_storage_contains_statement(storage, stmt), "plain literal not found");
+            librdf_free_statement(stmt);
+
+            stmt = librdf_new_statement_from_nodes(world,
+                                                   librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                   librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                   librdf_new_node_from_typed_literal(world, (const unsigned char *)"42", NULL, dt)
+                                                   );
+            librdf_node *g1 = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/g1");
+            MUAssert(1 == count_stream( librdf_storage_find_statements_in_context(storage, stmt, g1) ), "typed literal not found");
+            MUAssert(2 == count_stream( librdf_storage_find_statements_in_context(storage, NULL, g1) ), "context g1");
+            librdf_free_node(g1);
+            librdf_free_statement(stmt);
+            librdf_free_uri(dt);
+
+            stmt = librdf_new_statement_from_nodes(world,
+                                                   librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                   librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                   librdf_new_node_from_literal(world, (const unsigned char *)"hallo", "de", 0)
+                                                   );
+            MUAssert(1 == count_stream( librdf_storage_find_statements(storage, stmt) ), "language literal not found");
+            librdf_free_statement(stmt);
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_load_broken()
+{
+    char *msg = write_file("tmp/test-load.nt", "<http://example.com/s> <http://example.com/p> \"ok\" .\n<http://example.com/s> broken\n");
+    if( msg ) return msg;
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 != librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nt", "ntriples"), "load must fail");
+        MUAssert(0 == librdf_storage_size(storage), "must roll back");
+        MUAssert(0 != librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nt", "no-such-syntax"), "unknown syntax must fail");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_export_roundtrip()
+{
+    char *msg = write_file("tmp/test-load.nq", nquads);
+    if( msg ) return msg;
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nq", "nquads"), "load failed");
+        {
+            librdf_statement *stmt = librdf_new_statement_from_nodes(world,
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                                     librdf_new_node_from_literal(world, (const unsigned char *)"say \"hi\"\n\tC:\\", NULL, 0)
+                                                                     );
+            librdf_node *g3 = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/g3");
+            MUAssert(0 == librdf_storage_context_add_statement(storage, g3, stmt), "add failed");
+            // not a valid N-Triples label as is
+            librdf_statement *blank = librdf_new_statement_from_nodes(world,
+                                                                      librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                                      librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                                      librdf_new_node_from_blank_identifier(world, (const unsigned char *)"-a b/c_")
+                                                                      );
+            MUAssert(0 == librdf_storage_context_add_statement(storage, g3, blank), "add failed");
+            librdf_free_statement(blank);
+            // IRIs take \u escapes only
+            librdf_statement *iri = librdf_new_statement_from_nodes(world,
+                                                                    librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                                    librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                                    librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/a\"b\001c")
+                                                                    );
+            MUAssert(0 == librdf_storage_context_add_statement(storage, g3, iri), "add failed");
+            librdf_free_statement(iri);
+            librdf_free_node(g3);
+            librdf_free_statement(stmt);
+        }
+        {
+            FILE *out = fopen("tmp/test-export.nq", "w");
+            MUAssert(out, "couldn't write file");
+            MUAssert(0 == librdf_storage_sqlite_mro_export(storage, NULL, out, LIBRDF_STORAGE_SQLITE_MRO_EXPORT_ORDERED), "export failed");
+            fclose(out);
+        }
+        {
+            const char expected[] =
+                "<http://example.com/s> <http://example.com/p> \"plain\" .\n"
+                "<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n"
+                "<http://example.com/s> <http://example.com/p> \"42\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.com/g1> .\n"
+                "<http://example.com/s> <http://example.com/p> \"hallo\"@de <http://example.com/g1> .\n"
+                "_:b0 <http://example.com/p> _:b1 <http://example.com/g2> .\n"
+                "<http://example.com/s> <http://example.com/p> \"say \\\"hi\\\"\\n\\tC:\\\\\" <http://example.com/g3> .\n"
+                "<http://example.com/s> <http://example.com/p> _:_2Da_20b_2Fc_5F <http://example.com/g3> .\n"
+                "<http://example.com/s> <http://example.com/p> <http://example.com/a\\u0022b\\u0001c> <http://example.com/g3> .\n"
+            ;
+            char actual[sizeof(expected) + 100];
+            FILE *in = fopen("tmp/test-export.nq", "r");
+            MUAssert(in, "couldn't read file");
+            const size_t len = fread(actual, 1, sizeof(actual) - 1, in);
+            fclose(in);
+            actual[len] = '\0';
+            MUAssert(0 == strcmp(expected, actual), "unexpected export");
+        }
+        {
+            FILE *out = fopen("tmp/test-export.nt", "w");
+            MUAssert(out, "couldn't write file");
+            librdf_node *g1 = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/g1");
+            MUAssert(0 == librdf_storage_sqlite_mro_export(storage, g1, out, LIBRDF_STORAGE_SQLITE_MRO_EXPORT_NTRIPLES), "export failed");
+            librdf_free_node(g1);
+            fclose(out);
+        }
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-export.nq", "nquads"), "reload failed");
+        MUAssert(8 == librdf_storage_size(storage), "roundtrip lost statements");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-export.nt", "ntriples"), "reload failed");
+        MUAssert(10 == librdf_storage_size(storage), "g1 statements must land in the default graph");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+typedef struct
+{
+    int rows;
+    int literals;
+    int blanks;
+    int in_context;
+    int stop_after; // 0: never
+    char *error;
+}
+visit_t;
+
+
+static int visit(void *user_data, const librdf_storage_sqlite_mro_row *row)
+{
+    visit_t *v = (visit_t *)user_data;
+    v->rows++;
+    if( !row->id || !row->subject.id || !row->predicate.id || !row->object.id )
+        v->error = "ids missing";
+    if( LIBRDF_STORAGE_SQLITE_MRO_TERM_URI != row->predicate.type || 0 != strcmp("http://example.com/p", (const char *)row->predicate.value) )
+        v->error = "predicate";
+    if( strlen( (const char *)row->subject.value ) != row->subject.length )
+        v->error = "length";
+    v->blanks += LIBRDF_STORAGE_SQLITE_MRO_TERM_BLANK == row->subject.type;
+    v->in_context += LIBRDF_STORAGE_SQLITE_MRO_TERM_NONE != row->context.type;
+    if( LIBRDF_STORAGE_SQLITE_MRO_TERM_LITERAL == row->object.type ) {
+        v->literals++;
+        if( 0 == strcmp("hallo", (const char *)row->object.value) && !( 2 == row->language_length && 0 == strcmp("de", (const char *)row->language) ) )
+            v->error = "language";
+        if( 0 == strcmp("42", (const char *)row->object.value)
+            && 0 != strcmp("http://www.w3.org/2001/XMLSchema#integer", (const char *)row->datatype.value) )
+            v->error = "datatype";
+    } else if( row->language || row->datatype.value )
+        v->error = "language or datatype of a non-literal";
+    return v->stop_after == v->rows;
+}
+
+
+static char *test_for_each_match()
+{
+    char *msg = write_file("tmp/test-load.nq", nquads);
+    if( msg ) return msg;
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nq", "nquads"), "load failed");
+        {
+            visit_t v = {
+                0
+            };
+            MUAssert(0 == librdf_storage_sqlite_mro_for_each_match(storage, NULL, NULL, &visit, &v), "visit all");
+            if( v.error ) printf("%s\n", v.error);
+            MUAssert(!v.error, "unexpected row");
+            MUAssert(5 == v.rows, "rows");
+            MUAssert(3 == v.literals, "literals");
+            MUAssert(1 == v.blanks, "blanks");
+            MUAssert(3 == v.in_context, "contexts");
+        }
+        {
+            visit_t v = {
+                0
+            };
+            librdf_node *g1 = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/g1");
+            librdf_statement *pattern = librdf_new_statement_from_nodes(world,
+                                                                        librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                                                                        NULL, NULL);
+            MUAssert(0 == librdf_storage_sqlite_mro_for_each_match(storage, pattern, g1, &visit, &v), "visit pattern");
+            MUAssert(!v.error, "unexpected row");
+            MUAssert(2 == v.rows, "rows in g1");
+            MUAssert(2 == v.literals, "literals in g1");
+            MUAssert(count_stream( librdf_storage_find_statements_in_context(storage, pattern, g1) ) == v.rows, "same as find");
+            librdf_free_statement(pattern);
+            librdf_free_node(g1);
+        }
+        {
+            visit_t v = {
+                0
+            };
+            v.stop_after = 2;
+            MUAssert(0 == librdf_storage_sqlite_mro_for_each_match(storage, NULL, NULL, &visit, &v), "visit stops");
+            MUAssert(2 == v.rows, "stopped");
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_uri_prefixes()
+{
+    char *msg = write_file("tmp/test-load.nq", nquads);
+    if( msg ) return msg;
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off', uri_prefixes='yes'");
+        MUAssert(storage, "Failed to create storage");
+        bool on = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES, &on), "get feature");
+        MUAssert(on, "uri_prefixes");
+        MUAssert(0 == librdf_storage_sqlite_mro_load_file(storage, "tmp/test-load.nq", "nquads"), "load failed");
+        {
+            librdf_statement *stmt = librdf_new_statement_from_nodes(world,
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"urn:isbn:0451450523"),
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                                                                     librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/ns#o")
+                                                                     );
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            MUAssert(librdf_storage_contains_statement(storage, stmt), "contains");
+            librdf_stream *stream = librdf_storage_find_statements(storage, stmt);
+            MUAssert(!librdf_stream_end(stream), "find");
+            librdf_statement *found = librdf_stream_get_object(stream);
+            MUAssert(0 == strcmp("urn:isbn:0451450523", (const char *)librdf_uri_as_string(librdf_node_get_uri(librdf_statement_get_subject(found) ) ) ), "subject without prefix");
+            MUAssert(0 == strcmp("http://example.com/ns#o", (const char *)librdf_uri_as_string(librdf_node_get_uri(librdf_statement_get_object(found) ) ) ), "object split at #");
+            librdf_free_stream(stream);
+            MUAssert(0 == librdf_storage_remove_statement(storage, stmt), "remove");
+            librdf_free_statement(stmt);
+        }
+        {
+            FILE *out = fopen("tmp/test-export.nq", "w");
+            MUAssert(out, "couldn't write file");
+            MUAssert(0 == librdf_storage_sqlite_mro_export(storage, NULL, out, LIBRDF_STORAGE_SQLITE_MRO_EXPORT_ORDERED), "export failed");
+            fclose(out);
+            const char expected[] =
+                "<http://example.com/s> <http://example.com/p> \"plain\" .\n"
+                "<http://example.com/s> <http://example.com/p> <http://example.com/o> .\n"
+                "<http://example.com/s> <http://example.com/p> \"42\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.com/g1> .\n"
+                "<http://example.com/s> <http://example.com/p> \"hallo\"@de <http://example.com/g1> .\n"
+                "_:b0 <http://example.com/p> _:b1 <http://example.com/g2> .\n"
+            ;
+            char actual[sizeof(expected) + 100];
+            FILE *in = fopen("tmp/test-export.nq", "r");
+            MUAssert(in, "couldn't read file");
+            const size_t len = fread(actual, 1, sizeof(actual) - 1, in);
+            fclose(in);
+            actual[len] = '\0';
+            MUAssert(0 == strcmp(expected, actual), "unexpected export");
+        }
+        {
+            int count = 0;
+            librdf_iterator *contexts = librdf_storage_get_contexts(storage);
+            for( ; !librdf_iterator_end(contexts); librdf_iterator_next(contexts) ) {
+                librdf_node *c = (librdf_node *)librdf_iterator_get_object(contexts);
+                const char *uri = (const char *)librdf_uri_as_string(librdf_node_get_uri(c) );
+                MUAssert(0 == strcmp("http://example.com/g1", uri) || 0 == strcmp("http://example.com/g2", uri), "context");
+                count++;
+            }
+            librdf_free_iterator(contexts);
+            MUAssert(2 == count, "contexts");
+        }
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite", "new='no'");
+        MUAssert(storage, "Failed to open storage");
+        bool on = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_URI_PREFIXES, &on), "get feature");
+        MUAssert(on, "the store decides");
+        MUAssert(5 == librdf_storage_size(storage), "size");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_compact_literals()
+{
+    char body[601];
+    for( size_t i = 0; i < sizeof(body) - 1; i++ )
+        body[i] = 'a' + i % 26;
+    body[sizeof(body) - 1] = '\0';
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-load.sqlite",
+                                                     "new='yes', synchronous='off', uri_prefixes='yes', compact_literals='yes'");
+        MUAssert(storage, "Failed to create storage");
+        bool on = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COMPACT_LITERALS, &on), "get feature");
+        MUAssert(on, "compact_literals");
+        librdf_node *s = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s");
+        librdf_node *p = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p");
+        librdf_uri *xsd_string = librdf_new_uri(world, (const unsigned char *)"http://www.w3.org/2001/XMLSchema#string");
+        librdf_statement *long_de = librdf_new_statement_from_nodes(world, librdf_new_node_from_node(s), librdf_new_node_from_node(p),
+                                                                    librdf_new_node_from_typed_literal(world, (const unsigned char *)body, "de", NULL) );
+        librdf_statement *long_typed = librdf_new_statement_from_nodes(world, librdf_new_node_from_node(s), librdf_new_node_from_node(p),
+                                                                       librdf_new_node_from_typed_literal(world, (const unsigned char *)body, NULL, xsd_string) );
+        librdf_statement *short_de = librdf_new_statement_from_nodes(world, librdf_new_node_from_node(s), librdf_new_node_from_node(p),
+                                                                     librdf_new_node_from_typed_literal(world, (const unsigned char *)"hallo", "de", NULL) );
+        MUAssert(0 == librdf_storage_add_statement(storage, long_de), "add failed");
+        MUAssert(0 == librdf_storage_add_statement(storage, long_typed), "add failed");
+        MUAssert(0 == librdf_storage_add_statement(storage, short_de), "add failed");
+        MUAssert(0 == librdf_storage_add_statement(storage, short_de), "add failed");
+        MUAssert(3 == librdf_storage_size(storage), "size");
+        {
+            librdf_stream *stream = librdf_storage_find_statements(storage, long_typed);
+            MUAssert(!librdf_stream_end(stream), "find long");
+            librdf_node *o = librdf_statement_get_object(librdf_stream_get_object(stream) );
+            MUAssert(0 == strcmp(body, (const char *)librdf_node_get_literal_value(o) ), "long text");
+            MUAssert(NULL == librdf_node_get_literal_value_language(o), "no language");
+            librdf_free_stream(stream);
+        }
+        MUAssert(0 == librdf_storage_remove_statement(storage, long_typed), "remove");
+        {
+            // the shared body survives
+            librdf_stream *stream = librdf_storage_find_statements(storage, long_de);
+            MUAssert(!librdf_stream_end(stream), "find long");
+            librdf_node *o = librdf_statement_get_object(librdf_stream_get_object(stream) );
+            MUAssert(0 == strcmp(body, (const char *)librdf_node_get_literal_value(o) ), "long text");
+            MUAssert(0 == strcmp("de", librdf_node_get_literal_value_language(o) ), "language");
+            librdf_free_stream(stream);
+        }
+        MUAssert(0 == librdf_storage_remove_statement(storage, long_de), "remove");
+        MUAssert(!librdf_storage_contains_statement(storage, long_de), "removed");
+        MUAssert(librdf_storage_contains_statement(storage, short_de), "short one left");
+        {
+            librdf_stream *stream = librdf_storage_find_statements(storage, short_de);
+            MUAssert(!librdf_stream_end(stream), "find short");
+            librdf_node *o = librdf_statement_get_object(librdf_stream_get_object(stream) );
+            MUAssert(0 == strcmp("hallo", (const char *)librdf_node_get_literal_value(o) ), "short text");
+            MUAssert(0 == strcmp("de", librdf_node_get_literal_value_language(o) ), "language");
+            librdf_free_stream(stream);
+        }
+        MUAssert(0 == librdf_storage_remove_statement(storage, short_de), "remove");
+        MUAssert(0 == librdf_storage_size(storage), "size");
+        librdf_free_statement(short_de);
+        librdf_free_statement(long_typed);
+        librdf_free_statement(long_de);
+        librdf_free_uri(xsd_string);
+        librdf_free_node(p);
+        librdf_free_node(s);
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_load_nquads);
+    MUTestRun(test_load_broken);
+    MUTestRun(test_export_roundtrip);
+    MUTestRun(test_for_each_match);
+    MUTestRun(test_uri_prefixes);
+    MUTestRun(test_compact_literals);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,225 @@
+//
+// test-memory.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include "mtest-rdf.h"
+#include <sqlite3.h>
+#include <string.h>
+
+int tests_run = 0;
+
+// must run first, SQLite accepts the configuration before its initialisation only
+static char *test_memory_config()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    const librdf_storage_sqlite_mro_memory_config config = {
+        .lookaside_slot_size = 128, .lookaside_slots = 256,
+        .pagecache_slot_size = 4096 + 256, .pagecache_slots = 64,
+        .pool_slots = 2
+    };
+    MUAssert(0 == librdf_init_storage_sqlite_mro_memory(world, &config), "configure");
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-memory.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        const char *objects[] = { "a", "b", "c", NULL };
+        for( int i = 0; objects[i]; i++ ) {
+            librdf_statement *stmt = new_statement(world, objects[i]);
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            librdf_free_statement(stmt);
+        }
+        librdf_storage_sqlite_mro_memory_stats stats;
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 1), "stats");
+        MUAssert(2 == stats.pool_slots, "pool_slots");
+        MUAssert(0 == stats.pool_used, "pool_used");
+        MUAssert(0 < stats.pagecache_used, "pagecache_used");
+
+        librdf_stream *streams[] = {
+            librdf_storage_serialise(storage), librdf_storage_serialise(storage), librdf_storage_serialise(storage)
+        };
+        int count = 0;
+        for( librdf_stream *s = streams[0]; !librdf_stream_end(s); librdf_stream_next(s) )
+            count++;
+        MUAssert(3 == count, "pooled iterator");
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+        MUAssert(2 == stats.pool_used, "pool_used");
+        MUAssert(2 == stats.pool_hit, "pool_hit");
+        MUAssert(1 == stats.pool_miss, "pool exhausted");
+        MUAssert(3 == stats.iterators, "iterators");
+        for( int i = 0; i < 3; i++ )
+            librdf_free_stream(streams[i]);
+
+        librdf_iterator *contexts = librdf_storage_get_contexts(storage);
+        MUAssert(contexts, "contexts");
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 1), "stats");
+        MUAssert(3 == stats.pool_hit, "context iterator recycled");
+        MUAssert(1 == stats.pool_miss, "no further malloc");
+        librdf_free_iterator(contexts);
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+        MUAssert(0 == stats.pool_used, "pool released");
+        MUAssert(0 == stats.pool_hit && 0 == stats.pool_miss, "reset");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_find_recycling()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-memory.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        librdf_statement *stmt = new_statement(world, "a");
+        MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+        librdf_storage_sqlite_mro_memory_stats stats;
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 1), "stats");
+        const long long cached = stats.statements_cached;
+        for( int i = 0; i < 10; i++ ) {
+            librdf_stream *stream = librdf_storage_find_statements(storage, stmt);
+            MUAssert(!librdf_stream_end(stream), "found");
+            MUAssert(librdf_stream_get_object(stream), "statement");
+            librdf_free_stream(stream);
+        }
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+        MUAssert(cached + 1 == stats.statements_cached, "find statement cached");
+        // pooled since test_memory_config, else the first one is malloced and recycled
+        MUAssert(stats.pool_miss <= 1, "first iterator only");
+        MUAssert(10 == stats.pool_hit + stats.pool_miss, "recycled iterators");
+        MUAssert(0 == stats.iterators, "iterators");
+
+        MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SQL_CACHE_MASK, 0), "cache off");
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+        MUAssert(cached == stats.statements_cached, "find statement dropped");
+        librdf_free_statement(stmt);
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_release_memory()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-memory.sqlite", "new='yes', synchronous='off', statement_cache_max='2', soft_heap_limit='8000000'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(8000000 == sqlite3_soft_heap_limit64(-1), "soft_heap_limit");
+        librdf_statement *stmt = new_statement(world, "a");
+        MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+
+        // 4 find shapes: s p o, s p -, s - -, - - -
+        librdf_statement *patterns[] = {
+            librdf_new_statement_from_statement(stmt), librdf_new_statement_from_statement(stmt),
+            librdf_new_statement_from_statement(stmt), librdf_new_statement(world)
+        };
+        librdf_statement_set_object(patterns[1], NULL);
+        librdf_statement_set_object(patterns[2], NULL);
+        librdf_statement_set_predicate(patterns[2], NULL);
+        librdf_storage_sqlite_mro_memory_stats stats;
+        for( int round = 0; round < 2; round++ ) {
+            long long cached = -1; // the named statements used so far plus one find statement
+            for( int i = 0; i < 4; i++ ) {
+                librdf_stream *stream = librdf_storage_find_statements(storage, patterns[i]);
+                MUAssert(!librdf_stream_end(stream), "found");
+                librdf_free_stream(stream);
+                if( 0 == i ) {
+                    MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+                    cached = stats.statements_cached;
+                }
+            }
+            MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+            MUAssert(cached + 1 == stats.statements_cached, "statement_cache_max");
+
+            long long released = -1;
+            MUAssert(0 == librdf_storage_sqlite_mro_release_memory(storage, &released), "release");
+            MUAssert(0 < released, "released");
+            MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+            MUAssert(0 == stats.statements_cached, "statements dropped");
+            MUAssert(0 == stats.statements, "statements finalized");
+        }
+        MUAssert(1 == librdf_storage_size(storage), "size after release");
+
+        for( int i = 0; i < 4; i++ )
+            librdf_free_statement(patterns[i]);
+        librdf_free_statement(stmt);
+        librdf_free_storage(storage);
+    }
+    sqlite3_soft_heap_limit64(0);
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_memory_config_late()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    const librdf_storage_sqlite_mro_memory_config config = {
+        .lookaside_slot_size = 64, .lookaside_slots = 64
+    };
+    MUAssert(0 != librdf_init_storage_sqlite_mro_memory(world, &config), "SQLite is initialised already");
+    MUAssert(0 == librdf_init_storage_sqlite_mro_memory(world, NULL), "defaults");
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_memory_config);
+    MUTestRun(test_find_recycling);
+    MUTestRun(test_release_memory);
+    MUTestRun(test_memory_config_late);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,331 @@
+//
+// test-metrics.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include "mtest-rdf.h"
+#include <string.h>
+
+int tests_run = 0;
+
+static char *test_metrics()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-metrics.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(NULL == librdf_storage_sqlite_mro_get_metrics(storage), "off by default");
+        MUAssert(0 == librdf_storage_set_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS, true), "switch on");
+        const librdf_storage_sqlite_mro_metrics *m = librdf_storage_sqlite_mro_get_metrics(storage);
+        MUAssert(m, "must be on");
+
+        const char *objects[] = { "a", "b", "c", NULL };
+        for( int i = 0; objects[i]; i++ ) {
+            librdf_statement *stmt = new_statement(world, objects[i]);
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            MUAssert(0 != librdf_storage_contains_statement(storage, stmt), "contains failed");
+            librdf_free_statement(stmt);
+        }
+        MUAssert(3 == librdf_storage_size(storage), "size");
+        {
+            // subject and predicate bound: shape 1 | 4
+            librdf_statement *pattern = librdf_new_statement_from_nodes(
+                world,
+                librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                NULL
+                );
+            librdf_stream *stream = librdf_storage_find_statements(storage, pattern);
+            int rows = 0;
+            for( ; !librdf_stream_end(stream); librdf_stream_next(stream) )
+                rows += NULL != librdf_stream_get_object(stream);
+            librdf_free_stream(stream);
+            librdf_free_statement(pattern);
+            MUAssert(3 == rows, "find rows");
+        }
+        MUAssert(3 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_ADD].calls, "add calls");
+        MUAssert(3 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_CONTAINS].calls, "contains calls");
+        MUAssert(3 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_CONTAINS].rows, "contains hits");
+        MUAssert(1 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_SIZE].calls, "size calls");
+        MUAssert(1 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_FIND].calls, "find calls");
+        MUAssert(3 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_FIND].rows, "find rows");
+        MUAssert(1 == m->find[1 | 4].calls, "find shape calls");
+        MUAssert(0 == m->find[1].calls, "find other shape calls");
+        MUAssert(0 < m->find[1 | 4].ns_phase[LIBRDF_STORAGE_SQLITE_MRO_PHASE_MATERIALISE], "materialise time");
+        {
+            const librdf_storage_sqlite_mro_metric *add = &(m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_ADD]);
+            const unsigned long long p50 = librdf_storage_sqlite_mro_metric_percentile(add, 0.5);
+            MUAssert(0 < p50 && p50 <= add->ns_max, "p50");
+            MUAssert(add->ns_max == librdf_storage_sqlite_mro_metric_percentile(add, 1.0), "p100");
+            MUAssert(0 < add->ns_total, "total");
+        }
+        {
+            librdf_uri *uri = librdf_new_uri(world, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_DUMP);
+            librdf_node *node = librdf_storage_get_feature(storage, uri);
+            MUAssert(node, "dump");
+            const char *csv = (const char *)librdf_node_get_literal_value(node);
+            MUAssert(0 == strncmp("op,shape,calls,rows,", csv, 20), "dump header");
+            MUAssert(strstr(csv, "\nfind,5,1,3,"), "dump find shape");
+            MUAssert(strstr(csv, "\nadd,-1,3,3,"), "dump add");
+            librdf_free_node(node);
+            librdf_free_uri(uri);
+        }
+
+        MUAssert(0 == librdf_storage_set_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS_RESET, true), "reset");
+        MUAssert(0 == m->op[LIBRDF_STORAGE_SQLITE_MRO_OP_ADD].calls, "reset add calls");
+        MUAssert(0 == m->find[1 | 4].calls, "reset find shape calls");
+
+        MUAssert(0 == librdf_storage_set_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_METRICS, false), "switch off");
+        MUAssert(NULL == librdf_storage_sqlite_mro_get_metrics(storage), "must be off");
+        MUAssert(3 == librdf_storage_size(storage), "size");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+typedef struct
+{
+    int calls;
+    librdf_storage_sqlite_mro_slow_op last;
+    char object[64];
+}
+slow_log_t;
+
+static void slow_handler(void *user_data, const librdf_storage_sqlite_mro_slow_op *slow)
+{
+    slow_log_t *log = (slow_log_t *)user_data;
+    log->calls++;
+    log->last = *slow;
+    // terms are valid during the call only
+    snprintf(log->object, sizeof(log->object), "%s", slow->term[2] ? slow->term[2] : "-");
+}
+
+
+static char *test_slow_log()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-slow.sqlite", "new='yes', synchronous='off', slow_rate='2'");
+        MUAssert(storage, "Failed to create storage");
+        slow_log_t log = {
+            0
+        };
+        librdf_storage_sqlite_mro_set_slow_handler(storage, &slow_handler, &log);
+        int v = -1;
+        MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, &v), "get threshold");
+        MUAssert(0 == v, "off by default");
+        MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE, &v), "get rate");
+        MUAssert(2 == v, "rate option");
+        MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, 1), "threshold 1us");
+
+        const char *objects[] = { "a", "b", "c", "d", "e", NULL };
+        for( int i = 0; objects[i]; i++ ) {
+            librdf_statement *stmt = new_statement(world, objects[i]);
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            librdf_free_statement(stmt);
+            if( 0 == i )
+                MUAssert(!log.last.cached, "first add compiles");
+        }
+        MUAssert(2 == log.calls, "rate limited");
+        MUAssert(log.last.cached, "second add cached");
+        MUAssert(LIBRDF_STORAGE_SQLITE_MRO_OP_ADD == log.last.op, "add");
+
+        MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_RATE, 0), "unlimited");
+        {
+            librdf_statement *stmt = new_statement(world, "a");
+            MUAssert(0 != librdf_storage_contains_statement(storage, stmt), "contains failed");
+            librdf_free_statement(stmt);
+        }
+        MUAssert(3 == log.calls, "contains logged");
+        MUAssert(LIBRDF_STORAGE_SQLITE_MRO_OP_CONTAINS == log.last.op, "contains");
+        MUAssert(3 == log.last.suppressed, "suppressed");
+        MUAssert(1 == log.last.rows, "contains rows");
+        MUAssert(!log.last.cached, "first contains compiles");
+        MUAssert(0 == strcmp("\"a\"", log.object), "object term");
+        MUAssert(0 != log.last.term_id[2], "object hash");
+        MUAssert(0 == log.last.term_id[3], "no context");
+        {
+            librdf_statement *pattern = librdf_new_statement_from_nodes(
+                world,
+                librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/s"),
+                librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                NULL
+                );
+            librdf_stream *stream = librdf_storage_find_statements(storage, pattern);
+            for( ; !librdf_stream_end(stream); librdf_stream_next(stream) )
+                ;
+            librdf_free_stream(stream);
+            librdf_free_statement(pattern);
+        }
+        MUAssert(4 == log.calls, "find logged");
+        MUAssert(LIBRDF_STORAGE_SQLITE_MRO_OP_FIND == log.last.op, "find");
+        MUAssert( (1 | 4) == log.last.shape, "find shape");
+        MUAssert(5 == log.last.rows, "find rows");
+        MUAssert(0 == log.last.suppressed, "nothing suppressed");
+        MUAssert(0 == strcmp("-", log.object), "unbound object");
+        MUAssert(!log.last.cached, "find compiles");
+        {
+            librdf_statement *stmt = new_statement(world, "x\"y\nz");
+            MUAssert(0 == librdf_storage_contains_statement(storage, stmt), "contains failed");
+            librdf_free_statement(stmt);
+        }
+        MUAssert(5 == log.calls, "contains logged");
+        MUAssert(log.last.cached, "contains cached");
+        MUAssert(0 == strcmp("\"x\\\"y\\nz\"", log.object), "object term escaped");
+
+        MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_SLOW_THRESHOLD, 0), "off");
+        MUAssert(5 == librdf_storage_size(storage), "size");
+        MUAssert(5 == log.calls, "off");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_memory_stats()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-memory.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        {
+            librdf_statement *stmt = new_statement(world, "a");
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            librdf_free_statement(stmt);
+        }
+        librdf_storage_sqlite_mro_memory_stats stats;
+        librdf_stream *stream = librdf_storage_serialise(storage);
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 0), "stats");
+        MUAssert(0 < stats.cache_used, "cache_used");
+        MUAssert(0 < stats.schema_used, "schema_used");
+        MUAssert(0 < stats.stmt_used, "stmt_used");
+        MUAssert(0 < stats.memory_used, "memory_used");
+        MUAssert(1 == stats.iterators, "iterators");
+        MUAssert(stats.statements_cached < stats.statements, "find statement");
+        MUAssert(0 < stats.statements_cached, "insert statement");
+        const long long module_used = stats.module_used;
+        librdf_free_stream(stream);
+        MUAssert(0 == librdf_storage_sqlite_mro_get_memory_stats(storage, &stats, 1), "stats");
+        MUAssert(0 == stats.iterators, "no iterators");
+        MUAssert(stats.module_used < module_used, "iterator freed");
+        {
+            librdf_uri *uri = librdf_new_uri(world, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_MEMORY_STATS);
+            librdf_node *node = librdf_storage_get_feature(storage, uri);
+            MUAssert(node, "dump");
+            const char *csv = (const char *)librdf_node_get_literal_value(node);
+            MUAssert(0 == strncmp("name,value\ncache_used,", csv, 22), "dump header");
+            MUAssert(strstr(csv, "\ncache_hit,0\n"), "dump cache_hit reset");
+            MUAssert(strstr(csv, "\niterators,0\n"), "dump iterators");
+            librdf_free_node(node);
+            librdf_free_uri(uri);
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_timers()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-timers.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        const char *objects[] = { "a", "b", "c", NULL };
+        for( int i = 0; objects[i]; i++ ) {
+            librdf_statement *stmt = new_statement(world, objects[i]);
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            librdf_free_statement(stmt);
+        }
+        librdf_stream *stream = librdf_storage_serialise(storage);
+        for( ; !librdf_stream_end(stream); librdf_stream_next(stream) )
+            MUAssert(librdf_stream_get_object(stream), "get");
+        librdf_free_stream(stream);
+
+        librdf_storage_sqlite_mro_timers t;
+        const int rc = librdf_storage_sqlite_mro_get_timers(storage, &t, 1);
+#if LIBRDF_STORAGE_SQLITE_MRO_TIMERS
+        MUAssert(0 == rc, "timers");
+        MUAssert(3 + 1 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND], "bind calls: add and find");
+        MUAssert(t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND] < t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_HASH], "hash calls, one per id");
+        MUAssert(3 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_INSERT], "insert calls");
+        MUAssert(0 < t.ticks[LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_INSERT], "insert ticks");
+        MUAssert(t.ticks[LIBRDF_STORAGE_SQLITE_MRO_TIMER_HASH] < t.ticks[LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND], "hash within bind");
+        MUAssert(4 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_STEP_FIND], "find steps");
+        MUAssert(3 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_NEW_NODE], "rows materialised");
+        MUAssert(0 == librdf_storage_sqlite_mro_get_timers(storage, &t, 0), "timers");
+        MUAssert(0 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND], "reset");
+#else
+        MUAssert(0 != rc, "not compiled in");
+        MUAssert(0 == t.calls[LIBRDF_STORAGE_SQLITE_MRO_TIMER_BIND], "zeroed");
+#endif
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_metrics);
+    MUTestRun(test_slow_log);
+    MUTestRun(test_memory_stats);
+    MUTestRun(test_timers);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
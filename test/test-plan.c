@@ -0,0 +1,186 @@
+//
+// test-plan.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+int tests_run = 0;
+
+// all bits that change the find SQL: subject uri/blank, predicate, object uri/blank/text, context.
+#define SQL_SHAPE_BITS (1 | 2 | 4 | 8 | 16 | 32 | 256)
+
+static char *test_no_full_scan()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-plan.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        librdf_storage_sqlite_mro_query_plan *plans = NULL;
+        int count = 0;
+        MUAssert(0 == librdf_storage_sqlite_mro_query_plans(storage, &plans, &count), "query plans");
+        MUAssert(LIBRDF_STORAGE_SQLITE_MRO_SHAPES < count, "count");
+        int finds = 0;
+        for( int i = 0; i < count; i++ ) {
+            const librdf_storage_sqlite_mro_query_plan *p = &plans[i];
+            MUAssert(p->plan, "plan must be set");
+            // INSERT INTO a view only runs the trigger, which EXPLAIN QUERY PLAN doesn't show.
+            MUAssert(*p->plan || 0 == strcmp("insert", p->op), "plan must not be empty");
+            finds += 0 == strcmp("find", p->op);
+            // serialising everything or counting all may scan, anything else must use an index.
+            if( 0 == strcmp("size", p->op) || ( 0 == strcmp("find", p->op) && 0 == (SQL_SHAPE_BITS & p->shape) ) )
+                continue;
+            if( p->full_scan )
+                printf("%s %d: %s\n", p->op, p->shape, p->plan);
+            MUAssert(!p->full_scan, "full scan of triple_relations");
+        }
+        MUAssert(LIBRDF_STORAGE_SQLITE_MRO_SHAPES == finds, "all shapes");
+        MUAssert(plans[0].full_scan, "shape 0 scans");
+        librdf_storage_sqlite_mro_free_query_plans(plans, count);
+        {
+            librdf_uri *uri = librdf_new_uri(world, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_QUERY_PLANS);
+            librdf_node *node = librdf_storage_get_feature(storage, uri);
+            MUAssert(node, "report");
+            const char *csv = (const char *)librdf_node_get_literal_value(node);
+            MUAssert(0 == strncmp("op,shape,full_scan,plan\nfind,0,1,\"", csv, 34), "report header");
+            MUAssert(strstr(csv, "\nfind,511,0,\""), "report last shape");
+            MUAssert(strstr(csv, "\ngc c_uri_id,-1,0,\""), "report gc");
+            librdf_free_node(node);
+            librdf_free_uri(uri);
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+/** Whether the find plan of the shape mentions the index. */
+static bool find_plan_uses(librdf_storage *storage, const int shape, const char *index)
+{
+    librdf_storage_sqlite_mro_query_plan *plans = NULL;
+    int count = 0;
+    if( 0 != librdf_storage_sqlite_mro_query_plans(storage, &plans, &count) )
+        return false;
+    bool ret = false;
+    for( int i = 0; i < count; i++ )
+        if( shape == plans[i].shape && 0 == strcmp("find", plans[i].op) )
+            ret = NULL != strstr(plans[i].plan, index);
+    librdf_storage_sqlite_mro_free_query_plans(plans, count);
+    return ret;
+}
+
+
+/** (s<i> rdf:type C<i % classes>) for i < count, in one transaction. */
+static int add_types(librdf_world *world, librdf_storage *storage, const int count, const int classes)
+{
+    int rc = librdf_storage_transaction_start(storage);
+    for( int i = 0; 0 == rc && i < count; i++ ) {
+        char s[64];
+        char o[64];
+        snprintf(s, sizeof(s), "http://example.com/s%d", i);
+        snprintf(o, sizeof(o), "http://example.com/C%d", i % classes);
+        librdf_statement *stmt = librdf_new_statement_from_nodes(
+            world,
+            librdf_new_node_from_uri_string(world, (const unsigned char *)s),
+            librdf_new_node_from_uri_string(world, (const unsigned char *)"http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+            librdf_new_node_from_uri_string(world, (const unsigned char *)o)
+            );
+        rc = librdf_storage_add_statement(storage, stmt);
+        librdf_free_statement(stmt);
+    }
+    return 0 == rc ? librdf_storage_transaction_commit(storage) : rc;
+}
+
+
+static bool stats_stale(librdf_world *world, librdf_storage *storage)
+{
+    librdf_uri *uri = librdf_new_uri(world, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE);
+    librdf_node *node = librdf_storage_get_feature(storage, uri);
+    const bool ret = node && 0 == strcmp("true", (const char *)librdf_node_get_literal_value(node));
+    librdf_free_node(node);
+    librdf_free_uri(uri);
+    return ret;
+}
+
+
+static char *test_analyze()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-plan.sqlite", "new='yes', synchronous='off', analyze_after='0'");
+        MUAssert(storage, "Failed to create storage");
+        // one predicate, many classes: (?s rdf:type C) should go via o_uri_id
+        MUAssert(0 == add_types(world, storage, 2000, 500), "add failed");
+        MUAssert(stats_stale(world, storage), "stale without statistics");
+        MUAssert(!find_plan_uses(storage, 4 | 8, "triple_relations_index_o_uri_id"), "no statistics, no selective index");
+        MUAssert(0 == librdf_storage_set_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_ANALYZE, true), "analyze");
+        MUAssert(!stats_stale(world, storage), "fresh statistics");
+        MUAssert(find_plan_uses(storage, 4 | 8, "triple_relations_index_o_uri_id"), "selective index");
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-plan.sqlite", "new='yes', synchronous='off', analyze_after='100'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == add_types(world, storage, 200, 50), "add failed");
+        MUAssert(!stats_stale(world, storage), "analyzed after commit");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_no_full_scan);
+    MUTestRun(test_analyze);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
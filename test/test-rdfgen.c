@@ -0,0 +1,126 @@
+//
+// test-rdfgen.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#define RDFGEN_NO_MAIN 1
+#include "rdfgen.c"
+
+#include "mtest.h"
+#include <stdbool.h>
+
+int tests_run = 0;
+
+
+static char *test_scatter_permutation()
+{
+    const uint64_t sizes[] = {1, 2, 3, 1000, 1024, 10001, 100001};
+    for( size_t i = 0; i < array_length(sizes); i++ ) {
+        const uint64_t n = sizes[i];
+        unsigned char *seen = calloc(n, 1);
+        uint64_t distinct = 0;
+        for( uint64_t rank = 0; rank < n; rank++ ) {
+            const uint64_t id = scatter(rank, n);
+            MUAssert(id < n, "in range");
+            distinct += !seen[id];
+            seen[id] = 1;
+        }
+        free(seen);
+        MUAssert(n == distinct, "every id exactly once");
+    }
+    MUAssert(scatter(0, 100001) != 0 || scatter(1, 100001) != 1, "scattered");
+    return NULL;
+}
+
+
+/** count distinct subject and object ids in generated N-Triples. */
+static bool count_distinct(const options_t *o, uint64_t *subjects, uint64_t *objects)
+{
+    FILE *f = tmpfile();
+    if( NULL == f )
+        return false;
+    generate(f, o);
+    rewind(f);
+    unsigned char *seen_s = calloc(o->subjects, 1);
+    unsigned char *seen_o = calloc(o->objects, 1);
+    bool ok = true;
+    *subjects = *objects = 0;
+    unsigned long long s, p, obj;
+    while( ok && 3 == fscanf(f, " <http://example.com/s/%llu> <http://example.com/p/%llu> <http://example.com/o/%llu> .", &s, &p, &obj) ) {
+        ok = s < o->subjects && obj < o->objects;
+        if( ok ) {
+            *subjects += !seen_s[s];
+            seen_s[s] = 1;
+            *objects += !seen_o[obj];
+            seen_o[obj] = 1;
+        }
+    }
+    ok = ok && feof(f);
+    free(seen_o);
+    free(seen_s);
+    fclose(f);
+    return ok;
+}
+
+
+static char *test_distinct_counts()
+{
+    // uniform and plenty of triples, so every subject and object id is hit
+    const options_t o = {
+        .triples = 40000, .seed = 1, .subjects = 1001, .predicates = 7, .objects = 1999, .skew = 0.0
+    };
+    uint64_t subjects = 0, objects = 0;
+    MUAssert(count_distinct(&o, &subjects, &objects), "parse");
+    MUAssert(1001 == subjects, "-S distinct subjects");
+    MUAssert(1999 == objects, "-O distinct objects");
+
+    // skewed, the frequent ranks still map to distinct ids
+    const options_t z = {
+        .triples = 40000, .seed = 2, .subjects = 1001, .predicates = 7, .objects = 1999, .skew = 1.0
+    };
+    MUAssert(count_distinct(&z, &subjects, &objects), "parse");
+    MUAssert(0 < subjects && subjects <= 1001, "-S bounds subjects");
+    MUAssert(0 < objects && objects <= 1999, "-O bounds objects");
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_scatter_permutation);
+    MUTestRun(test_distinct_counts);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,115 @@
+//
+// test-readonly.c
+//
+// Copyright (c) 2015-2026, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include "mtest-rdf.h"
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+
+int tests_run = 0;
+
+// '#' and '?' have to be escaped in the SQLite URI filename
+#define FILE_NAME "tmp/test-readonly#1?.sqlite"
+
+
+static char *test_read_only()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    librdf_statement *a = new_statement(world, "a");
+    librdf_statement *b = new_statement(world, "b");
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_add_statement(storage, a), "add failed");
+        librdf_free_storage(storage);
+    }
+    MUAssert(!librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "new='yes', mode='ro'"), "can't create read only");
+    MUAssert(!librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "mode='rx'"), "unknown mode");
+    MUAssert(!librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-readonly-missing.sqlite", "mode='ro'"), "must exist");
+    const char *options[] = {
+        "mode='ro'", "immutable='yes'", NULL
+    };
+    for( int i = 0; options[i]; i++ ) {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, options[i]);
+        MUAssert(storage, "Failed to open storage");
+        bool ro = false;
+        MUAssert(0 == librdf_storage_get_feature_mro_bool(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_READ_ONLY, &ro), "get feature");
+        MUAssert(ro, "read only");
+        MUAssert(1 == librdf_storage_size(storage), "size");
+        MUAssert(librdf_storage_contains_statement(storage, a), "contains");
+        MUAssert(!librdf_storage_contains_statement(storage, b), "contains not");
+        librdf_stream *stream = librdf_storage_find_statements(storage, a);
+        MUAssert(!librdf_stream_end(stream), "find");
+        librdf_free_stream(stream);
+
+        MUAssert(0 != librdf_storage_add_statement(storage, b), "add refused");
+        MUAssert(0 != librdf_storage_remove_statement(storage, a), "remove refused");
+        MUAssert(0 != librdf_storage_transaction_start(storage), "transaction refused");
+        MUAssert(0 != librdf_storage_sqlite_mro_load_file(storage, "test-loader.ttl", "turtle"), "load refused");
+        MUAssert(1 == librdf_storage_size(storage), "size unchanged");
+        librdf_free_storage(storage);
+    }
+    {
+        // the file is still there and writable
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "new='no'");
+        MUAssert(storage, "Failed to open storage");
+        MUAssert(0 == librdf_storage_add_statement(storage, b), "add failed");
+        MUAssert(2 == librdf_storage_size(storage), "size");
+        librdf_free_storage(storage);
+    }
+    librdf_free_statement(b);
+    librdf_free_statement(a);
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_read_only);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -27,6 +27,8 @@
 
 
 #include "mtest.h"
+#include "mtest-rdf.h"
+#include <stdio.h>
 #include <unistd.h>
 #include <string.h>
 
@@ -86,10 +88,127 @@ static char *test_size0()
 }
 
 
+static char *test_add_counts()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-size0.sqlite",
+                                                     "new='on', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        unsigned long long inserted = 99, ignored = 99;
+        MUAssert(0 == librdf_storage_sqlite_mro_add_counts(storage, &inserted, &ignored, 0), "get counts");
+        MUAssert(0 == inserted && 0 == ignored, "must start at 0");
+        {
+            librdf_statement *a = new_statement(world, "a");
+            librdf_statement *b = new_statement(world, "b");
+            librdf_node *g = librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/g");
+            MUAssert(0 == librdf_storage_add_statement(storage, a), "add failed");
+            MUAssert(0 == librdf_storage_add_statement(storage, a), "add failed");
+            MUAssert(0 == librdf_storage_add_statement(storage, b), "add failed");
+            MUAssert(0 == librdf_storage_context_add_statement(storage, g, a), "add failed");
+            MUAssert(0 == librdf_storage_context_add_statement(storage, g, a), "add failed");
+            librdf_free_node(g);
+            librdf_free_statement(b);
+            librdf_free_statement(a);
+        }
+        MUAssert(0 == librdf_storage_sqlite_mro_add_counts(storage, &inserted, &ignored, 1), "get counts");
+        MUAssert(3 == inserted, "inserted");
+        MUAssert(2 == ignored, "ignored");
+        MUAssert(3 == librdf_storage_size(storage), "size");
+
+        int value = -1;
+        MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_INSERTED, &value), "get feature");
+        MUAssert(0 == value, "must be reset");
+        {
+            librdf_statement *a = new_statement(world, "a");
+            MUAssert(0 == librdf_storage_add_statement(storage, a), "add failed");
+            librdf_free_statement(a);
+        }
+        MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, &value), "get feature");
+        MUAssert(1 == value, "ignored");
+        MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, 0), "reset");
+        MUAssert(0 != librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, 5), "only 0 allowed");
+        MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_COUNT_IGNORED, &value), "get feature");
+        MUAssert(0 == value, "must be reset");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_incremental_vacuum()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-size0.sqlite",
+                                                     "new='on', synchronous='off', journal_mode='wal'");
+        MUAssert(storage, "Failed to create storage");
+        librdf_storage_sqlite_mro_space space;
+        MUAssert(0 == librdf_storage_sqlite_mro_space_report(storage, &space, 0), "report");
+        MUAssert(2 == space.auto_vacuum, "incremental");
+        MUAssert(-1 == space.fragmentation, "not detailed");
+        char o[200];
+        memset(o, 'x', sizeof(o) - 1);
+        o[sizeof(o) - 1] = '\0';
+        MUAssert(0 == librdf_storage_transaction_start(storage), "begin");
+        for( int i = 0; i < 2000; i++ ) {
+            char num[9];
+            snprintf(num, sizeof(num), "%08d", i);
+            memcpy(o, num, 8);
+            librdf_statement *a = new_statement(world, o);
+            MUAssert(0 == librdf_storage_add_statement(storage, a), "add failed");
+            librdf_free_statement(a);
+        }
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "commit");
+        MUAssert(0 == librdf_storage_sqlite_mro_space_report(storage, &space, 1), "report");
+        MUAssert(-1 == space.fragmentation || (0 <= space.fragmentation && space.fragmentation < 1), "fragmentation");
+        const long long full = space.page_count;
+
+        MUAssert(0 == librdf_storage_transaction_start(storage), "begin");
+        for( int i = 0; i < 2000; i++ ) {
+            char num[9];
+            snprintf(num, sizeof(num), "%08d", i);
+            memcpy(o, num, 8);
+            librdf_statement *a = new_statement(world, o);
+            MUAssert(0 == librdf_storage_remove_statement(storage, a), "remove failed");
+            librdf_free_statement(a);
+        }
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "commit");
+        MUAssert(0 == librdf_storage_sqlite_mro_space_report(storage, &space, 0), "report");
+        MUAssert(full == space.page_count, "file keeps its size");
+        MUAssert(space.freelist_count > 50, "free pages");
+        const long long free_pages = space.freelist_count;
+
+        int freed = -1;
+        MUAssert(0 == librdf_storage_sqlite_mro_incremental_vacuum(storage, 10, &freed), "vacuum");
+        MUAssert(10 == freed, "freed 10");
+        MUAssert(0 == librdf_storage_sqlite_mro_space_report(storage, &space, 0), "report");
+        MUAssert(full - 10 == space.page_count, "shrunk");
+        MUAssert(free_pages - 10 == space.freelist_count, "less free pages");
+        MUAssert(0 == librdf_storage_sqlite_mro_incremental_vacuum(storage, 0, &freed), "vacuum all");
+        MUAssert(free_pages - 10 == freed, "freed the rest");
+        MUAssert(0 == librdf_storage_sqlite_mro_space_report(storage, &space, 0), "report");
+        MUAssert(0 == space.freelist_count, "no free pages");
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
 static char *all_tests()
 {
     MUTestRun(test_assert);
     MUTestRun(test_size0);
+    MUTestRun(test_add_counts);
+    MUTestRun(test_incremental_vacuum);
     return 0;
 }
 
@@ -0,0 +1,192 @@
+//
+// test-transaction.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include "mtest-rdf.h"
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+
+int tests_run = 0;
+
+static int add(librdf_world *world, librdf_storage *storage, const char *o)
+{
+    librdf_statement *stmt = new_statement(world, o);
+    const int rc = librdf_storage_add_statement(storage, stmt);
+    librdf_free_statement(stmt);
+    return rc;
+}
+
+
+/** 12 statements, one of them fails to insert into tmp/test-transaction.sqlite */
+static librdf_storage *new_source(librdf_world *world)
+{
+    librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction-src.sqlite", "new='yes', synchronous='off'");
+    if( !storage )
+        return NULL;
+    const char *objects[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "fail", NULL };
+    for( int i = 0; objects[i]; i++ )
+        add(world, storage, objects[i]);
+    return storage;
+}
+
+
+/** create the store and make inserting the literal "fail" raise an error. */
+static char *prepare_failing_destination(librdf_world *world)
+{
+    librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction.sqlite", "new='yes', synchronous='off'");
+    MUAssert(storage, "Failed to create storage");
+    librdf_free_storage(storage);
+
+    sqlite3 *db = NULL;
+    MUAssert(SQLITE_OK == sqlite3_open("tmp/test-transaction.sqlite", &db), "sqlite3_open");
+    MUAssert(SQLITE_OK == sqlite3_exec(db,
+                                       "CREATE TRIGGER fail BEFORE INSERT ON o_literals WHEN NEW.text = 'fail'"
+                                       " BEGIN SELECT RAISE(ABORT, 'injected failure'); END;", NULL, NULL, NULL), "create trigger");
+    sqlite3_close(db);
+    return NULL;
+}
+
+
+static char *add_batched(librdf_world *world, const char *options, const int rc_expected, const int size_expected)
+{
+    char *msg = prepare_failing_destination(world);
+    if( msg )
+        return msg;
+    librdf_storage *src = new_source(world);
+    MUAssert(src, "Failed to create storage");
+    librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction.sqlite", options);
+    MUAssert(storage, "Failed to create storage");
+
+    librdf_stream *stream = librdf_storage_serialise(src);
+    const int rc = librdf_storage_add_statements(storage, stream);
+    librdf_free_stream(stream);
+    MUAssert( (0 == rc) == (0 == rc_expected), "add_statements return value");
+    MUAssert(size_expected == librdf_storage_size(storage), "size");
+    unsigned long long inserted = 0;
+    librdf_storage_sqlite_mro_add_counts(storage, &inserted, NULL, 0);
+    MUAssert(size_expected == (int)inserted, "inserted count");
+
+    librdf_free_storage(storage);
+    librdf_free_storage(src);
+    return NULL;
+}
+
+
+static char *test_nested()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction.sqlite", "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+
+        MUAssert(0 == librdf_storage_transaction_start(storage), "outer start");
+        MUAssert(0 == add(world, storage, "a"), "add failed");
+        MUAssert(0 == librdf_storage_transaction_start(storage), "inner start");
+        MUAssert(0 == add(world, storage, "b"), "add failed");
+        MUAssert(2 == librdf_storage_size(storage), "size");
+        MUAssert(0 == librdf_storage_transaction_rollback(storage), "inner rollback");
+        MUAssert(1 == librdf_storage_size(storage), "inner rollback must keep the outer work");
+        MUAssert(0 == librdf_storage_transaction_start(storage), "inner start");
+        MUAssert(0 == add(world, storage, "c"), "add failed");
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "inner commit");
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "outer commit");
+        MUAssert(0 != librdf_storage_transaction_commit(storage), "no transaction left");
+        MUAssert(2 == librdf_storage_size(storage), "size");
+
+        MUAssert(0 == librdf_storage_transaction_start(storage), "outer start");
+        MUAssert(0 == add(world, storage, "d"), "add failed");
+        MUAssert(0 == librdf_storage_transaction_start(storage), "inner start");
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "inner commit");
+        MUAssert(0 == librdf_storage_transaction_rollback(storage), "outer rollback");
+        MUAssert(2 == librdf_storage_size(storage), "outer rollback must drop all");
+
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_batches()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    char *msg = NULL;
+    if( !msg )
+        msg = add_batched(world, "new='no', synchronous='off'", 1, 0);
+    if( !msg )
+        msg = add_batched(world, "new='no', synchronous='off', batch_size='3'", 1, 0);
+    if( !msg )
+        msg = add_batched(world, "new='no', synchronous='off', batch_size='3', batch_policy='retry'", 1, 0);
+    if( !msg )
+        msg = add_batched(world, "new='no', synchronous='off', batch_size='3', batch_policy='skip'", 0, 9);
+    if( !msg )
+        msg = add_batched(world, "new='no', synchronous='off', batch_size='1', batch_policy='skip'", 0, 11);
+    librdf_free_world(world);
+    if( msg )
+        return msg;
+
+    world = librdf_new_world();
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction.sqlite", "new='yes', batch_policy='never'");
+    MUAssert(!storage, "must refuse unknown batch_policy");
+    storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-transaction.sqlite", "new='yes', batch_size='-1'");
+    MUAssert(!storage, "must refuse negative batch_size");
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_nested);
+    MUTestRun(test_batches);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,158 @@
+//
+// test-tuning.c
+//
+// Copyright (c) 2015-2018, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+#include "mtest.h"
+#include <unistd.h>
+#include <string.h>
+
+int tests_run = 0;
+
+static int get_feature_string(librdf_storage *storage, const unsigned char *feature, char *buf, const size_t siz)
+{
+    librdf_uri *uri_f = librdf_new_uri(librdf_storage_get_world(storage), feature);
+    librdf_node *node = librdf_storage_get_feature(storage, uri_f);
+    librdf_free_uri(uri_f);
+    if( !node )
+        return 1;
+    strncpy(buf, (const char *)librdf_node_get_literal_value(node), siz - 1);
+    buf[siz - 1] = '\0';
+    librdf_free_node(node);
+    return 0;
+}
+
+
+static int set_feature_string(librdf_storage *storage, const unsigned char *feature, const char *value)
+{
+    librdf_world *world = librdf_storage_get_world(storage);
+    librdf_uri *uri_f = librdf_new_uri(world, feature);
+    librdf_node *node = librdf_new_node_from_typed_literal(world, (const unsigned char *)value, NULL, NULL);
+    const int ret = librdf_storage_set_feature(storage, uri_f, node);
+    librdf_free_node(node);
+    librdf_free_uri(uri_f);
+    return ret;
+}
+
+
+static char *test_tuning_option()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-tuning.sqlite",
+                                                     "new='yes', synchronous='off', tuning='read-mostly', cache_size='-4096'");
+        MUAssert(storage, "Failed to create storage");
+        {
+            char buf[40];
+            MUAssert(0 == get_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, buf, sizeof(buf)), "not set");
+            MUAssert(0 == strcmp("read-mostly", buf), "wrong tuning");
+            MUAssert(0 == get_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_JOURNAL_MODE, buf, sizeof(buf)), "not set");
+            MUAssert(0 == strcmp("wal", buf), "wrong journal_mode");
+            int value = 0;
+            MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE, &value), "not set");
+            MUAssert(-4096 == value, "override ignored");
+            MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_TEMP_STORE, &value), "not set");
+            MUAssert(2 == value, "wrong temp_store");
+        }
+        librdf_free_storage(storage);
+    }
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-tuning.sqlite",
+                                                     "new='yes', tuning='no-such-profile'");
+        MUAssert(NULL == storage, "unknown tuning must fail");
+        storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-tuning.sqlite",
+                                     "new='yes', journal_mode='wal; DROP TABLE so_uris'");
+        MUAssert(NULL == storage, "invalid journal_mode must fail");
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *test_tuning_switch()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/test-tuning.sqlite",
+                                                     "new='yes', synchronous='off', tuning='bulk-load'");
+        MUAssert(storage, "Failed to create storage");
+        {
+            char buf[40];
+            int value = 0;
+            MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_PAGE_SIZE, &value), "not set");
+            MUAssert(8192 == value, "wrong page_size");
+            MUAssert(0 == get_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_LOCKING_MODE, buf, sizeof(buf)), "not set");
+            MUAssert(0 == strcmp("exclusive", buf), "wrong locking_mode");
+
+            MUAssert(0 == set_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, "low-memory"), "switch failed");
+            MUAssert(0 == get_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_LOCKING_MODE, buf, sizeof(buf)), "not set");
+            MUAssert(0 == strcmp("normal", buf), "wrong locking_mode");
+            MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE, &value), "not set");
+            MUAssert(-512 == value, "wrong cache_size");
+
+            MUAssert(0 == librdf_storage_set_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE, 1000), "set failed");
+            MUAssert(0 == librdf_storage_get_feature_mro_int(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_CACHE_SIZE, &value), "not set");
+            MUAssert(1000 == value, "wrong cache_size");
+            MUAssert(0 != set_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_PRAGMA_TEMP_STORE, "ram"), "invalid value accepted");
+            MUAssert(0 != set_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, "turbo"), "invalid value accepted");
+
+            MUAssert(0 == librdf_storage_transaction_start(storage), "txn");
+            MUAssert(0 != set_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, "default"), "switched within transaction");
+            MUAssert(0 == librdf_storage_transaction_rollback(storage), "txn");
+            MUAssert(0 == get_feature_string(storage, LIBRDF_STORAGE_SQLITE_MRO_FEATURE_TUNING, buf, sizeof(buf)), "not set");
+            MUAssert(0 == strcmp("low-memory", buf), "wrong tuning");
+        }
+        librdf_free_storage(storage);
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_tuning_option);
+    MUTestRun(test_tuning_switch);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
@@ -0,0 +1,131 @@
+//
+// test-warmup.c
+// Copyright (c) 2015-2026, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+#define LIBRDF_STORAGE_SQLITE_MRO_CONVENIENCE 1
+#include "../rdf_storage_sqlite_mro.h"
+
+
+#include "mtest.h"
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+
+int tests_run = 0;
+
+#define FILE_NAME "tmp/test-warmup.sqlite"
+
+
+typedef struct
+{
+    int calls;
+    long long bytes;
+    int rc;
+}
+done_t;
+
+
+static void on_done(void *user_data, const long long bytes, const int rc)
+{
+    done_t *d = (done_t *)user_data;
+    d->calls++;
+    d->bytes = bytes;
+    d->rc = rc;
+}
+
+
+static char *test_warm_up()
+{
+    librdf_world *world = librdf_new_world();
+    MUAssert(world, "Failed to create world");
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+    {
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "new='yes', synchronous='off'");
+        MUAssert(storage, "Failed to create storage");
+        MUAssert(0 == librdf_storage_transaction_start(storage), "begin");
+        for( int i = 0; i < 2000; i++ ) {
+            char s[64];
+            char o[64];
+            snprintf(s, sizeof(s), "http://example.com/s%d", i % 100);
+            snprintf(o, sizeof(o), "literal %d", i);
+            librdf_statement *stmt = librdf_new_statement_from_nodes(
+                world,
+                librdf_new_node_from_uri_string(world, (const unsigned char *)s),
+                librdf_new_node_from_uri_string(world, (const unsigned char *)"http://example.com/p"),
+                librdf_new_node_from_literal(world, (const unsigned char *)o, NULL, 0)
+                );
+            MUAssert(0 == librdf_storage_add_statement(storage, stmt), "add failed");
+            librdf_free_statement(stmt);
+        }
+        MUAssert(0 == librdf_storage_transaction_commit(storage), "commit");
+        librdf_free_storage(storage);
+    }
+    {
+        // at open, in the background, queries are served meanwhile
+        librdf_storage *storage = librdf_new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, FILE_NAME, "new='no', warm_up='100000000', warm_up_background='yes', warm_up_madvise='yes'");
+        MUAssert(storage, "Failed to open storage");
+        MUAssert(2000 == librdf_storage_size(storage), "size during warm-up");
+        long long bytes = -1;
+        MUAssert(0 == librdf_storage_sqlite_mro_warm_up_wait(storage, &bytes), "background warm-up");
+        MUAssert(0 < bytes, "bytes read");
+        const long long all = bytes;
+        MUAssert(0 == librdf_storage_sqlite_mro_warm_up_wait(storage, &bytes), "nothing running");
+        MUAssert(0 == bytes, "nothing read");
+
+        // synchronous, within a budget
+        done_t done = { 0, -1, -1 };
+        MUAssert(0 == librdf_storage_sqlite_mro_warm_up(storage, 8192, 0, &on_done, &done), "budget");
+        MUAssert(1 == done.calls, "done called");
+        MUAssert(0 == done.rc, "done rc");
+        MUAssert(8192 <= done.bytes && done.bytes < all, "budget kept");
+
+        // closing cuts a background warm-up short
+        MUAssert(0 == librdf_storage_sqlite_mro_warm_up(storage, 0, LIBRDF_STORAGE_SQLITE_MRO_WARM_UP_BACKGROUND, &on_done, &done), "start");
+        librdf_free_storage(storage);
+        MUAssert(2 == done.calls, "done called on close");
+        MUAssert(SQLITE_OK == done.rc || SQLITE_INTERRUPT == done.rc, "finished or interrupted");
+    }
+    librdf_free_world(world);
+    return NULL;
+}
+
+
+static char *all_tests()
+{
+    MUTestRun(test_warm_up);
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    char *result = all_tests();
+    if( result != 0 ) {
+        printf("%s\n", result);
+    } else {
+        printf(ANSI_COLOR_F_GREEN "✓" ANSI_COLOR_RESET " ALL TESTS PASSED\n");
+    }
+    printf("Tests run: %d\n", tests_run);
+
+    return result != 0;
+}
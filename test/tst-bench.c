@@ -0,0 +1,561 @@
+//
+// tst-bench.c
+//
+// Copyright (c) 2015-2015, Marcus Rohrmoser mobile Software, http://mro.name/me
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are permitted
+// provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+// and the following disclaimer.
+//
+// 2. The software must not be used for military or intelligence or related purposes nor
+// anything that's in conflict with human rights as declared in http://www.un.org/en/documents/udhr/ .
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+// IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+// IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Benchmark librdf.sqlite against the stock 'sqlite' storage.
+//
+// $ make bench
+// $ make bench BENCH_FORMAT=json BENCH_SIZES="1000 100000" > bench.json
+//
+// Generates deterministic data in memory and measures load, size, contains, find for
+// each reachable pattern shape, single and context deletes per storage and store size.
+// With -f also loads and visits a file from rdfgen.c, skewed like real data.
+// Writes one CSV line (or JSON object) per measurement to stdout, incl. the SQLite
+// allocations and a plain SQLite 'calibrate' run to compare across machines (see perf-gate.sh).
+//
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sqlite3.h>
+#include "../rdf_storage_sqlite_mro.h"
+
+// same bits as sql_find_param_t in rdf_storage_sqlite_mro.c
+enum {
+    P_S_URI       = 1 << 0,
+    P_S_BLANK     = 1 << 1,
+    P_P_URI       = 1 << 2,
+    P_O_URI       = 1 << 3,
+    P_O_BLANK     = 1 << 4,
+    P_O_TEXT      = 1 << 5,
+    P_O_LANGUAGE  = 1 << 6,
+    P_O_DATATYPE  = 1 << 7,
+    P_C_URI       = 1 << 8
+};
+
+#define FIND_QUERIES 100 // per shape with bound subject or object
+#define SCAN_QUERIES 3 // per shape without, those return large parts of the store
+#define CONTAINS_QUERIES 1000
+#define DELETE_QUERIES 1000
+#define SIZE_QUERIES 100
+
+static bool json = false;
+static bool only_mro = false;
+static int records = 0;
+static uint64_t mallocs = 0; // SQLite xMalloc + xRealloc calls
+static uint64_t mallocs_mark = 0; // at the previous report
+
+
+#pragma mark Data
+
+
+static inline uint64_t mix(uint64_t x, const uint64_t salt)
+{
+    // splitmix64
+    x += salt * 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30) ) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27) ) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+
+typedef enum {
+    O_URI, O_BLANK, O_PLAIN, O_LANG, O_TYPED
+} object_kind_t;
+
+static inline uint64_t subject_id(const size_t i, const size_t n)
+{
+    return mix(i, 1) % (n / 8 + 1);
+}
+
+
+static inline bool subject_is_blank(const size_t i, const size_t n)
+{
+    return 0 == subject_id(i, n) % 10;
+}
+
+
+static inline object_kind_t object_kind(const size_t i)
+{
+    static const object_kind_t kinds[10] = { O_URI, O_URI, O_URI, O_BLANK, O_PLAIN, O_PLAIN, O_LANG, O_LANG, O_TYPED, O_TYPED };
+    return kinds[mix(i, 3) % 10];
+}
+
+
+static inline unsigned int context_id(const size_t i)
+{
+    return (unsigned int)(mix(i, 5) % 9);
+}
+
+
+/** NULL (default graph) for context_id 0. */
+static librdf_node *new_context(librdf_world *world, const unsigned int cid)
+{
+    char buf[64];
+    if( 0 == cid )
+        return NULL;
+    snprintf(buf, sizeof(buf), "http://example.com/g/%u", cid);
+    return librdf_new_node_from_uri_string(world, (const unsigned char *)buf);
+}
+
+
+/** Statement #i of n, deterministic. */
+static librdf_statement *new_statement(librdf_world *world, const size_t i, const size_t n)
+{
+    char buf[128];
+    librdf_node *s, *p, *o;
+    const unsigned long long sid = subject_id(i, n);
+    if( subject_is_blank(i, n) ) {
+        snprintf(buf, sizeof(buf), "b%llu", sid);
+        s = librdf_new_node_from_blank_identifier(world, (const unsigned char *)buf);
+    } else {
+        snprintf(buf, sizeof(buf), "http://example.com/s/%llu", sid);
+        s = librdf_new_node_from_uri_string(world, (const unsigned char *)buf);
+    }
+    snprintf(buf, sizeof(buf), "http://example.com/p/%u", (unsigned)(mix(i, 2) % 32) );
+    p = librdf_new_node_from_uri_string(world, (const unsigned char *)buf);
+    const unsigned long long oid = mix(i, 4) % (n / 4 + 1);
+    switch( object_kind(i) ) {
+    case O_URI:
+        snprintf(buf, sizeof(buf), "http://example.com/o/%llu", oid);
+        o = librdf_new_node_from_uri_string(world, (const unsigned char *)buf);
+        break;
+    case O_BLANK:
+        snprintf(buf, sizeof(buf), "o%llu", oid);
+        o = librdf_new_node_from_blank_identifier(world, (const unsigned char *)buf);
+        break;
+    case O_PLAIN:
+        snprintf(buf, sizeof(buf), "Literal number %llu", oid);
+        o = librdf_new_node_from_literal(world, (const unsigned char *)buf, NULL, 0);
+        break;
+    case O_LANG:
+        snprintf(buf, sizeof(buf), "Wort Nummer %llu", oid);
+        o = librdf_new_node_from_literal(world, (const unsigned char *)buf, 0 == oid % 2 ? "de" : "en", 0);
+        break;
+    default: {
+        librdf_uri *dt = librdf_new_uri(world, (const unsigned char *)"http://www.w3.org/2001/XMLSchema#integer");
+        snprintf(buf, sizeof(buf), "%llu", oid);
+        o = librdf_new_node_from_typed_literal(world, (const unsigned char *)buf, NULL, dt);
+        librdf_free_uri(dt);
+    }
+    }
+    return librdf_new_statement_from_nodes(world, s, p, o);
+}
+
+
+/** Shape of statement #i if all positions were bound. */
+static unsigned int full_shape(const size_t i, const size_t n)
+{
+    static const unsigned int o_bits[] = {
+        [O_URI] = P_O_URI,
+        [O_BLANK] = P_O_BLANK,
+        [O_PLAIN] = P_O_TEXT,
+        [O_LANG] = P_O_TEXT | P_O_LANGUAGE,
+        [O_TYPED] = P_O_TEXT | P_O_DATATYPE
+    };
+    return (subject_is_blank(i, n) ? P_S_BLANK : P_S_URI) | P_P_URI | o_bits[object_kind(i)] | (0 == context_id(i) ? 0 : P_C_URI);
+}
+
+
+#pragma mark Measure
+
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+
+static sqlite3_mem_methods mem_default;
+
+static void *count_malloc(int n)
+{
+    mallocs++;
+    return mem_default.xMalloc(n);
+}
+
+
+static void *count_realloc(void *p, int n)
+{
+    mallocs++;
+    return mem_default.xRealloc(p, n);
+}
+
+
+/** Count SQLite's allocations, must precede any other SQLite call. */
+static void count_mallocs(void)
+{
+    sqlite3_mem_methods m;
+    if( SQLITE_OK != sqlite3_config(SQLITE_CONFIG_GETMALLOC, &mem_default) )
+        return;
+    m = mem_default;
+    m.xMalloc = count_malloc;
+    m.xRealloc = count_realloc;
+    sqlite3_config(SQLITE_CONFIG_MALLOC, &m);
+}
+
+
+/** mallocs are those since the previous report (or mark). */
+static void report(const char *storage, const size_t size, const char *op, const int shape, const size_t count, const uint64_t ns, const long long rows)
+{
+    const double per_op = count ? (double)ns / (double)count : 0.0;
+    const unsigned long long m = mallocs - mallocs_mark;
+    if( json )
+        printf("%s\n  {\"storage\":\"%s\",\"size\":%zu,\"op\":\"%s\",\"shape\":%d,\"count\":%zu,\"total_ns\":%llu,\"ns_per_op\":%.1f,\"rows\":%lld,\"mallocs\":%llu}",
+               records ? "," : "", storage, size, op, shape, count, (unsigned long long)ns, per_op, rows, m);
+    else
+        printf("%s,%zu,%s,%d,%zu,%llu,%.1f,%lld,%llu\n", storage, size, op, shape, count, (unsigned long long)ns, per_op, rows, m);
+    records++;
+    fflush(stdout);
+    mallocs_mark = mallocs;
+}
+
+
+static librdf_storage *new_storage(librdf_world *world, const char *factory, const char *path)
+{
+    unlink(path);
+    // stock sqlite only finds in contexts if told so
+    return librdf_new_storage(world, factory, path, "new='yes', synchronous='off', contexts='yes'");
+}
+
+
+static long long drain(librdf_stream *stream)
+{
+    long long rows = 0;
+    if( !stream )
+        return -1;
+    for( ; !librdf_stream_end(stream); librdf_stream_next(stream) )
+        if( librdf_stream_get_object(stream) )
+            rows++;
+    librdf_free_stream(stream);
+    return rows;
+}
+
+
+static void bench_load(librdf_world *world, librdf_storage *storage, const char *name, librdf_statement **stmts, librdf_node **ctxs, const size_t n)
+{
+    const uint64_t t0 = now_ns();
+    librdf_storage_transaction_start(storage);
+    for( size_t i = 0; i < n; i++ )
+        librdf_storage_context_add_statement(storage, ctxs[i], stmts[i]);
+    librdf_storage_transaction_commit(storage);
+    report(name, n, "load", -1, n, now_ns() - t0, librdf_storage_size(storage) );
+}
+
+
+static void bench_size(librdf_storage *storage, const char *name, const size_t n)
+{
+    long long rows = 0;
+    const uint64_t t0 = now_ns();
+    for( int q = 0; q < SIZE_QUERIES; q++ )
+        rows = librdf_storage_size(storage);
+    report(name, n, "size", -1, SIZE_QUERIES, now_ns() - t0, rows);
+}
+
+
+/** contains_statement only looks into the default graph, so do half hits from there, half misses. */
+static void bench_contains(librdf_storage *storage, const char *name, librdf_statement **stmts, const size_t n)
+{
+    size_t count = 0;
+    long long rows = 0;
+    uint64_t ns = 0;
+    for( size_t i = 0; i < n && count < CONTAINS_QUERIES; i++ ) {
+        if( (0 == context_id(i) ) != (0 == count % 2) )
+            continue;
+        const uint64_t t0 = now_ns();
+        rows += 0 != librdf_storage_contains_statement(storage, stmts[i]);
+        ns += now_ns() - t0;
+        count++;
+    }
+    report(name, n, "contains", -1, count, ns, rows);
+}
+
+
+/** Bind only the positions in shape, taken from a statement having the same kinds of nodes. */
+static void bench_find_shape(librdf_world *world, librdf_storage *storage, const char *name, librdf_statement **stmts, librdf_node **ctxs, const size_t n, const unsigned int shape)
+{
+    const unsigned int s_bits = P_S_URI | P_S_BLANK;
+    const unsigned int o_bits = P_O_URI | P_O_BLANK | P_O_TEXT | P_O_LANGUAGE | P_O_DATATYPE;
+    const size_t queries = shape & (s_bits | o_bits) ? FIND_QUERIES : SCAN_QUERIES;
+    size_t count = 0;
+    long long rows = 0;
+    uint64_t ns = 0;
+    for( size_t i = 0; i < n && count < queries; i++ ) {
+        const unsigned int full = full_shape(i, n);
+        if( (shape & s_bits) && (shape & s_bits) != (full & s_bits) )
+            continue;
+        if( (shape & o_bits) && (shape & o_bits) != (full & o_bits) )
+            continue;
+        if( (shape & P_C_URI) && !(full & P_C_URI) )
+            continue;
+        librdf_statement *pattern = librdf_new_statement(world);
+        if( shape & s_bits )
+            librdf_statement_set_subject(pattern, librdf_new_node_from_node(librdf_statement_get_subject(stmts[i]) ) );
+        if( shape & P_P_URI )
+            librdf_statement_set_predicate(pattern, librdf_new_node_from_node(librdf_statement_get_predicate(stmts[i]) ) );
+        if( shape & o_bits )
+            librdf_statement_set_object(pattern, librdf_new_node_from_node(librdf_statement_get_object(stmts[i]) ) );
+        const uint64_t t0 = now_ns();
+        if( shape & P_C_URI )
+            rows += drain(librdf_storage_find_statements_in_context(storage, pattern, ctxs[i]) );
+        else
+            rows += drain(librdf_storage_find_statements(storage, pattern) );
+        ns += now_ns() - t0;
+        librdf_free_statement(pattern);
+        count++;
+    }
+    report(name, n, "find", (int)shape, count, ns, rows);
+}
+
+
+/** Every shape a librdf_statement pattern can produce: subject, predicate, object kind, context each bound or not. */
+static void bench_find(librdf_world *world, librdf_storage *storage, const char *name, librdf_statement **stmts, librdf_node **ctxs, const size_t n)
+{
+    const unsigned int s_shapes[] = { 0, P_S_URI, P_S_BLANK };
+    const unsigned int p_shapes[] = { 0, P_P_URI };
+    const unsigned int o_shapes[] = { 0, P_O_URI, P_O_BLANK, P_O_TEXT, P_O_TEXT | P_O_LANGUAGE, P_O_TEXT | P_O_DATATYPE };
+    const unsigned int c_shapes[] = { 0, P_C_URI };
+    for( size_t c = 0; c < sizeof(c_shapes) / sizeof(c_shapes[0]); c++ )
+        for( size_t s = 0; s < sizeof(s_shapes) / sizeof(s_shapes[0]); s++ )
+            for( size_t p = 0; p < sizeof(p_shapes) / sizeof(p_shapes[0]); p++ )
+                for( size_t o = 0; o < sizeof(o_shapes) / sizeof(o_shapes[0]); o++ )
+                    bench_find_shape(world, storage, name, stmts, ctxs, n, s_shapes[s] | p_shapes[p] | o_shapes[o] | c_shapes[c]);
+}
+
+
+static void bench_delete(librdf_world *world, librdf_storage *storage, const char *name, librdf_statement **stmts, librdf_node **ctxs, const size_t n)
+{
+    const size_t queries = DELETE_QUERIES < n / 2 ? DELETE_QUERIES : n / 2;
+    const int before = librdf_storage_size(storage);
+    uint64_t t0 = now_ns();
+    librdf_storage_transaction_start(storage);
+    for( size_t q = 0; q < queries; q++ )
+        librdf_storage_context_remove_statement(storage, ctxs[q], stmts[q]);
+    librdf_storage_transaction_commit(storage);
+    const int middle = librdf_storage_size(storage);
+    report(name, n, "delete", -1, queries, now_ns() - t0, before - middle);
+
+    librdf_node *context = new_context(world, 1);
+    t0 = now_ns();
+    librdf_storage_context_remove_statements(storage, context);
+    report(name, n, "delete_context", -1, 1, now_ns() - t0, middle - librdf_storage_size(storage) );
+    librdf_free_node(context);
+}
+
+
+static int count_row(void *user_data, const librdf_storage_sqlite_mro_row *row)
+{
+    (*(long long *)user_data)++;
+    return 0;
+}
+
+
+/** librdf.sqlite only: direct export, load_file and visit, no librdf_statement in between. */
+static void bench_file(librdf_world *world, librdf_storage *storage, const char *name, const size_t n)
+{
+    const char path[] = "tmp/bench.nq";
+    FILE *out = fopen(path, "w");
+    if( !out )
+        return;
+    uint64_t t0 = now_ns();
+    librdf_storage_sqlite_mro_export(storage, NULL, out, LIBRDF_STORAGE_SQLITE_MRO_EXPORT_NQUADS);
+    fclose(out);
+    report(name, n, "export", -1, 1, now_ns() - t0, librdf_storage_size(storage) );
+
+    long long rows = 0;
+    t0 = now_ns();
+    librdf_storage_sqlite_mro_for_each_match(storage, NULL, NULL, &count_row, &rows);
+    report(name, n, "visit", 0, 1, now_ns() - t0, rows);
+
+    librdf_storage *other = new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, "tmp/bench-load.sqlite");
+    if( other ) {
+        t0 = now_ns();
+        librdf_storage_sqlite_mro_load_file(other, path, "nquads");
+        report(name, n, "load_file", -1, 1, now_ns() - t0, librdf_storage_size(other) );
+        librdf_free_storage(other);
+    }
+    unlink("tmp/bench-load.sqlite");
+    unlink(path);
+}
+
+
+/** librdf.sqlite only: load_file and visit skewed data from rdfgen, e.g. $ build/rdfgen -n 20000 -g 8 > tmp/gen.nq */
+static void bench_generated(librdf_world *world, const char *name, const char *path)
+{
+    const char db[] = "tmp/bench-gen.sqlite";
+    unlink(db);
+    librdf_storage *storage = new_storage(world, LIBRDF_STORAGE_SQLITE_MRO, db);
+    if( !storage )
+        return;
+    mallocs_mark = mallocs; // not opening the storage
+    uint64_t t0 = now_ns();
+    const int rc = librdf_storage_sqlite_mro_load_file(storage, path, "nquads");
+    const size_t n = (size_t)librdf_storage_size(storage);
+    if( 0 == rc ) {
+        report(name, n, "load_gen", -1, 1, now_ns() - t0, n);
+
+        long long rows = 0;
+        t0 = now_ns();
+        librdf_storage_sqlite_mro_for_each_match(storage, NULL, NULL, &count_row, &rows);
+        report(name, n, "visit_gen", 0, 1, now_ns() - t0, rows);
+    } else
+        fprintf(stderr, "skipped, cannot load '%s'\n", path);
+    librdf_free_storage(storage);
+    unlink(db);
+}
+
+
+/** Plain SQLite inserts and primary key lookups, the yardstick for the machine. */
+static void calibrate(const size_t n)
+{
+    const char path[] = "tmp/bench-calibrate.sqlite";
+    unlink(path);
+    sqlite3 *db = NULL;
+    if( SQLITE_OK != sqlite3_open(path, &db) ) {
+        sqlite3_close(db);
+        return;
+    }
+    sqlite3_exec(db, "PRAGMA synchronous=OFF; CREATE TABLE t (id INTEGER PRIMARY KEY, v TEXT NOT NULL)", NULL, NULL, NULL);
+    sqlite3_stmt *ins = NULL;
+    sqlite3_stmt *sel = NULL;
+    sqlite3_prepare_v2(db, "INSERT INTO t (id, v) VALUES (?, ?)", -1, &ins, NULL);
+    sqlite3_prepare_v2(db, "SELECT v FROM t WHERE id = ?", -1, &sel, NULL);
+    long long rows = 0;
+    mallocs_mark = mallocs;
+    const uint64_t t0 = now_ns();
+    sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+    for( size_t i = 0; i < n; i++ ) {
+        char buf[40];
+        const int len = snprintf(buf, sizeof(buf), "http://example.com/s/%llu", (unsigned long long)mix(i, 1) );
+        sqlite3_bind_int64(ins, 1, (sqlite3_int64)mix(i, 0) );
+        sqlite3_bind_text(ins, 2, buf, len, SQLITE_STATIC);
+        sqlite3_step(ins);
+        sqlite3_reset(ins);
+    }
+    sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+    for( size_t i = 0; i < n; i++ ) {
+        sqlite3_bind_int64(sel, 1, (sqlite3_int64)mix(i, 0) );
+        rows += SQLITE_ROW == sqlite3_step(sel);
+        sqlite3_reset(sel);
+    }
+    report("sqlite3", n, "calibrate", -1, 2 * n, now_ns() - t0, rows);
+    sqlite3_finalize(ins);
+    sqlite3_finalize(sel);
+    sqlite3_close(db);
+    unlink(path);
+}
+
+
+static void bench(librdf_world *world, const char *name, const char *factory, const size_t n)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "tmp/bench-%s-%zu.sqlite", name, n);
+    librdf_storage *storage = new_storage(world, factory, path);
+    if( !storage ) {
+        fprintf(stderr, "skipped, no storage '%s'\n", factory);
+        return;
+    }
+    librdf_statement **stmts = calloc(n, sizeof(*stmts) );
+    librdf_node **ctxs = calloc(n, sizeof(*ctxs) );
+    for( size_t i = 0; i < n; i++ ) {
+        stmts[i] = new_statement(world, i, n);
+        ctxs[i] = new_context(world, context_id(i) );
+    }
+    mallocs_mark = mallocs; // not opening the storage
+
+    bench_load(world, storage, name, stmts, ctxs, n);
+    bench_size(storage, name, n);
+    bench_contains(storage, name, stmts, n);
+    bench_find(world, storage, name, stmts, ctxs, n);
+    if( 0 == strcmp(LIBRDF_STORAGE_SQLITE_MRO, factory) )
+        bench_file(world, storage, name, n);
+    bench_delete(world, storage, name, stmts, ctxs, n);
+
+    for( size_t i = 0; i < n; i++ ) {
+        librdf_free_statement(stmts[i]);
+        if( ctxs[i] )
+            librdf_free_node(ctxs[i]);
+    }
+    free(stmts);
+    free(ctxs);
+    librdf_free_storage(storage);
+    unlink(path);
+}
+
+
+int main(int argc, char *argv[])
+{
+    count_mallocs();
+    int a = 1;
+    if( a < argc && ( 0 == strcmp("csv", argv[a]) || 0 == strcmp("json", argv[a]) ) )
+        json = 0 == strcmp("json", argv[a++]);
+    if( a < argc && 0 == strcmp("mro", argv[a]) )
+        only_mro = 0 == strcmp("mro", argv[a++]);
+    const char *generated = NULL;
+    if( a + 1 < argc && 0 == strcmp("-f", argv[a]) ) {
+        generated = argv[a + 1];
+        a += 2;
+    }
+    size_t sizes[16] = { 1000, 10000, 100000 };
+    int size_count = 3;
+    if( a < argc ) {
+        for( size_count = 0; a < argc && size_count < 16; a++ ) {
+            const long long n = atoll(argv[a]);
+            if( n < 2 ) {
+                fprintf(stderr, "usage: %s [csv|json] [mro] [-f rdfgen.nq] [size ...]\n", argv[0]);
+                return 1;
+            }
+            sizes[size_count++] = (size_t)n;
+        }
+    }
+
+    librdf_world *world = librdf_new_world();
+    librdf_world_open(world);
+    librdf_init_storage_sqlite_mro(world);
+
+    if( json )
+        printf("[");
+    else
+        printf("storage,size,op,shape,count,total_ns,ns_per_op,rows,mallocs\n");
+    for( int s = 0; s < size_count; s++ ) {
+        calibrate(sizes[s]);
+        bench(world, "mro", LIBRDF_STORAGE_SQLITE_MRO, sizes[s]);
+        if( !only_mro )
+            bench(world, "sqlite", "sqlite", sizes[s]);
+    }
+    if( generated )
+        bench_generated(world, "mro", generated);
+    if( json )
+        printf("\n]\n");
+
+    librdf_free_world(world);
+    return 0;
+}
@@ -23,6 +23,7 @@
 // real 15m2.400s
 // user 14m19.086s
 // sys  0m42.351s
+// $ echo "direct" ; time ./a.out "file://$(pwd)/loader.ttl" "http://purl.mro.name/rdf/sqlite/" direct
 //
 
 // based on https://gist.github.com/abargnesi/8402baf1a019a2179e70
@@ -48,8 +49,8 @@ int main(int argc, char *argv[])
     char *parser_name  = NULL;
     char *storage_name = NULL;
 
-    if( argc != 3 ) {
-        fprintf(stderr, "usage: %s <rdf content URI> <name>\n", argv[0]);
+    if( argc != 3 && !( argc == 4 && 0 == strcmp("direct", argv[3]) ) ) {
+        fprintf(stderr, "usage: %s <rdf content URI> <name> [direct]\n", argv[0]);
         return(1);
     }
 
@@ -106,6 +107,16 @@ int main(int argc, char *argv[])
         librdf_free_uri(f_uri);
     }
 
+    if( argc == 4 ) {
+        // librdf.sqlite only: parse straight into the storage, no librdf_statement in between
+        const char *path = 0 == strncmp("file://", argv[1], 7) ? argv[1] + 7 : argv[1];
+        const int ret = librdf_storage_sqlite_mro_load_file(storage, path, parser_name);
+        librdf_free_storage(storage);
+        librdf_free_uri(uri);
+        librdf_free_world(world);
+        return ret;
+    }
+
     // create model
     model = librdf_new_model(world, storage, NULL);
 